@@ -2,7 +2,13 @@
  * ESP32-P4 -> ESP32-C6 OTA Flasher
  *
  * Pushes embedded esp-hosted slave firmware to the C6 over SDIO.
- * The binary is embedded at build time via EMBED_FILES.
+ * The image is embedded LZFW-compressed at build time via EMBED_FILES
+ * (pack it with tools/lzfw_pack.c) and decompressed on the P4 while it
+ * is sent, so the stock slave receives the plain image.
+ *
+ * The transfer, image hashing and the installed-image record come from
+ * the shared slave_ota component (../components), so running the
+ * flasher again with the same image skips the OTA.
  */
 
 #include <string.h>
@@ -11,16 +17,16 @@
 #include "esp_system.h"
 #include "esp_event.h"
 #include "esp_log.h"
-#include "esp_timer.h"
 #include "nvs_flash.h"
 #include "esp_hosted_ota.h"
 #include "esp_hosted.h"
+#include "slave_ota.h"
 
 static const char *TAG = "c6_ota";
 
-/* Embedded slave firmware (linked by EMBED_FILES) */
-extern const uint8_t slave_fw_start[] asm("_binary_network_adapter_bin_start");
-extern const uint8_t slave_fw_end[]   asm("_binary_network_adapter_bin_end");
+/* Embedded compressed slave firmware (linked by EMBED_FILES) */
+extern const uint8_t slave_fw_start[] asm("_binary_network_adapter_lzfw_start");
+extern const uint8_t slave_fw_end[]   asm("_binary_network_adapter_lzfw_end");
 
 void app_main(void)
 {
@@ -64,54 +70,42 @@ void app_main(void)
 
     /* Firmware size */
     size_t fw_size = slave_fw_end - slave_fw_start;
-    ESP_LOGI(TAG, "Embedded slave firmware: %zu bytes (%.1f KB)", fw_size, fw_size / 1024.0f);
-
-    /* OTA begin */
-    ESP_LOGI(TAG, "Starting OTA...");
-    ret = esp_hosted_slave_ota_begin();
+    ESP_LOGI(TAG, "Embedded slave firmware: %zu bytes (%.1f KB) compressed",
+             fw_size, fw_size / 1024.0f);
+
+    /* Decoded in the reader task into the chunk ring; the header carries
+     * the image's appended digest, matching esp_partition_get_sha256()
+     * on the slave */
+    slave_ota_src_t src = {0};
+    ret = slave_ota_src_lzfw(&src, slave_fw_start, fw_size);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "OTA begin failed: %s (0x%x)", esp_err_to_name(ret), ret);
-        ESP_LOGE(TAG, "The C6 slave may not support OTA. Try UART flashing.");
+        ESP_LOGE(TAG, "Embedded image unusable: %s", esp_err_to_name(ret));
         goto done;
     }
-    ESP_LOGI(TAG, "OTA begin OK");
-
-    /* Write firmware in chunks */
-    const size_t chunk_size = 1400;
-    size_t offset = 0;
-    size_t total = fw_size;
-    int last_pct = -1;
-
-    while (offset < total) {
-        size_t len = (total - offset > chunk_size) ? chunk_size : (total - offset);
-        ret = esp_hosted_slave_ota_write((uint8_t *)(slave_fw_start + offset), len);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "OTA write failed at offset %zu: %s", offset, esp_err_to_name(ret));
-            goto done;
-        }
-        offset += len;
-
-        int pct = (int)(offset * 100 / total);
-        if (pct / 10 > last_pct / 10) {
-            ESP_LOGI(TAG, "OTA progress: %d%% (%zu / %zu bytes)", pct, offset, total);
-            last_pct = pct;
-        }
+    uint8_t sha256[32];
+    bool have_sha = slave_ota_image_sha256(&src, sha256) == ESP_OK;
+    if (have_sha && slave_ota_is_installed(sha256)) {
+        ESP_LOGI(TAG, "C6 already runs this image, skipping OTA");
+        goto done;
     }
 
-    ESP_LOGI(TAG, "OTA write complete, finalizing...");
-
-    /* OTA end */
-    ret = esp_hosted_slave_ota_end();
+    /* OTA begin, chunked writes, end */
+    ESP_LOGI(TAG, "Starting OTA...");
+    slave_ota_stats_t stats;
+    ret = slave_ota_transfer(&src, NULL, &stats);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "OTA end failed: %s (0x%x)", esp_err_to_name(ret), ret);
+        ESP_LOGE(TAG, "OTA failed: %s (0x%x)", esp_err_to_name(ret), ret);
+        ESP_LOGE(TAG, "The C6 slave may not support OTA. Try UART flashing.");
         goto done;
     }
-    ESP_LOGI(TAG, "OTA end OK - firmware validated");
+    ESP_LOGI(TAG, "OTA end OK - firmware validated (%zu bytes in %.1f s)",
+             stats.bytes_sent, stats.elapsed_us / 1000000.0f);
 
     /* Activate new firmware */
     ESP_LOGI(TAG, "Activating new firmware (C6 will reboot)...");
-    ret = esp_hosted_slave_ota_activate();
-    if (ret != ESP_OK) {
+    ret = slave_ota_activate(&stats);
+    bool activated = ret == ESP_OK;
+    if (!activated) {
         ESP_LOGE(TAG, "OTA activate failed: %s (0x%x)", esp_err_to_name(ret), ret);
         ESP_LOGW(TAG, "Older slave FW may not need activate - trying reboot...");
     } else {
@@ -125,6 +119,14 @@ void app_main(void)
     /* Verify new version */
     memset(&ver, 0, sizeof(ver));
     ver_ret = esp_hosted_get_coprocessor_fwversion(&ver);
+
+    /* Record the image only once the slave is known to run it, so a
+     * failed activation or a slave that did not come back is retried on
+     * the next run instead of skipped */
+    if (have_sha && activated && ver_ret == 0) {
+        slave_ota_mark_installed(sha256);
+    }
+
     if (ver_ret == 0) {
         ESP_LOGI(TAG, "");
         ESP_LOGI(TAG, "╔═══════════════════════════════════════╗");
@@ -140,6 +142,7 @@ void app_main(void)
     }
 
 done:
+    slave_ota_src_close(&src);
     ESP_LOGI(TAG, "OTA flasher done. You can now flash the WiFi test firmware.");
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
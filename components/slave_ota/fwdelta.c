@@ -0,0 +1,383 @@
+/*
+ * FW Delta - implementation
+ *
+ * Header layout (little-endian):
+ *   0 magic u32 | 4 version u8 | 5 flags u8 | 6 pad u16
+ *   8 old_len | 12 old_crc32 | 16 new_len | 20 new_crc32 | 24 ops_len
+ *   28 reserved u32 | 32 old_sha256[32] | 64 new_sha256[32]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "lzfw.h"
+#include "fwdelta.h"
+
+#define OP_INSERT       0x01
+#define OP_COPY         0x02
+#define COPY_BUF        256     /* Decoder stack buffer for COPY reads */
+
+/* Encoder tuning */
+#define KEY_LEN         8       /* Bytes hashed to find COPY candidates */
+#define HASH_BITS       20
+#define MAX_CHAIN       64
+#define MIN_COPY        12      /* Shorter matches cost more than inserting */
+
+enum { ST_TAG, ST_ARG1, ST_ARG2, ST_INSERT };
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+fwdelta_err_t fwdelta_parse_header(const uint8_t *buf, fwdelta_header_t *out)
+{
+    if (get_le32(buf) != FWDELTA_MAGIC || buf[4] != FWDELTA_VERSION) {
+        return FWDELTA_ERR_HEADER;
+    }
+    out->version = buf[4];
+    out->flags = buf[5];
+    out->old_len = get_le32(buf + 8);
+    out->old_crc32 = get_le32(buf + 12);
+    out->new_len = get_le32(buf + 16);
+    out->new_crc32 = get_le32(buf + 20);
+    out->ops_len = get_le32(buf + 24);
+    memcpy(out->old_sha256, buf + 32, 32);
+    memcpy(out->new_sha256, buf + 64, 32);
+    return FWDELTA_OK;
+}
+
+/* ─── Decoder ─── */
+
+void fwdelta_decoder_init(fwdelta_decoder_t *d, fwdelta_read_fn read_old, void *old_ctx,
+                          fwdelta_write_fn write, void *ctx)
+{
+    memset(d, 0, sizeof(*d));
+    d->state = ST_TAG;
+    d->read_old = read_old;
+    d->old_ctx = old_ctx;
+    d->write = write;
+    d->ctx = ctx;
+}
+
+static fwdelta_err_t emit(fwdelta_decoder_t *d, const uint8_t *data, size_t len)
+{
+    if (len > d->hdr.new_len - d->out_len) {
+        return FWDELTA_ERR_LENGTH;
+    }
+    d->crc = lzfw_crc32(d->crc, data, len);
+    d->out_len += len;
+    return d->write(d->ctx, data, len) ? FWDELTA_OK : FWDELTA_ERR_IO;
+}
+
+static fwdelta_err_t check_old(fwdelta_decoder_t *d)
+{
+    uint8_t buf[COPY_BUF];
+    uint32_t crc = 0;
+    for (uint32_t off = 0; off < d->hdr.old_len; off += sizeof(buf)) {
+        size_t n = d->hdr.old_len - off;
+        if (n > sizeof(buf)) n = sizeof(buf);
+        if (!d->read_old(d->old_ctx, off, buf, n)) {
+            return FWDELTA_ERR_IO;
+        }
+        crc = lzfw_crc32(crc, buf, n);
+    }
+    return (crc == d->hdr.old_crc32) ? FWDELTA_OK : FWDELTA_ERR_OLD;
+}
+
+static fwdelta_err_t do_copy(fwdelta_decoder_t *d, uint32_t zigzag, uint32_t len)
+{
+    int64_t delta = (zigzag & 1) ? -(int64_t)(zigzag >> 1) - 1 : (int64_t)(zigzag >> 1);
+    int64_t off = (int64_t)d->expected_old + delta;
+    if (off < 0 || off + len > d->hdr.old_len) {
+        return FWDELTA_ERR_CORRUPT;
+    }
+
+    uint8_t buf[COPY_BUF];
+    for (uint32_t done = 0; done < len; ) {
+        size_t n = len - done;
+        if (n > sizeof(buf)) n = sizeof(buf);
+        if (!d->read_old(d->old_ctx, (size_t)off + done, buf, n)) {
+            return FWDELTA_ERR_IO;
+        }
+        fwdelta_err_t err = emit(d, buf, n);
+        if (err != FWDELTA_OK) {
+            return err;
+        }
+        done += n;
+    }
+    d->expected_old = (uint32_t)(off + len);
+    return FWDELTA_OK;
+}
+
+fwdelta_err_t fwdelta_decoder_feed(fwdelta_decoder_t *d, const uint8_t *in, size_t len)
+{
+    fwdelta_err_t err = FWDELTA_OK;
+
+    while (len > 0 && err == FWDELTA_OK) {
+        if (d->hdr_fill < FWDELTA_HEADER_LEN) {
+            size_t n = FWDELTA_HEADER_LEN - d->hdr_fill;
+            if (n > len) n = len;
+            memcpy(d->hdr_buf + d->hdr_fill, in, n);
+            d->hdr_fill += n;
+            in += n;
+            len -= n;
+            if (d->hdr_fill == FWDELTA_HEADER_LEN) {
+                err = fwdelta_parse_header(d->hdr_buf, &d->hdr);
+                if (err == FWDELTA_OK) {
+                    err = check_old(d);
+                }
+            }
+            continue;
+        }
+
+        /* INSERT payload goes straight from input to output */
+        if (d->state == ST_INSERT) {
+            size_t n = (d->remaining < len) ? d->remaining : len;
+            if (n > d->hdr.ops_len - d->consumed) {
+                return FWDELTA_ERR_LENGTH;
+            }
+            err = emit(d, in, n);
+            d->consumed += n;
+            d->expected_old += n;
+            d->remaining -= n;
+            in += n;
+            len -= n;
+            if (d->remaining == 0) {
+                d->state = ST_TAG;
+            }
+            continue;
+        }
+
+        if (d->consumed >= d->hdr.ops_len) {
+            return FWDELTA_ERR_LENGTH;
+        }
+        uint8_t b = *in++;
+        len--;
+        d->consumed++;
+
+        if (d->state == ST_TAG) {
+            if (b != OP_INSERT && b != OP_COPY) {
+                return FWDELTA_ERR_CORRUPT;
+            }
+            d->tag = b;
+            d->state = ST_ARG1;
+            d->vacc = 0;
+            d->vshift = 0;
+            continue;
+        }
+
+        /* ST_ARG1 / ST_ARG2: LEB128 varint */
+        if (d->vshift > 28 || (d->vshift == 28 && (b & 0x70))) {
+            return FWDELTA_ERR_CORRUPT;
+        }
+        d->vacc |= (uint32_t)(b & 0x7F) << d->vshift;
+        if (b & 0x80) {
+            d->vshift += 7;
+            continue;
+        }
+        uint32_t v = d->vacc;
+        d->vacc = 0;
+        d->vshift = 0;
+
+        if (d->state == ST_ARG1 && d->tag == OP_INSERT) {
+            d->remaining = v;
+            d->state = v ? ST_INSERT : ST_TAG;
+        } else if (d->state == ST_ARG1) {
+            d->copy_delta = v;
+            d->state = ST_ARG2;
+        } else {
+            err = do_copy(d, d->copy_delta, v);
+            d->state = ST_TAG;
+        }
+    }
+    return err;
+}
+
+fwdelta_err_t fwdelta_decoder_finish(fwdelta_decoder_t *d)
+{
+    if (d->hdr_fill < FWDELTA_HEADER_LEN) {
+        return FWDELTA_ERR_HEADER;
+    }
+    if (d->state != ST_TAG || d->consumed != d->hdr.ops_len || d->out_len != d->hdr.new_len) {
+        return FWDELTA_ERR_LENGTH;
+    }
+    return (d->crc == d->hdr.new_crc32) ? FWDELTA_OK : FWDELTA_ERR_CRC;
+}
+
+/* ─── Encoder ─── */
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+    bool failed;
+} outbuf_t;
+
+static void out_bytes(outbuf_t *o, const uint8_t *p, size_t n)
+{
+    if (o->failed) return;
+    if (o->len + n > o->cap) {
+        size_t cap = o->cap ? o->cap : 4096;
+        while (cap < o->len + n) cap *= 2;
+        uint8_t *nb = realloc(o->buf, cap);
+        if (!nb) {
+            o->failed = true;
+            return;
+        }
+        o->buf = nb;
+        o->cap = cap;
+    }
+    memcpy(o->buf + o->len, p, n);
+    o->len += n;
+}
+
+static void out_varint(outbuf_t *o, uint32_t v)
+{
+    uint8_t tmp[5];
+    size_t n = 0;
+    do {
+        tmp[n] = (uint8_t)(v & 0x7F);
+        v >>= 7;
+        if (v) tmp[n] |= 0x80;
+        n++;
+    } while (v);
+    out_bytes(o, tmp, n);
+}
+
+static uint32_t key_hash(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return (uint32_t)((v * 0x9E3779B97F4A7C15ull) >> (64 - HASH_BITS));
+}
+
+static size_t common_len(const uint8_t *a, const uint8_t *b, size_t max)
+{
+    size_t n = 0;
+    while (n < max && a[n] == b[n]) n++;
+    return n;
+}
+
+static void flush_insert(outbuf_t *o, const uint8_t *p, size_t n)
+{
+    if (n == 0) return;
+    uint8_t tag = OP_INSERT;
+    out_bytes(o, &tag, 1);
+    out_varint(o, (uint32_t)n);
+    out_bytes(o, p, n);
+}
+
+uint8_t *fwdelta_encode(const uint8_t *old_img, size_t old_len,
+                        const uint8_t *new_img, size_t new_len,
+                        const uint8_t old_sha256[32], const uint8_t new_sha256[32],
+                        size_t *out_len)
+{
+    if (old_len > INT32_MAX || new_len > INT32_MAX) {
+        return NULL;
+    }
+    int32_t *head = malloc(((size_t)1 << HASH_BITS) * sizeof(int32_t));
+    int32_t *prev = malloc((old_len ? old_len : 1) * sizeof(int32_t));
+    if (!head || !prev) {
+        free(head);
+        free(prev);
+        return NULL;
+    }
+    memset(head, 0xFF, ((size_t)1 << HASH_BITS) * sizeof(int32_t));
+    for (size_t i = 0; i + KEY_LEN <= old_len; i++) {
+        uint32_t h = key_hash(old_img + i);
+        prev[i] = head[h];
+        head[h] = (int32_t)i;
+    }
+
+    outbuf_t o = {0};
+    uint8_t hdr[FWDELTA_HEADER_LEN] = {0};
+    out_bytes(&o, hdr, sizeof(hdr));
+
+    size_t i = 0, lit_start = 0, copy_end = 0;
+    while (i < new_len) {
+        size_t best_len = 0, best_off = 0;
+
+        /* Same layout, shifted by what was inserted since the last COPY */
+        size_t expected = copy_end + (i - lit_start);
+        if (expected < old_len) {
+            size_t max = (old_len - expected < new_len - i) ? old_len - expected : new_len - i;
+            best_len = common_len(old_img + expected, new_img + i, max);
+            best_off = expected;
+        }
+
+        if (best_len < 4 * MIN_COPY && i + KEY_LEN <= new_len) {
+            int32_t cand = head[key_hash(new_img + i)];
+            for (int chain = MAX_CHAIN; cand >= 0 && chain > 0; chain--) {
+                size_t max = (old_len - cand < new_len - i) ? old_len - cand : new_len - i;
+                size_t l = common_len(old_img + cand, new_img + i, max);
+                if (l > best_len) {
+                    best_len = l;
+                    best_off = (size_t)cand;
+                }
+                cand = prev[cand];
+            }
+        }
+
+        if (best_len < MIN_COPY) {
+            i++;
+            continue;
+        }
+
+        flush_insert(&o, new_img + lit_start, i - lit_start);
+        int64_t delta = (int64_t)best_off - (int64_t)(copy_end + (i - lit_start));
+        uint32_t zigzag = (delta < 0) ? (uint32_t)(((-delta - 1) << 1) | 1) : (uint32_t)(delta << 1);
+        uint8_t tag = OP_COPY;
+        out_bytes(&o, &tag, 1);
+        out_varint(&o, zigzag);
+        out_varint(&o, (uint32_t)best_len);
+
+        i += best_len;
+        lit_start = i;
+        copy_end = best_off + best_len;
+    }
+    flush_insert(&o, new_img + lit_start, new_len - lit_start);
+    free(head);
+    free(prev);
+
+    if (o.failed) {
+        free(o.buf);
+        return NULL;
+    }
+
+    put_le32(o.buf, FWDELTA_MAGIC);
+    o.buf[4] = FWDELTA_VERSION;
+    o.buf[5] = (old_sha256 ? FWDELTA_FLAG_OLD_DIGEST : 0) | (new_sha256 ? FWDELTA_FLAG_NEW_DIGEST : 0);
+    put_le32(o.buf + 8, (uint32_t)old_len);
+    put_le32(o.buf + 12, lzfw_crc32(0, old_img, old_len));
+    put_le32(o.buf + 16, (uint32_t)new_len);
+    put_le32(o.buf + 20, lzfw_crc32(0, new_img, new_len));
+    put_le32(o.buf + 24, (uint32_t)(o.len - FWDELTA_HEADER_LEN));
+    if (old_sha256) memcpy(o.buf + 32, old_sha256, 32);
+    if (new_sha256) memcpy(o.buf + 64, new_sha256, 32);
+
+    *out_len = o.len;
+    return o.buf;
+}
+
+const char *fwdelta_err_name(fwdelta_err_t err)
+{
+    switch (err) {
+    case FWDELTA_OK:            return "ok";
+    case FWDELTA_ERR_HEADER:    return "bad header";
+    case FWDELTA_ERR_OLD:       return "old image mismatch";
+    case FWDELTA_ERR_CORRUPT:   return "corrupt patch";
+    case FWDELTA_ERR_LENGTH:    return "length mismatch";
+    case FWDELTA_ERR_CRC:       return "CRC mismatch";
+    case FWDELTA_ERR_IO:        return "I/O failed";
+    default:                    return "unknown";
+    }
+}
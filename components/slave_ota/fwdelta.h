@@ -0,0 +1,158 @@
+/*
+ * FW Delta - binary patch format for slave firmware updates
+ *
+ * A patch rebuilds a new image from the image the slave is running:
+ * COPY ops take byte ranges from the old image, INSERT ops carry new
+ * bytes. Successive builds that differ in one source file mostly copy,
+ * so the patch is a small fraction of the image.
+ *
+ * Layout: 96-byte header, then ops. Each op is a tag byte followed by
+ * LEB128 varints:
+ *   0x01 INSERT  len, then len literal bytes
+ *   0x02 COPY    zigzag(old_offset - expected), len
+ * where expected is where the old image would continue if the new one
+ * had only been shifted by the bytes inserted since the last COPY.
+ *
+ * The decoder streams: it takes the patch in pieces of any size, reads
+ * the old image through a callback (flash on the slave) and writes the
+ * new image in order, checking old and new CRC32. Pure C with no
+ * ESP-IDF dependencies, shared with tools/fwdelta_make.c.
+ */
+
+#ifndef FWDELTA_H
+#define FWDELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FWDELTA_MAGIC           0x4C445746  /**< "FWDL" little-endian */
+#define FWDELTA_VERSION         1
+#define FWDELTA_HEADER_LEN      96
+
+#define FWDELTA_FLAG_OLD_DIGEST 0x01    /**< old_sha256 is valid */
+#define FWDELTA_FLAG_NEW_DIGEST 0x02    /**< new_sha256 is valid */
+
+/**
+ * @brief Codec result
+ */
+typedef enum {
+    FWDELTA_OK = 0,
+    FWDELTA_ERR_HEADER,     /**< Bad magic or version */
+    FWDELTA_ERR_OLD,        /**< Old image does not match the patch (CRC32) */
+    FWDELTA_ERR_CORRUPT,    /**< Bad op or COPY outside the old image */
+    FWDELTA_ERR_LENGTH,     /**< Output or op stream length mismatch */
+    FWDELTA_ERR_CRC,        /**< New image CRC32 mismatch */
+    FWDELTA_ERR_IO,         /**< Read or write callback failed */
+} fwdelta_err_t;
+
+/**
+ * @brief Decoded header
+ */
+typedef struct {
+    uint8_t version;
+    uint8_t flags;              /**< FWDELTA_FLAG_* */
+    uint32_t old_len;           /**< Image the patch applies to */
+    uint32_t old_crc32;
+    uint32_t new_len;           /**< Image the patch produces */
+    uint32_t new_crc32;
+    uint32_t ops_len;           /**< Op stream length after the header */
+    uint8_t old_sha256[32];     /**< Appended digest of the old image */
+    uint8_t new_sha256[32];     /**< Appended digest of the new image */
+} fwdelta_header_t;
+
+/** Read from the old image; true on success */
+typedef bool (*fwdelta_read_fn)(void *ctx, size_t offset, void *dst, size_t len);
+/** Receive the next piece of the new image; true on success */
+typedef bool (*fwdelta_write_fn)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Streaming decoder state (treat as opaque)
+ */
+typedef struct {
+    fwdelta_header_t hdr;
+    uint8_t hdr_buf[FWDELTA_HEADER_LEN];
+    size_t hdr_fill;
+    uint8_t state;
+    uint8_t tag;
+    uint8_t vshift;
+    uint32_t vacc;          /* Varint being decoded */
+    uint32_t copy_delta;    /* Zigzag offset of the pending COPY */
+    uint32_t remaining;     /* INSERT bytes left */
+    uint32_t expected_old;
+    uint32_t out_len;
+    uint32_t consumed;
+    uint32_t crc;
+    fwdelta_read_fn read_old;
+    void *old_ctx;
+    fwdelta_write_fn write;
+    void *ctx;
+} fwdelta_decoder_t;
+
+/**
+ * @brief Parse a header
+ *
+ * @param buf At least FWDELTA_HEADER_LEN bytes
+ * @param out Filled on success
+ * @return FWDELTA_OK or FWDELTA_ERR_HEADER
+ */
+fwdelta_err_t fwdelta_parse_header(const uint8_t *buf, fwdelta_header_t *out);
+
+/**
+ * @brief Start applying a patch
+ *
+ * @param d Decoder state
+ * @param read_old Reads the running (old) image
+ * @param old_ctx Passed to read_old
+ * @param write Receives the new image in order
+ * @param ctx Passed to write
+ */
+void fwdelta_decoder_init(fwdelta_decoder_t *d, fwdelta_read_fn read_old, void *old_ctx,
+                          fwdelta_write_fn write, void *ctx);
+
+/**
+ * @brief Feed the next piece of the patch (header included)
+ *
+ * Once the header is complete, the old image is checked against its
+ * CRC32 before any output is produced.
+ *
+ * @return FWDELTA_OK or the first error; the decoder is unusable after an error
+ */
+fwdelta_err_t fwdelta_decoder_feed(fwdelta_decoder_t *d, const uint8_t *in, size_t len);
+
+/**
+ * @brief Check that the whole patch was applied and the new CRC32 matches
+ */
+fwdelta_err_t fwdelta_decoder_finish(fwdelta_decoder_t *d);
+
+/**
+ * @brief Build a patch (host tool)
+ *
+ * @param old_img Image the slave runs
+ * @param old_len Its length
+ * @param new_img Image to produce
+ * @param new_len Its length
+ * @param old_sha256 Old image digest (NULL = none)
+ * @param new_sha256 New image digest (NULL = none)
+ * @param out_len Patch length on success
+ * @return malloc'd patch including header, NULL on failure
+ */
+uint8_t *fwdelta_encode(const uint8_t *old_img, size_t old_len,
+                        const uint8_t *new_img, size_t new_len,
+                        const uint8_t old_sha256[32], const uint8_t new_sha256[32],
+                        size_t *out_len);
+
+/**
+ * @brief Human-readable name of a result
+ */
+const char *fwdelta_err_name(fwdelta_err_t err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FWDELTA_H */
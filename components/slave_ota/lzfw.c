@@ -0,0 +1,330 @@
+/*
+ * LZFW - implementation
+ *
+ * Header layout (little-endian):
+ *   0 magic u32 | 4 version u8 | 5 window_bits u8 | 6 flags u8 | 7 pad
+ *   8 raw_len u32 | 12 comp_len u32 | 16 raw_crc32 u32
+ *   20 image_sha256[32] | 52 reserved u32
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "lzfw.h"
+
+#define MIN_MATCH       3
+#define HASH_BITS       15
+#define MAX_CHAIN       128     /* Compressor only: candidates tried per position */
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* Reflected CRC-32 (0xEDB88320), four bits per step */
+static const uint32_t s_crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t lzfw_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+lzfw_err_t lzfw_parse_header(const uint8_t *buf, lzfw_header_t *out)
+{
+    if (get_le32(buf) != LZFW_MAGIC || buf[4] != LZFW_VERSION ||
+        buf[5] < LZFW_MIN_WINDOW_BITS || buf[5] > LZFW_MAX_WINDOW_BITS) {
+        return LZFW_ERR_HEADER;
+    }
+    out->version = buf[4];
+    out->window_bits = buf[5];
+    out->flags = buf[6];
+    out->raw_len = get_le32(buf + 8);
+    out->comp_len = get_le32(buf + 12);
+    out->raw_crc32 = get_le32(buf + 16);
+    memcpy(out->image_sha256, buf + 20, sizeof(out->image_sha256));
+    return LZFW_OK;
+}
+
+/* ─── Decoder ─── */
+
+void lzfw_decoder_init(lzfw_decoder_t *d, uint8_t *window, size_t window_size,
+                       lzfw_write_fn write, void *ctx)
+{
+    memset(d, 0, sizeof(*d));
+    d->window = window;
+    d->window_size = window_size;
+    d->match_lo = -1;
+    d->write = write;
+    d->ctx = ctx;
+}
+
+/* Pending output never wraps: it is flushed whenever pos reaches the end
+ * of the ring, and the ring keeps the bytes as match history */
+static lzfw_err_t flush(lzfw_decoder_t *d)
+{
+    uint32_t n = d->pos - d->flushed;
+    if (n == 0) {
+        return LZFW_OK;
+    }
+    const uint8_t *p = d->window + (d->flushed & d->mask);
+    d->crc = lzfw_crc32(d->crc, p, n);
+    d->flushed = d->pos;
+    return d->write(d->ctx, p, n) ? LZFW_OK : LZFW_ERR_OUTPUT;
+}
+
+static lzfw_err_t put(lzfw_decoder_t *d, uint8_t b)
+{
+    if (d->pos >= d->hdr.raw_len) {
+        return LZFW_ERR_LENGTH;
+    }
+    d->window[d->pos & d->mask] = b;
+    d->pos++;
+    return ((d->pos & d->mask) == 0) ? flush(d) : LZFW_OK;
+}
+
+static lzfw_err_t copy_match(lzfw_decoder_t *d, uint16_t token)
+{
+    uint32_t off = (token & d->mask) + 1;
+    uint32_t len = (uint32_t)(token >> d->hdr.window_bits) + MIN_MATCH;
+    if (off > d->pos) {
+        return LZFW_ERR_CORRUPT;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        lzfw_err_t err = put(d, d->window[(d->pos - off) & d->mask]);
+        if (err != LZFW_OK) {
+            return err;
+        }
+    }
+    return LZFW_OK;
+}
+
+lzfw_err_t lzfw_decoder_feed(lzfw_decoder_t *d, const uint8_t *in, size_t len)
+{
+    while (len > 0) {
+        if (d->hdr_fill < LZFW_HEADER_LEN) {
+            size_t n = LZFW_HEADER_LEN - d->hdr_fill;
+            if (n > len) n = len;
+            memcpy(d->hdr_buf + d->hdr_fill, in, n);
+            d->hdr_fill += n;
+            in += n;
+            len -= n;
+            if (d->hdr_fill == LZFW_HEADER_LEN) {
+                if (lzfw_parse_header(d->hdr_buf, &d->hdr) != LZFW_OK) {
+                    return LZFW_ERR_HEADER;
+                }
+                if (d->window_size < ((size_t)1 << d->hdr.window_bits)) {
+                    return LZFW_ERR_WINDOW;
+                }
+                d->mask = (1u << d->hdr.window_bits) - 1;
+            }
+            continue;
+        }
+
+        if (d->consumed >= d->hdr.comp_len) {
+            return LZFW_ERR_LENGTH;
+        }
+        uint8_t b = *in++;
+        len--;
+        d->consumed++;
+
+        lzfw_err_t err = LZFW_OK;
+        if (d->match_lo >= 0) {
+            err = copy_match(d, (uint16_t)(d->match_lo | (b << 8)));
+            d->match_lo = -1;
+        } else if (d->flag_bits == 0) {
+            d->flags = b;
+            d->flag_bits = 8;
+        } else {
+            if (d->flags & 1) {
+                err = put(d, b);
+            } else {
+                d->match_lo = b;
+            }
+            d->flags >>= 1;
+            d->flag_bits--;
+        }
+        if (err != LZFW_OK) {
+            return err;
+        }
+    }
+    return (d->hdr_fill == LZFW_HEADER_LEN) ? flush(d) : LZFW_OK;
+}
+
+lzfw_err_t lzfw_decoder_finish(lzfw_decoder_t *d)
+{
+    if (d->hdr_fill < LZFW_HEADER_LEN) {
+        return LZFW_ERR_HEADER;
+    }
+    lzfw_err_t err = flush(d);
+    if (err != LZFW_OK) {
+        return err;
+    }
+    if (d->pos != d->hdr.raw_len || d->consumed != d->hdr.comp_len || d->match_lo >= 0) {
+        return LZFW_ERR_LENGTH;
+    }
+    return (d->crc == d->hdr.raw_crc32) ? LZFW_OK : LZFW_ERR_CRC;
+}
+
+/* ─── Compressor ─── */
+
+size_t lzfw_compress_bound(size_t raw_len)
+{
+    /* All literals: one flag byte per 8 bytes */
+    return LZFW_HEADER_LEN + raw_len + (raw_len + 7) / 8;
+}
+
+static uint32_t hash3(const uint8_t *p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+typedef struct {
+    const uint8_t *src;
+    size_t len;
+    size_t win;
+    size_t max_match;
+    int32_t *head;
+    int32_t *prev;
+} matcher_t;
+
+static size_t find_match(const matcher_t *m, size_t i, size_t *off)
+{
+    size_t best_len = 0;
+    if (i + MIN_MATCH > m->len) {
+        return 0;
+    }
+    size_t limit = (m->len - i < m->max_match) ? m->len - i : m->max_match;
+    int32_t cand = m->head[hash3(m->src + i)];
+    for (int chain = MAX_CHAIN; cand >= 0 && i - (size_t)cand <= m->win && chain > 0; chain--) {
+        size_t l = 0;
+        while (l < limit && m->src[cand + l] == m->src[i + l]) l++;
+        if (l > best_len) {
+            best_len = l;
+            *off = i - (size_t)cand;
+            if (l == limit) break;
+        }
+        int32_t next = m->prev[cand & (m->win - 1)];
+        if (next >= cand) break;    /* Slot reused by a newer position */
+        cand = next;
+    }
+    return best_len;
+}
+
+static void insert(matcher_t *m, size_t i)
+{
+    if (i + MIN_MATCH <= m->len) {
+        uint32_t h = hash3(m->src + i);
+        m->prev[i & (m->win - 1)] = m->head[h];
+        m->head[h] = (int32_t)i;
+    }
+}
+
+size_t lzfw_compress(const uint8_t *src, size_t len, uint8_t window_bits,
+                     const uint8_t sha256[32], uint8_t *dst)
+{
+    if (window_bits < LZFW_MIN_WINDOW_BITS || window_bits > LZFW_MAX_WINDOW_BITS ||
+        len > INT32_MAX) {
+        return 0;
+    }
+    matcher_t m = {
+        .src = src,
+        .len = len,
+        .win = (size_t)1 << window_bits,
+        .max_match = MIN_MATCH + ((size_t)1 << (16 - window_bits)) - 1,
+        .head = malloc(((size_t)1 << HASH_BITS) * sizeof(int32_t)),
+        .prev = malloc(((size_t)1 << window_bits) * sizeof(int32_t)),
+    };
+    if (!m.head || !m.prev) {
+        free(m.head);
+        free(m.prev);
+        return 0;
+    }
+    memset(m.head, 0xFF, ((size_t)1 << HASH_BITS) * sizeof(int32_t));
+
+    uint8_t *out = dst + LZFW_HEADER_LEN;
+    uint8_t *flag_p = NULL;
+    int flag_n = 8;
+    size_t i = 0;
+
+    while (i < len) {
+        size_t off = 0;
+        size_t mlen = find_match(&m, i, &off);
+        insert(&m, i);
+
+        /* Lazy step: emit a literal if a clearly longer match starts at i + 1 */
+        if (mlen >= MIN_MATCH && mlen < m.max_match) {
+            size_t off2;
+            if (find_match(&m, i + 1, &off2) > mlen + 1) {
+                mlen = 0;
+            }
+        }
+
+        if (flag_n == 8) {
+            flag_p = out++;
+            *flag_p = 0;
+            flag_n = 0;
+        }
+        if (mlen >= MIN_MATCH) {
+            uint16_t token = (uint16_t)((off - 1) | ((mlen - MIN_MATCH) << window_bits));
+            *out++ = (uint8_t)token;
+            *out++ = (uint8_t)(token >> 8);
+            for (size_t k = 1; k < mlen; k++) {
+                insert(&m, i + k);
+            }
+            i += mlen;
+        } else {
+            *flag_p |= (uint8_t)(1u << flag_n);
+            *out++ = src[i];
+            i++;
+        }
+        flag_n++;
+    }
+    free(m.head);
+    free(m.prev);
+
+    size_t comp_len = (size_t)(out - dst) - LZFW_HEADER_LEN;
+    memset(dst, 0, LZFW_HEADER_LEN);
+    put_le32(dst, LZFW_MAGIC);
+    dst[4] = LZFW_VERSION;
+    dst[5] = window_bits;
+    dst[6] = sha256 ? LZFW_FLAG_HAS_DIGEST : 0;
+    put_le32(dst + 8, (uint32_t)len);
+    put_le32(dst + 12, (uint32_t)comp_len);
+    put_le32(dst + 16, lzfw_crc32(0, src, len));
+    if (sha256) {
+        memcpy(dst + 20, sha256, 32);
+    }
+    return LZFW_HEADER_LEN + comp_len;
+}
+
+const char *lzfw_err_name(lzfw_err_t err)
+{
+    switch (err) {
+    case LZFW_OK:           return "ok";
+    case LZFW_ERR_HEADER:   return "bad header";
+    case LZFW_ERR_WINDOW:   return "window too small";
+    case LZFW_ERR_CORRUPT:  return "corrupt stream";
+    case LZFW_ERR_LENGTH:   return "length mismatch";
+    case LZFW_ERR_CRC:      return "CRC mismatch";
+    case LZFW_ERR_OUTPUT:   return "output failed";
+    default:                return "unknown";
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * LZFW - LZSS codec for slave firmware transfer
+ *
+ * A compressed image is a 56-byte header followed by the token stream.
+ * Each flag byte announces the next 8 tokens, LSB first: 1 = literal
+ * byte, 0 = 16-bit match (offset in the low window_bits, length - 3 in
+ * the remaining bits). The decoder's only buffer is the history window
+ * (1 << window_bits bytes, at most 32 KB), which doubles as its output
+ * buffer, so it fits next to the OTA writer in the C6's SRAM and
+ * accepts input split at any byte.
+ *
+ * Pure C with no ESP-IDF dependencies: the same file builds the on-target
+ * decoder and the Linux packer (tools/lzfw_pack.c).
+ */
+
+#ifndef LZFW_H
+#define LZFW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LZFW_MAGIC              0x57465A4C  /**< "LZFW" little-endian */
+#define LZFW_VERSION            1
+#define LZFW_HEADER_LEN         56
+#define LZFW_MIN_WINDOW_BITS    8
+#define LZFW_MAX_WINDOW_BITS    15
+#define LZFW_DEFAULT_WINDOW_BITS 13
+
+#define LZFW_FLAG_HAS_DIGEST    0x01    /**< image_sha256 holds the image's appended digest */
+
+/**
+ * @brief Codec result
+ */
+typedef enum {
+    LZFW_OK = 0,
+    LZFW_ERR_HEADER,        /**< Bad magic, version or window size */
+    LZFW_ERR_WINDOW,        /**< Caller's window smaller than the stream needs */
+    LZFW_ERR_CORRUPT,       /**< Match reaches before the start of output */
+    LZFW_ERR_LENGTH,        /**< Output longer or shorter than raw_len */
+    LZFW_ERR_CRC,           /**< Output CRC32 mismatch */
+    LZFW_ERR_OUTPUT,        /**< Write callback failed */
+} lzfw_err_t;
+
+/**
+ * @brief Decoded header
+ */
+typedef struct {
+    uint8_t version;
+    uint8_t window_bits;
+    uint8_t flags;              /**< LZFW_FLAG_* */
+    uint32_t raw_len;           /**< Decompressed image length */
+    uint32_t comp_len;          /**< Token stream length after the header */
+    uint32_t raw_crc32;         /**< CRC32 (IEEE) of the decompressed image */
+    uint8_t image_sha256[32];   /**< Valid if LZFW_FLAG_HAS_DIGEST */
+} lzfw_header_t;
+
+/**
+ * @brief Output callback
+ *
+ * @return true on success; false aborts decoding with LZFW_ERR_OUTPUT
+ */
+typedef bool (*lzfw_write_fn)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Streaming decoder state (treat as opaque)
+ */
+typedef struct {
+    lzfw_header_t hdr;
+    uint8_t hdr_buf[LZFW_HEADER_LEN];
+    size_t hdr_fill;
+    uint8_t *window;
+    size_t window_size;
+    uint32_t mask;
+    uint32_t pos;           /* Bytes produced */
+    uint32_t flushed;       /* Bytes handed to the callback */
+    uint32_t crc;
+    uint32_t consumed;      /* Token stream bytes consumed */
+    uint8_t flags;          /* Current flag byte */
+    uint8_t flag_bits;      /* Tokens left in the current flag byte */
+    int16_t match_lo;       /* First byte of a split match token, -1 if none */
+    lzfw_write_fn write;
+    void *ctx;
+} lzfw_decoder_t;
+
+/**
+ * @brief Parse a header
+ *
+ * @param buf At least LZFW_HEADER_LEN bytes
+ * @param out Filled on success
+ * @return LZFW_OK or LZFW_ERR_HEADER
+ */
+lzfw_err_t lzfw_parse_header(const uint8_t *buf, lzfw_header_t *out);
+
+/**
+ * @brief Start decoding a stream
+ *
+ * @param d Decoder state
+ * @param window History buffer, at least 1 << window_bits of the stream
+ * @param window_size Size of window
+ * @param write Receives decompressed data in order
+ * @param ctx Passed to write
+ */
+void lzfw_decoder_init(lzfw_decoder_t *d, uint8_t *window, size_t window_size,
+                       lzfw_write_fn write, void *ctx);
+
+/**
+ * @brief Feed the next piece of the compressed stream (header included)
+ *
+ * @return LZFW_OK or the first error; the decoder is unusable after an error
+ */
+lzfw_err_t lzfw_decoder_feed(lzfw_decoder_t *d, const uint8_t *in, size_t len);
+
+/**
+ * @brief Flush remaining output and check length and CRC32
+ */
+lzfw_err_t lzfw_decoder_finish(lzfw_decoder_t *d);
+
+/**
+ * @brief Worst-case compressed size (header included)
+ */
+size_t lzfw_compress_bound(size_t raw_len);
+
+/**
+ * @brief Compress a whole image (hash-chain matcher with one-step lazy matching, meant for the host tool)
+ *
+ * @param src Raw image
+ * @param len Raw length
+ * @param window_bits LZFW_MIN_WINDOW_BITS..LZFW_MAX_WINDOW_BITS
+ * @param sha256 Image digest to store in the header (NULL = none)
+ * @param dst Output, at least lzfw_compress_bound(len) bytes
+ * @return Compressed size including header, 0 on bad arguments or no memory
+ */
+size_t lzfw_compress(const uint8_t *src, size_t len, uint8_t window_bits,
+                     const uint8_t sha256[32], uint8_t *dst);
+
+/**
+ * @brief CRC32 (IEEE 802.3, as esp_rom_crc32_le with init 0)
+ */
+uint32_t lzfw_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Human-readable name of a result
+ */
+const char *lzfw_err_name(lzfw_err_t err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZFW_H */
@@ -0,0 +1,106 @@
+/*
+ * Slave Image - implementation
+ *
+ * Offsets follow esp_app_format.h (esp_image_header_t is 24 bytes,
+ * esp_image_segment_header_t is 8) and the length rules of
+ * bootloader_support's esp_image_format.c.
+ */
+
+#include <string.h>
+#include "slave_image.h"
+
+#define HEADER_LEN          24
+#define HDR_SEGMENT_COUNT   1
+#define HDR_CHIP_ID         12
+#define HDR_HASH_APPENDED   23
+#define SEGMENT_HEADER_LEN  8
+#define CHECKSUM_ALIGN      16      /* Checksum byte ends a 16-byte block */
+#define HASH_LEN            32
+#define SIG_SECTOR_LEN      4096
+#define SIG_BLOCK_MAGIC     0xE7    /* ets_secure_boot_sig_block_t.magic_byte */
+#define SIG_BLOCK_VERSION   0x02    /* ... .version (RSA-PSS / ECDSA v2) */
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+slave_image_err_t slave_image_parse(slave_image_read_fn read, void *ctx,
+                                    size_t max_len, slave_image_info_t *out)
+{
+    uint8_t hdr[HEADER_LEN];
+
+    memset(out, 0, sizeof(*out));
+    if (max_len < HEADER_LEN) {
+        return SLAVE_IMAGE_ERR_TRUNCATED;
+    }
+    if (!read(ctx, 0, hdr, sizeof(hdr))) {
+        return SLAVE_IMAGE_ERR_READ;
+    }
+    if (hdr[0] != SLAVE_IMAGE_MAGIC) {
+        return SLAVE_IMAGE_ERR_MAGIC;
+    }
+
+    out->segment_count = hdr[HDR_SEGMENT_COUNT];
+    out->chip_id = (uint16_t)(hdr[HDR_CHIP_ID] | (hdr[HDR_CHIP_ID + 1] << 8));
+    if (out->segment_count == 0 || out->segment_count > SLAVE_IMAGE_MAX_SEGMENTS) {
+        return SLAVE_IMAGE_ERR_SEGMENTS;
+    }
+
+    size_t off = HEADER_LEN;
+    for (int i = 0; i < out->segment_count; i++) {
+        uint8_t seg[SEGMENT_HEADER_LEN];
+        if (off + SEGMENT_HEADER_LEN > max_len) {
+            return SLAVE_IMAGE_ERR_TRUNCATED;
+        }
+        if (!read(ctx, off, seg, sizeof(seg))) {
+            return SLAVE_IMAGE_ERR_READ;
+        }
+        uint32_t data_len = get_le32(seg + 4);
+        off += SEGMENT_HEADER_LEN;
+        if (data_len > max_len - off) {
+            return SLAVE_IMAGE_ERR_TRUNCATED;
+        }
+        off += data_len;
+    }
+
+    /* One checksum byte, padded so it is the last byte of a 16-byte block */
+    off = (off + 1 + CHECKSUM_ALIGN - 1) & ~(size_t)(CHECKSUM_ALIGN - 1);
+
+    if (hdr[HDR_HASH_APPENDED]) {
+        out->hash_offset = off;
+        off += HASH_LEN;
+    }
+    if (off > max_len) {
+        return SLAVE_IMAGE_ERR_TRUNCATED;
+    }
+
+    /* Secure Boot v2 signature sector starts at the next 4 KB boundary */
+    size_t sig = (off + SIG_SECTOR_LEN - 1) & ~(size_t)(SIG_SECTOR_LEN - 1);
+    if (sig + SIG_SECTOR_LEN <= max_len) {
+        uint8_t blk[2];
+        if (!read(ctx, sig, blk, sizeof(blk))) {
+            return SLAVE_IMAGE_ERR_READ;
+        }
+        if (blk[0] == SIG_BLOCK_MAGIC && blk[1] == SIG_BLOCK_VERSION) {
+            out->sig_offset = sig;
+            off = sig + SIG_SECTOR_LEN;
+        }
+    }
+
+    out->image_len = off;
+    return SLAVE_IMAGE_OK;
+}
+
+const char *slave_image_err_name(slave_image_err_t err)
+{
+    switch (err) {
+    case SLAVE_IMAGE_OK:            return "ok";
+    case SLAVE_IMAGE_ERR_READ:      return "read failed";
+    case SLAVE_IMAGE_ERR_MAGIC:     return "no image magic";
+    case SLAVE_IMAGE_ERR_SEGMENTS:  return "bad segment count";
+    case SLAVE_IMAGE_ERR_TRUNCATED: return "truncated";
+    default:                        return "unknown";
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Slave Image - exact length of an ESP application image
+ *
+ * Walks the image header and segment headers, then adds the checksum
+ * padding, the appended SHA-256 and a Secure Boot v2 signature sector
+ * if present. The result is the number of bytes the slave needs, with
+ * no reliance on erased (0xFF) flash marking the end.
+ *
+ * Pure logic with no ESP-IDF dependencies: bytes are fetched through a
+ * read callback so the parser can run on flash, RAM or a host file.
+ */
+
+#ifndef SLAVE_IMAGE_H
+#define SLAVE_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLAVE_IMAGE_MAGIC           0xE9    /**< esp_image_header_t.magic */
+#define SLAVE_IMAGE_MAX_SEGMENTS    16      /**< ESP_IMAGE_MAX_SEGMENTS */
+
+/**
+ * @brief Parse result
+ */
+typedef enum {
+    SLAVE_IMAGE_OK = 0,
+    SLAVE_IMAGE_ERR_READ,       /**< Read callback failed */
+    SLAVE_IMAGE_ERR_MAGIC,      /**< First byte is not 0xE9 (empty or foreign data) */
+    SLAVE_IMAGE_ERR_SEGMENTS,   /**< Segment count is 0 or above the maximum */
+    SLAVE_IMAGE_ERR_TRUNCATED,  /**< A segment or trailer runs past max_len */
+} slave_image_err_t;
+
+/**
+ * @brief Layout of a parsed image
+ */
+typedef struct {
+    size_t image_len;           /**< Total bytes to transfer */
+    size_t hash_offset;         /**< Offset of the appended SHA-256 (0 = none) */
+    size_t sig_offset;          /**< Offset of the signature sector (0 = none) */
+    uint16_t chip_id;           /**< esp_chip_id_t the image was built for */
+    uint8_t segment_count;
+} slave_image_info_t;
+
+/**
+ * @brief Read callback
+ *
+ * @param ctx Caller context
+ * @param offset Byte offset from the start of the image
+ * @param dst Destination buffer
+ * @param len Bytes to read
+ * @return true on success
+ */
+typedef bool (*slave_image_read_fn)(void *ctx, size_t offset, void *dst, size_t len);
+
+/**
+ * @brief Compute the exact length of the image
+ *
+ * @param read Read callback
+ * @param ctx Passed to read
+ * @param max_len Size of the container (partition or file); nothing
+ *                past it is read
+ * @param out Filled on success
+ * @return SLAVE_IMAGE_OK or the reason the data is not a usable image
+ */
+slave_image_err_t slave_image_parse(slave_image_read_fn read, void *ctx,
+                                    size_t max_len, slave_image_info_t *out);
+
+/**
+ * @brief Human-readable name of a parse result
+ */
+const char *slave_image_err_name(slave_image_err_t err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLAVE_IMAGE_H */
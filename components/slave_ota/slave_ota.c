@@ -0,0 +1,953 @@
+/*
+ * Slave OTA - implementation
+ *
+ * Addressable sources (embedded images, memory-mapped partitions) are
+ * sent zero-copy: each OTA write points into the mapping, and the flash
+ * cache does the reading. Other sources go through a reader task.
+ * Buffers circulate between two queues: free_q holds indices of empty
+ * buffers, full_q carries filled chunks to the writer. The reader ends
+ * the stream with an end marker, also after an abort, so the writer
+ * always knows when the reader is done with the ring.
+ *
+ * The transfer length comes from the image headers (slave_image.c), so
+ * exactly the image is sent: no trailing padding, and no early stop on
+ * a chunk that happens to be all 0xFF.
+ *
+ * A source may instead hold an image the slave rebuilds itself: an
+ * LZFW-compressed image (lzfw.h, tools/lzfw_pack.c) or a delta patch
+ * against the image it runs (fwdelta.h, tools/fwdelta_make.c). These are
+ * streamed as-is over the wifi_raw OTA_Z_* messages, so fewer bytes
+ * cross SDIO. All formats go through the same pipeline via ota_sink_t.
+ *
+ * Installed-image records live in NVS so an unchanged image is not
+ * reflashed; see slave_ota_is_installed().
+ *
+ * A slave that answers OTA_Z_RESUME gets every format, plain ESP images
+ * included, over DATA_CRC: each chunk is acknowledged with its CRC32
+ * and only a failed chunk is resent. Whenever the acknowledged offset
+ * crosses a checkpoint, it is stored in NVS with the stream's length and
+ * CRC32, so a transfer cut short by a reset continues from the last
+ * checkpoint. Stock slaves keep the esp-hosted path, where a write may
+ * have landed before it failed and cannot safely be repeated.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "nvs.h"
+#include "mbedtls/sha256.h"
+#include "esp_hosted.h"
+#include "esp_hosted_ota.h"
+#include "wifi_raw.h"
+#include "lzfw.h"
+#include "fwdelta.h"
+#include "slave_image.h"
+#include "slave_ota.h"
+
+static const char *TAG = "slave_ota";
+
+#define READER_STACK        3072
+#define READER_PRIORITY     (configMAX_PRIORITIES - 3)
+#define CHUNK_END           0xFF    /* full_q index marking end of stream */
+#define HASH_READ_CHUNK     4096
+#define FW_INFO_TIMEOUT_MS  1000
+
+/* Whether the slave answers wifi_raw requests, learnt from the first
+ * one; a stock slave then costs a single timeout per boot */
+typedef enum {
+    SLAVE_EXT_UNKNOWN,
+    SLAVE_EXT_YES,
+    SLAVE_EXT_NO,
+} slave_ext_t;
+
+static slave_ext_t s_slave_ext;
+
+#define OTA_NVS_NAMESPACE   "slave_ota"
+#define OTA_NVS_KEY         "installed"
+#define OTA_NVS_VERSION     1
+#define OTA_NVS_RESUME_KEY  "resume"
+#define OTA_RESUME_VERSION  1
+
+/* Last image this host activated on the slave */
+typedef struct {
+    uint32_t version;
+    uint8_t sha256[32];
+    uint32_t fw_major, fw_minor, fw_patch;  /* esp-hosted version it reported */
+    uint8_t fw_valid;                       /* 0 until read after the slave rebooted */
+} installed_rec_t;
+
+/* Interrupted resumable transfer */
+typedef struct {
+    uint32_t version;
+    uint32_t total_len;
+    uint32_t stream_crc32;
+    uint32_t offset;                        /* Last checkpoint the slave acknowledged */
+} resume_rec_t;
+
+typedef struct {
+    uint8_t idx;
+    uint16_t len;
+} chunk_msg_t;
+
+typedef struct {
+    size_t total_len;
+    uint32_t stream_crc32;                  /* 0 unless resumable */
+    uint32_t checkpoint_len;
+} ota_session_t;
+
+/* Where the writer sends the stream */
+typedef struct {
+    const char *name;
+    bool retry;                             /* A failed write can be repeated */
+    esp_err_t (*begin)(const ota_session_t *sess);
+    esp_err_t (*write)(size_t offset, const uint8_t *data, size_t len);
+    esp_err_t (*end)(void);
+} ota_sink_t;
+
+static esp_err_t hosted_begin(const ota_session_t *sess)
+{
+    return esp_hosted_slave_ota_begin();
+}
+
+static esp_err_t hosted_write(size_t offset, const uint8_t *data, size_t len)
+{
+    /* Only read, despite the prototype; data may point into flash */
+    return esp_hosted_slave_ota_write((uint8_t *)data, len);
+}
+
+static esp_err_t stream_begin(const ota_session_t *sess)
+{
+    esp_err_t ret = wifi_raw_init();
+    return (ret == ESP_OK) ?
+           wifi_raw_ota_z_begin(sess->total_len, sess->stream_crc32, sess->checkpoint_len) : ret;
+}
+
+static esp_err_t stream_write(size_t offset, const uint8_t *data, size_t len)
+{
+    return wifi_raw_ota_z_write(offset, data, (uint16_t)len);
+}
+
+static esp_err_t acked_write(size_t offset, const uint8_t *data, size_t len)
+{
+    return wifi_raw_ota_z_write_crc(offset, data, (uint16_t)len, lzfw_crc32(0, data, len));
+}
+
+static const ota_sink_t s_raw_sink = {
+    .name = "raw", .begin = hosted_begin, .write = hosted_write, .end = esp_hosted_slave_ota_end,
+};
+
+static const ota_sink_t s_stream_sink = {
+    .name = "OTA_Z", .begin = stream_begin, .write = stream_write, .end = wifi_raw_ota_z_end,
+};
+
+static const ota_sink_t s_acked_sink = {
+    .name = "OTA_Z+CRC", .retry = true,
+    .begin = stream_begin, .write = acked_write, .end = wifi_raw_ota_z_end,
+};
+
+/* An image the slave rebuilds itself (see the file comment) */
+typedef struct {
+    const char *format;
+    size_t total_len;           /* Stream length including header */
+    size_t raw_len;             /* Size of the image the slave ends up with */
+    bool has_digest;
+    uint8_t sha256[32];         /* Digest of that image */
+    bool has_base;
+    uint8_t base_sha256[32];    /* Delta only: digest of the image it applies to */
+} stream_info_t;
+
+typedef struct {
+    const slave_ota_src_t *src;
+    size_t start;
+    size_t image_len;
+    size_t chunk_size;
+    uint8_t *bufs;
+    QueueHandle_t free_q;
+    QueueHandle_t full_q;
+    volatile bool abort;
+    esp_err_t read_err;
+    uint8_t cur_idx;                        /* Push sources: buffer being filled */
+    size_t cur_fill;
+    size_t produced;
+} ota_pipe_t;
+
+static esp_err_t partition_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    return esp_partition_read((const esp_partition_t *)ctx, offset, dst, len);
+}
+
+void slave_ota_src_memory(slave_ota_src_t *src, const void *data, size_t size)
+{
+    memset(src, 0, sizeof(*src));
+    src->data = data;
+    src->size = size;
+    src->name = "memory";
+}
+
+esp_err_t slave_ota_src_partition(slave_ota_src_t *src, const esp_partition_t *part)
+{
+    if (!src || !part) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(src, 0, sizeof(*src));
+    src->size = part->size;
+    src->read = partition_read;
+    src->ctx = (void *)part;
+    src->name = part->label;
+
+    const void *ptr;
+    esp_err_t ret = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA,
+                                       &ptr, &src->map);
+    if (ret == ESP_OK) {
+        src->data = ptr;
+        src->mapped = true;
+    } else {
+        ESP_LOGW(TAG, "Cannot map '%s' (%s), reading through the ring instead",
+                 part->label, esp_err_to_name(ret));
+    }
+    return ESP_OK;
+}
+
+void slave_ota_src_reader(slave_ota_src_t *src, slave_ota_read_fn read, void *ctx,
+                          size_t size, bool sequential)
+{
+    memset(src, 0, sizeof(*src));
+    src->size = size;
+    src->sequential = sequential;
+    src->read = read;
+    src->ctx = ctx;
+    src->name = "reader";
+}
+
+/* Host-side LZFW decoding source */
+typedef struct {
+    const uint8_t *in;
+    size_t in_len;
+    uint8_t *window;
+    size_t window_size;
+    slave_ota_emit_fn emit;
+    void *emit_ctx;
+    esp_err_t emit_err;
+} lzfw_src_t;
+
+static bool lzfw_src_out(void *ctx, const uint8_t *data, size_t len)
+{
+    lzfw_src_t *z = (lzfw_src_t *)ctx;
+    z->emit_err = z->emit(z->emit_ctx, data, len);
+    return z->emit_err == ESP_OK;
+}
+
+static esp_err_t lzfw_src_push(void *ctx, slave_ota_emit_fn emit, void *emit_ctx)
+{
+    lzfw_src_t *z = (lzfw_src_t *)ctx;
+    z->emit = emit;
+    z->emit_ctx = emit_ctx;
+    z->emit_err = ESP_OK;
+
+    /* One feed: emit blocks on the ring, which paces the decoder */
+    lzfw_decoder_t d;
+    lzfw_decoder_init(&d, z->window, z->window_size, lzfw_src_out, z);
+    lzfw_err_t err = lzfw_decoder_feed(&d, z->in, z->in_len);
+    if (err == LZFW_OK) {
+        err = lzfw_decoder_finish(&d);
+    }
+    if (err == LZFW_ERR_OUTPUT) {
+        return z->emit_err;
+    }
+    if (err != LZFW_OK) {
+        ESP_LOGE(TAG, "LZFW decode failed: %s", lzfw_err_name(err));
+        return (err == LZFW_ERR_CRC) ? ESP_ERR_INVALID_CRC : ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static void lzfw_src_release(void *ctx)
+{
+    lzfw_src_t *z = (lzfw_src_t *)ctx;
+    free(z->window);
+    free(z);
+}
+
+esp_err_t slave_ota_src_lzfw(slave_ota_src_t *src, const void *data, size_t size)
+{
+    lzfw_header_t hdr;
+    if (!src || !data || size < LZFW_HEADER_LEN ||
+        lzfw_parse_header(data, &hdr) != LZFW_OK ||
+        size - LZFW_HEADER_LEN < hdr.comp_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lzfw_src_t *z = calloc(1, sizeof(*z));
+    if (!z) {
+        return ESP_ERR_NO_MEM;
+    }
+    z->in = data;
+    z->in_len = LZFW_HEADER_LEN + (size_t)hdr.comp_len;
+    z->window_size = (size_t)1 << hdr.window_bits;
+    z->window = malloc(z->window_size);
+    if (!z->window) {
+        free(z);
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(src, 0, sizeof(*src));
+    src->size = hdr.raw_len;
+    src->sequential = true;
+    src->push = lzfw_src_push;
+    src->ctx = z;
+    src->name = "LZFW";
+    src->release = lzfw_src_release;
+    src->has_sha256 = (hdr.flags & LZFW_FLAG_HAS_DIGEST) != 0;
+    memcpy(src->sha256, hdr.image_sha256, sizeof(src->sha256));
+    ESP_LOGI(TAG, "LZFW source: %lu bytes decode to %lu (%.1f%%), %u-byte window",
+             (unsigned long)z->in_len, (unsigned long)hdr.raw_len,
+             hdr.raw_len ? 100.0f * z->in_len / hdr.raw_len : 0.0f, (unsigned)z->window_size);
+    return ESP_OK;
+}
+
+void slave_ota_src_close(slave_ota_src_t *src)
+{
+    if (!src) {
+        return;
+    }
+    if (src->mapped) {
+        esp_partition_munmap(src->map);
+        src->mapped = false;
+        src->data = NULL;
+    }
+    if (src->release) {
+        src->release(src->ctx);
+        src->release = NULL;
+        src->ctx = NULL;
+    }
+}
+
+static esp_err_t src_read(const slave_ota_src_t *src, size_t offset, void *dst, size_t len)
+{
+    if (offset > src->size || len > src->size - offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (src->data) {
+        memcpy(dst, src->data + offset, len);
+        return ESP_OK;
+    }
+    if (!src->read) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return src->read(src->ctx, offset, dst, len);
+}
+
+static bool image_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    return src_read((const slave_ota_src_t *)ctx, offset, dst, len) == ESP_OK;
+}
+
+static bool probe_stream(const slave_ota_src_t *src, stream_info_t *info)
+{
+    uint8_t buf[FWDELTA_HEADER_LEN];    /* Larger of the two headers */
+    lzfw_header_t lz;
+    fwdelta_header_t fd;
+
+    memset(info, 0, sizeof(*info));
+    if (src->sequential || src_read(src, 0, buf, sizeof(buf)) != ESP_OK) {
+        return false;
+    }
+    if (lzfw_parse_header(buf, &lz) == LZFW_OK) {
+        info->format = "LZFW";
+        info->total_len = LZFW_HEADER_LEN + (size_t)lz.comp_len;
+        info->raw_len = lz.raw_len;
+        info->has_digest = (lz.flags & LZFW_FLAG_HAS_DIGEST) != 0;
+        memcpy(info->sha256, lz.image_sha256, 32);
+        return true;
+    }
+    if (fwdelta_parse_header(buf, &fd) == FWDELTA_OK) {
+        info->format = "delta";
+        info->total_len = FWDELTA_HEADER_LEN + (size_t)fd.ops_len;
+        info->raw_len = fd.new_len;
+        info->has_digest = (fd.flags & FWDELTA_FLAG_NEW_DIGEST) != 0;
+        memcpy(info->sha256, fd.new_sha256, 32);
+        info->has_base = (fd.flags & FWDELTA_FLAG_OLD_DIGEST) != 0;
+        memcpy(info->base_sha256, fd.old_sha256, 32);
+        return true;
+    }
+    return false;
+}
+
+esp_err_t slave_ota_image_len(const slave_ota_src_t *src, size_t *len)
+{
+    if (src->sequential) {
+        *len = src->size;
+        return ESP_OK;
+    }
+
+    stream_info_t si;
+    if (probe_stream(src, &si)) {
+        if (si.total_len > src->size) {
+            ESP_LOGW(TAG, "%s image in '%s' is truncated", si.format, src->name);
+            return ESP_ERR_NOT_FOUND;
+        }
+        ESP_LOGI(TAG, "%s image: %lu bytes on the wire for a %lu-byte image (%.1f%%)",
+                 si.format, (unsigned long)si.total_len, (unsigned long)si.raw_len,
+                 si.raw_len ? 100.0f * si.total_len / si.raw_len : 0.0f);
+        *len = si.total_len;
+        return ESP_OK;
+    }
+
+    slave_image_info_t info;
+    slave_image_err_t err = slave_image_parse(image_read, (void *)src, src->size, &info);
+    if (err != SLAVE_IMAGE_OK) {
+        ESP_LOGW(TAG, "No valid image in '%s': %s", src->name, slave_image_err_name(err));
+        return (err == SLAVE_IMAGE_ERR_READ) ? ESP_FAIL : ESP_ERR_NOT_FOUND;
+    }
+    ESP_LOGI(TAG, "Image: %u segments, %lu bytes%s%s", info.segment_count,
+             (unsigned long)info.image_len,
+             info.hash_offset ? ", SHA-256 appended" : "",
+             info.sig_offset ? ", signed" : "");
+    *len = info.image_len;
+    return ESP_OK;
+}
+
+esp_err_t slave_ota_image_sha256(const slave_ota_src_t *src, uint8_t sha256[32])
+{
+    if (src->sequential) {
+        if (!src->has_sha256) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        memcpy(sha256, src->sha256, 32);
+        return ESP_OK;
+    }
+
+    /* Compressed or delta: the tool copied the image's digest into the
+     * header; the slave checks the stream itself with CRC32 */
+    stream_info_t si;
+    if (probe_stream(src, &si)) {
+        if (!si.has_digest) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        memcpy(sha256, si.sha256, 32);
+        return ESP_OK;
+    }
+
+    slave_image_info_t info;
+    slave_image_err_t err = slave_image_parse(image_read, (void *)src, src->size, &info);
+    if (err != SLAVE_IMAGE_OK) {
+        return (err == SLAVE_IMAGE_ERR_READ) ? ESP_FAIL : ESP_ERR_NOT_FOUND;
+    }
+    size_t hashed_len = info.hash_offset ? info.hash_offset : info.image_len;
+
+    uint8_t *buf = malloc(HASH_READ_CHUNK);
+    if (!buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* mbedtls uses the SHA peripheral when CONFIG_MBEDTLS_HARDWARE_SHA=y */
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+
+    esp_err_t ret = ESP_OK;
+    if (src->data) {
+        mbedtls_sha256_update(&ctx, src->data, hashed_len);
+    } else {
+        for (size_t off = 0; off < hashed_len && ret == ESP_OK; off += HASH_READ_CHUNK) {
+            size_t len = hashed_len - off;
+            if (len > HASH_READ_CHUNK) len = HASH_READ_CHUNK;
+            ret = src_read(src, off, buf, len);
+            if (ret == ESP_OK) {
+                mbedtls_sha256_update(&ctx, buf, len);
+            }
+        }
+    }
+    mbedtls_sha256_finish(&ctx, sha256);
+    mbedtls_sha256_free(&ctx);
+
+    if (ret == ESP_OK && info.hash_offset) {
+        ret = src_read(src, info.hash_offset, buf, 32);
+        if (ret == ESP_OK && memcmp(buf, sha256, 32) != 0) {
+            ESP_LOGE(TAG, "Image digest mismatch, image is corrupt");
+            ret = ESP_ERR_INVALID_CRC;
+        }
+    }
+    free(buf);
+    return ret;
+}
+
+static bool load_rec(const char *key, void *rec, size_t size)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = size;
+    esp_err_t ret = nvs_get_blob(nvs, key, rec, &len);
+    nvs_close(nvs);
+    return ret == ESP_OK && len == size;
+}
+
+/* rec == NULL erases the key */
+static void save_rec(const char *key, const void *rec, size_t size)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(OTA_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret == ESP_OK) {
+        ret = rec ? nvs_set_blob(nvs, key, rec, size) : nvs_erase_key(nvs, key);
+        if (ret == ESP_ERR_NVS_NOT_FOUND) {
+            ret = ESP_OK;
+        }
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Saving '%s' record failed: %s", key, esp_err_to_name(ret));
+    }
+}
+
+static bool load_installed(installed_rec_t *rec)
+{
+    return load_rec(OTA_NVS_KEY, rec, sizeof(*rec)) && rec->version == OTA_NVS_VERSION;
+}
+
+static void save_installed(const installed_rec_t *rec)
+{
+    save_rec(OTA_NVS_KEY, rec, sizeof(*rec));
+}
+
+/* GET_FW_INFO, skipped once the slave is known not to answer it */
+static esp_err_t query_slave_fw(wifi_raw_slave_fw_t *fw)
+{
+    if (s_slave_ext == SLAVE_EXT_NO) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t ret = wifi_raw_init();
+    if (ret == ESP_OK) {
+        ret = wifi_raw_get_slave_fw(fw, FW_INFO_TIMEOUT_MS);
+    }
+    if (ret == ESP_OK) {
+        s_slave_ext = SLAVE_EXT_YES;
+    } else if (ret == ESP_ERR_TIMEOUT) {
+        s_slave_ext = SLAVE_EXT_NO;
+    }
+    return ret;
+}
+
+bool slave_ota_is_installed(const uint8_t sha256[32])
+{
+    /* Authoritative answer from a slave with the wifi_raw extension */
+    wifi_raw_slave_fw_t fw;
+    if (query_slave_fw(&fw) == ESP_OK) {
+        bool same = memcmp(fw.sha256, sha256, 32) == 0;
+        ESP_LOGI(TAG, "Slave runs %s %s (%s)", fw.project_name, fw.version,
+                 same ? "same image" : "different image");
+        return same;
+    }
+
+    /* Stock slave: fall back to what this host last installed */
+    installed_rec_t rec;
+    if (!load_installed(&rec)) {
+        return false;
+    }
+    esp_hosted_coprocessor_fwver_t ver = {0};
+    if (esp_hosted_get_coprocessor_fwversion(&ver) != ESP_OK) {
+        return false;
+    }
+    if (!rec.fw_valid) {
+        /* First check since our OTA: the slave now runs that image */
+        rec.fw_major = ver.major1;
+        rec.fw_minor = ver.minor1;
+        rec.fw_patch = ver.patch1;
+        rec.fw_valid = 1;
+        save_installed(&rec);
+    }
+    bool same = memcmp(rec.sha256, sha256, 32) == 0 &&
+                rec.fw_major == ver.major1 && rec.fw_minor == ver.minor1 &&
+                rec.fw_patch == ver.patch1;
+    ESP_LOGI(TAG, "Slave v%lu.%lu.%lu, recorded image %s", (unsigned long)ver.major1,
+             (unsigned long)ver.minor1, (unsigned long)ver.patch1,
+             same ? "matches" : "differs");
+    return same;
+}
+
+void slave_ota_mark_installed(const uint8_t sha256[32])
+{
+    installed_rec_t rec = { .version = OTA_NVS_VERSION };
+    memcpy(rec.sha256, sha256, sizeof(rec.sha256));
+    save_installed(&rec);
+}
+
+/* Push sources: cut the output into ring chunks as it arrives */
+static esp_err_t ring_emit(void *emit_ctx, const uint8_t *data, size_t len)
+{
+    ota_pipe_t *p = (ota_pipe_t *)emit_ctx;
+    if (len > p->image_len - p->produced) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    while (len > 0) {
+        if (p->cur_idx == CHUNK_END) {
+            xQueueReceive(p->free_q, &p->cur_idx, portMAX_DELAY);
+            p->cur_fill = 0;
+        }
+        if (p->abort) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        size_t n = p->chunk_size - p->cur_fill;
+        if (n > len) n = len;
+        memcpy(p->bufs + (size_t)p->cur_idx * p->chunk_size + p->cur_fill, data, n);
+        p->cur_fill += n;
+        p->produced += n;
+        data += n;
+        len -= n;
+        if (p->cur_fill == p->chunk_size) {
+            chunk_msg_t msg = { .idx = p->cur_idx, .len = (uint16_t)p->cur_fill };
+            xQueueSend(p->full_q, &msg, portMAX_DELAY);
+            p->cur_idx = CHUNK_END;
+        }
+    }
+    return ESP_OK;
+}
+
+static void ota_push_source(ota_pipe_t *p)
+{
+    p->cur_idx = CHUNK_END;
+    esp_err_t ret = p->src->push(p->src->ctx, ring_emit, p);
+    if (ret == ESP_OK && p->cur_idx != CHUNK_END) {
+        chunk_msg_t msg = { .idx = p->cur_idx, .len = (uint16_t)p->cur_fill };
+        xQueueSend(p->full_q, &msg, portMAX_DELAY);
+    }
+    if (ret == ESP_OK && p->produced != p->image_len) {
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    p->read_err = ret;
+}
+
+static void ota_read_source(ota_pipe_t *p)
+{
+    for (size_t offset = p->start; offset < p->image_len && !p->abort; offset += p->chunk_size) {
+        uint8_t idx;
+        xQueueReceive(p->free_q, &idx, portMAX_DELAY);
+        if (p->abort) break;
+
+        size_t len = p->image_len - offset;
+        if (len > p->chunk_size) len = p->chunk_size;
+        uint8_t *buf = p->bufs + (size_t)idx * p->chunk_size;
+
+        esp_err_t ret = src_read(p->src, offset, buf, len);
+        if (ret != ESP_OK) {
+            p->read_err = ret;
+            break;
+        }
+
+        chunk_msg_t msg = { .idx = idx, .len = (uint16_t)len };
+        xQueueSend(p->full_q, &msg, portMAX_DELAY);
+    }
+}
+
+static void ota_reader_task(void *arg)
+{
+    ota_pipe_t *p = (ota_pipe_t *)arg;
+
+    if (p->src->push) {
+        ota_push_source(p);
+    } else {
+        ota_read_source(p);
+    }
+
+    chunk_msg_t end = { .idx = CHUNK_END, .len = 0 };
+    xQueueSend(p->full_q, &end, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+/* Writer-side state of one transfer */
+typedef struct {
+    const ota_sink_t *sink;
+    slave_ota_stats_t *st;
+    uint32_t max_retries;
+    uint32_t checkpoint_len;
+    resume_rec_t resume;                    /* version 0 unless resumable */
+} ota_run_t;
+
+static esp_err_t stream_crc32(const slave_ota_src_t *src, size_t len, uint32_t *crc)
+{
+    if (src->data) {
+        *crc = lzfw_crc32(0, src->data, len);
+        return ESP_OK;
+    }
+
+    uint8_t *buf = malloc(HASH_READ_CHUNK);
+    if (!buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = ESP_OK;
+    uint32_t c = 0;
+    for (size_t off = 0; off < len && ret == ESP_OK; off += HASH_READ_CHUNK) {
+        size_t n = len - off;
+        if (n > HASH_READ_CHUNK) n = HASH_READ_CHUNK;
+        ret = src_read(src, off, buf, n);
+        if (ret == ESP_OK) {
+            c = lzfw_crc32(c, buf, n);
+        }
+    }
+    free(buf);
+    *crc = c;
+    return ret;
+}
+
+/*
+ * Offer a resumable session to the slave. False for slaves without
+ * OTA_Z_RESUME; otherwise the session is keyed and st->resumed_from is
+ * where the slave continues (0 for a fresh transfer).
+ */
+static bool resume_probe(const slave_ota_src_t *src, ota_run_t *run, ota_session_t *sess)
+{
+    /* Known stock slave: no CRC pass over the image, no RESUME timeout */
+    if (src->sequential || s_slave_ext == SLAVE_EXT_NO || wifi_raw_init() != ESP_OK ||
+        stream_crc32(src, sess->total_len, &sess->stream_crc32) != ESP_OK) {
+        return false;
+    }
+    sess->checkpoint_len = run->checkpoint_len;
+
+    resume_rec_t rec;
+    uint32_t offset = 0;
+    if (load_rec(OTA_NVS_RESUME_KEY, &rec, sizeof(rec)) && rec.version == OTA_RESUME_VERSION &&
+        rec.total_len == sess->total_len && rec.stream_crc32 == sess->stream_crc32) {
+        offset = rec.offset;
+    }
+
+    esp_err_t ret = wifi_raw_ota_z_resume(sess->total_len, sess->stream_crc32,
+                                          &offset, FW_INFO_TIMEOUT_MS);
+    if (ret == ESP_ERR_TIMEOUT) {
+        ESP_LOGI(TAG, "Slave has no resumable OTA, failed chunks cannot be retried");
+        if (s_slave_ext == SLAVE_EXT_UNKNOWN) {
+            s_slave_ext = SLAVE_EXT_NO;
+        }
+        return false;
+    }
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "OTA resume query failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    run->resume = (resume_rec_t) {
+        .version = OTA_RESUME_VERSION,
+        .total_len = sess->total_len,
+        .stream_crc32 = sess->stream_crc32,
+        .offset = (ret == ESP_OK) ? offset : 0,
+    };
+    run->st->resumed_from = run->resume.offset;
+    return true;
+}
+
+static esp_err_t write_chunk(ota_run_t *run, const uint8_t *data, size_t len)
+{
+    slave_ota_stats_t *st = run->st;
+    size_t offset = st->resumed_from + st->bytes_sent;
+
+    esp_err_t ret;
+    for (uint32_t attempt = 0; ; attempt++) {
+        ret = run->sink->write(offset, data, len);
+        if (ret == ESP_OK || !run->sink->retry || attempt == run->max_retries) {
+            break;
+        }
+        st->retries++;
+        ESP_LOGW(TAG, "OTA write at offset %u failed (%s), retry %lu/%lu",
+                 (unsigned)offset, esp_err_to_name(ret),
+                 (unsigned long)attempt + 1, (unsigned long)run->max_retries);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "OTA write failed at offset %u: %s",
+                 (unsigned)offset, esp_err_to_name(ret));
+        return ret;
+    }
+    st->bytes_sent += len;
+    st->chunks++;
+
+    /* The slave has persisted its state at every boundary it crossed */
+    if (run->resume.version) {
+        uint32_t ckpt = (offset + len) / run->checkpoint_len * run->checkpoint_len;
+        if (ckpt > run->resume.offset) {
+            run->resume.offset = ckpt;
+            save_rec(OTA_NVS_RESUME_KEY, &run->resume, sizeof(run->resume));
+        }
+    }
+
+    if ((st->chunks % 100) == 0) {
+        ESP_LOGI(TAG, "OTA progress: %lu bytes sent...", (unsigned long)(offset + len));
+    }
+    return ESP_OK;
+}
+
+esp_err_t slave_ota_transfer(const slave_ota_src_t *src,
+                             const slave_ota_config_t *cfg,
+                             slave_ota_stats_t *stats)
+{
+    slave_ota_stats_t st = { .zero_copy = src->data != NULL };
+    ota_pipe_t p = {
+        .src = src,
+        .chunk_size = (cfg && cfg->chunk_size) ? cfg->chunk_size : SLAVE_OTA_DEFAULT_CHUNK,
+    };
+    ota_run_t run = {
+        .st = &st,
+        .max_retries = cfg ? cfg->max_retries : SLAVE_OTA_DEFAULT_RETRIES,
+        .checkpoint_len = (cfg && cfg->checkpoint_len) ? cfg->checkpoint_len
+                                                       : SLAVE_OTA_DEFAULT_CHECKPOINT,
+    };
+    size_t depth = (cfg && cfg->ring_depth) ? cfg->ring_depth : SLAVE_OTA_DEFAULT_DEPTH;
+    if (depth >= CHUNK_END || p.chunk_size > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = slave_ota_image_len(src, &p.image_len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    stream_info_t si;
+    bool streamed = probe_stream(src, &si);
+    st.raw_len = streamed ? si.raw_len : p.image_len;
+
+    /* A patch only applies to the image it was made against */
+    wifi_raw_slave_fw_t fw;
+    if (streamed && si.has_base && query_slave_fw(&fw) == ESP_OK &&
+        memcmp(fw.sha256, si.base_sha256, 32) != 0) {
+        ESP_LOGE(TAG, "Delta was built against a different image than the slave runs (%s %s)",
+                 fw.project_name, fw.version);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    ota_session_t sess = { .total_len = p.image_len };
+    if (resume_probe(src, &run, &sess)) {
+        run.sink = &s_acked_sink;
+        p.start = st.resumed_from;
+    } else {
+        run.sink = streamed ? &s_stream_sink : &s_raw_sink;
+    }
+    const ota_sink_t *sink = run.sink;
+    st.ota_z = sink != &s_raw_sink;
+
+    if (!st.zero_copy) {
+        p.bufs = malloc(depth * p.chunk_size);
+        p.free_q = xQueueCreate(depth, sizeof(uint8_t));
+        p.full_q = xQueueCreate(depth + 1, sizeof(chunk_msg_t));
+        if (!p.bufs || !p.free_q || !p.full_q) {
+            ESP_LOGE(TAG, "Pipeline allocation failed");
+            ret = ESP_ERR_NO_MEM;
+            goto cleanup;
+        }
+        for (size_t i = 0; i < depth; i++) {
+            uint8_t idx = (uint8_t)i;
+            xQueueSend(p.free_q, &idx, 0);
+        }
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    if (st.resumed_from) {
+        ESP_LOGI(TAG, "Resuming interrupted OTA at checkpoint %lu of %lu bytes",
+                 (unsigned long)st.resumed_from, (unsigned long)p.image_len);
+    } else {
+        ret = sink->begin(&sess);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "OTA begin failed: %s", esp_err_to_name(ret));
+            goto cleanup;
+        }
+        if (run.resume.version) {
+            save_rec(OTA_NVS_RESUME_KEY, &run.resume, sizeof(run.resume));
+        }
+    }
+
+    if (st.zero_copy) {
+        /* Writes point straight into the mapping; no buffers, no reader */
+        ESP_LOGI(TAG, "Streaming %s image from '%s' via %s, %lu-byte chunks, zero-copy",
+                 streamed ? si.format : "ESP", src->name, sink->name, (unsigned long)p.chunk_size);
+        for (size_t off = p.start; off < p.image_len && ret == ESP_OK; off += p.chunk_size) {
+            size_t len = p.image_len - off;
+            if (len > p.chunk_size) len = p.chunk_size;
+            ret = write_chunk(&run, src->data + off, len);
+        }
+    } else {
+        ESP_LOGI(TAG, "Streaming %s image from '%s' via %s, %lu-byte chunks, %u buffers in flight",
+                 streamed ? si.format : "ESP", src->name, sink->name,
+                 (unsigned long)p.chunk_size, (unsigned)depth);
+        /* Same core, higher priority: the reader runs while the writer blocks on
+         * the RPC, and has fully exited once the writer sees the end marker */
+        if (xTaskCreatePinnedToCore(ota_reader_task, "ota_rd", READER_STACK, &p,
+                                    READER_PRIORITY, NULL, xPortGetCoreID()) != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+            sink->end();
+            goto cleanup;
+        }
+
+        /* Writer: drain until the reader's end marker, even after an error */
+        for (;;) {
+            chunk_msg_t msg;
+            if (xQueueReceive(p.full_q, &msg, 0) != pdTRUE) {
+                st.writer_stalls++;
+                xQueueReceive(p.full_q, &msg, portMAX_DELAY);
+            }
+            if (msg.idx == CHUNK_END) break;
+
+            if (ret == ESP_OK) {
+                ret = write_chunk(&run, p.bufs + (size_t)msg.idx * p.chunk_size, msg.len);
+                if (ret != ESP_OK) {
+                    p.abort = true;
+                }
+            }
+            xQueueSend(p.free_q, &msg.idx, portMAX_DELAY);
+        }
+
+        if (ret == ESP_OK && p.read_err != ESP_OK) {
+            ESP_LOGE(TAG, "Source read failed: %s", esp_err_to_name(p.read_err));
+            ret = p.read_err;
+        }
+    }
+
+    if (ret != ESP_OK && run.resume.version) {
+        /* Leave the session open on the slave; the next attempt resumes it */
+        ESP_LOGW(TAG, "OTA interrupted, will resume from offset %lu",
+                 (unsigned long)run.resume.offset);
+        goto cleanup;
+    }
+
+    esp_err_t end_ret = sink->end();
+    if (ret == ESP_OK && end_ret != ESP_OK) {
+        ESP_LOGE(TAG, "OTA end failed: %s", esp_err_to_name(end_ret));
+        ret = end_ret;
+    }
+    if (run.resume.version) {
+        /* Done either way: a stream the slave rejected is not resumed */
+        save_rec(OTA_NVS_RESUME_KEY, NULL, 0);
+    }
+
+    st.elapsed_us = esp_timer_get_time() - t0;
+    if (ret == ESP_OK) {
+        float secs = st.elapsed_us / 1000000.0f;
+        ESP_LOGI(TAG, "OTA transfer: %lu bytes in %.2f s (%.1f KB/s, %lu chunks, "
+                 "%lu writer stalls, %lu retries)",
+                 (unsigned long)st.bytes_sent, secs,
+                 secs > 0 ? st.bytes_sent / 1024.0f / secs : 0.0f,
+                 (unsigned long)st.chunks, (unsigned long)st.writer_stalls,
+                 (unsigned long)st.retries);
+        if (st.raw_len != st.bytes_sent && !st.resumed_from) {
+            ESP_LOGI(TAG, "Effective image rate: %.1f KB/s (%lu bytes rebuilt on slave)",
+                     secs > 0 ? st.raw_len / 1024.0f / secs : 0.0f, (unsigned long)st.raw_len);
+        }
+    }
+
+cleanup:
+    if (p.free_q) vQueueDelete(p.free_q);
+    if (p.full_q) vQueueDelete(p.full_q);
+    free(p.bufs);
+    if (stats) *stats = st;
+    return ret;
+}
+
+esp_err_t slave_ota_activate(const slave_ota_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return stats->ota_z ? wifi_raw_ota_z_activate() : esp_hosted_slave_ota_activate();
+}
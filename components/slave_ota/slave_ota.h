@@ -0,0 +1,273 @@
+/*
+ * Slave OTA - transfer of C6 firmware from any image source
+ *
+ * The image comes from a slave_ota_src_t: firmware embedded in the app,
+ * a flash partition, an LZFW image decompressed on the host, or a
+ * caller-supplied reader. Addressable sources (embedded, or a partition
+ * that could be memory-mapped) are sent zero-copy, straight from the
+ * mapped address. Otherwise a reader task fills a ring of chunk buffers
+ * while the calling task streams filled chunks to the slave, so reads
+ * (or decompression) overlap SDIO transfers.
+ */
+
+#ifndef SLAVE_OTA_H
+#define SLAVE_OTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default bytes per esp_hosted_slave_ota_write() call */
+#define SLAVE_OTA_DEFAULT_CHUNK     1400
+/** Default number of chunk buffers between reader and writer */
+#define SLAVE_OTA_DEFAULT_DEPTH     4
+/** Default resends of a failed chunk (resumable slaves only) */
+#define SLAVE_OTA_DEFAULT_RETRIES   3
+/** Default stream bytes between resume checkpoints */
+#define SLAVE_OTA_DEFAULT_CHECKPOINT (64 * 1024)
+
+/**
+ * @brief Read callback of a source
+ *
+ * @param ctx Source context
+ * @param offset Byte offset into the source
+ * @param dst Destination buffer
+ * @param len Bytes to read
+ * @return ESP_OK or an error, which aborts the transfer
+ */
+typedef esp_err_t (*slave_ota_read_fn)(void *ctx, size_t offset, void *dst, size_t len);
+
+/**
+ * @brief Receives the bytes a push source produces, in order
+ *
+ * Blocks while the chunk ring is full.
+ *
+ * @return ESP_OK, or an error the push callback must return with
+ */
+typedef esp_err_t (*slave_ota_emit_fn)(void *emit_ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Push callback of a source that produces its bytes itself
+ *
+ * Called once, from the reader task, to produce the whole image.
+ *
+ * @param ctx Source context
+ * @param emit Call with each piece of output
+ * @param emit_ctx Passed to emit
+ * @return ESP_OK or an error, which aborts the transfer
+ */
+typedef esp_err_t (*slave_ota_push_fn)(void *ctx, slave_ota_emit_fn emit, void *emit_ctx);
+
+/**
+ * @brief Where the image comes from
+ *
+ * Fill with one of the slave_ota_src_*() constructors. A source with
+ * data != NULL is read in place; otherwise read() is called.
+ */
+typedef struct {
+    const uint8_t *data;                /**< Whole source addressable in place, or NULL */
+    size_t size;                        /**< Source size; exact image length if sequential */
+    bool sequential;                    /**< read() only moves forward from offset 0 */
+    slave_ota_read_fn read;             /**< Used when data is NULL */
+    slave_ota_push_fn push;             /**< Used instead of read() if set (sequential) */
+    void *ctx;                          /**< Passed to read() / push() */
+    const char *name;                   /**< For log messages */
+    bool has_sha256;                    /**< sha256 known up front (sequential sources) */
+    uint8_t sha256[32];                 /**< Digest the image will have on the slave */
+    esp_partition_mmap_handle_t map;    /**< Partition mapping (internal) */
+    bool mapped;                        /**< map is valid (internal) */
+    void (*release)(void *ctx);         /**< Frees ctx on close (internal) */
+} slave_ota_src_t;
+
+/**
+ * @brief Transfer tuning
+ */
+typedef struct {
+    size_t chunk_size;      /**< Bytes per OTA write (0 = SLAVE_OTA_DEFAULT_CHUNK) */
+    size_t ring_depth;      /**< Buffers in flight (0 = SLAVE_OTA_DEFAULT_DEPTH), unused when zero-copy */
+    uint32_t max_retries;   /**< Resends of a failed chunk, 0 = none (SLAVE_OTA_DEFAULT_RETRIES without cfg) */
+    uint32_t checkpoint_len; /**< Bytes between resume checkpoints (0 = SLAVE_OTA_DEFAULT_CHECKPOINT) */
+} slave_ota_config_t;
+
+/**
+ * @brief Transfer result
+ */
+typedef struct {
+    size_t bytes_sent;      /**< Bytes written to the slave in this run */
+    size_t resumed_from;    /**< Stream offset this run started at (0 unless resumed) */
+    size_t raw_len;         /**< Size of the image the slave ends up with */
+    uint32_t chunks;        /**< OTA write calls */
+    int64_t elapsed_us;     /**< begin() to end() wall time */
+    uint32_t writer_stalls; /**< Times the writer waited for the reader */
+    uint32_t retries;       /**< Chunks resent after a failed or mismatched ack */
+    bool zero_copy;         /**< Sent in place, without the reader ring */
+    bool ota_z;             /**< Sent over wifi_raw OTA_Z_*, not the esp-hosted OTA */
+} slave_ota_stats_t;
+
+/**
+ * @brief Source over memory, e.g. a binary linked in with EMBED_FILES
+ *
+ * @param src Source to fill
+ * @param data Image bytes, must stay valid while the source is used
+ * @param size Bytes at data (may exceed the image)
+ */
+void slave_ota_src_memory(slave_ota_src_t *src, const void *data, size_t size);
+
+/**
+ * @brief Source over a flash partition
+ *
+ * Memory-maps the whole partition so chunks are sent from the
+ * cache-mapped address. If no MMU pages are free for the mapping, falls
+ * back to esp_partition_read() into the reader ring.
+ *
+ * @param src Source to fill, release with slave_ota_src_close()
+ * @param part Partition holding the image at offset 0
+ * @return ESP_OK (mapped or not), ESP_ERR_INVALID_ARG
+ */
+esp_err_t slave_ota_src_partition(slave_ota_src_t *src, const esp_partition_t *part);
+
+/**
+ * @brief Source over a caller-supplied reader (network, SD card, ...)
+ *
+ * A sequential source cannot be probed ahead of the transfer: it is sent
+ * as a plain ESP image of exactly size bytes, and
+ * slave_ota_image_sha256() is not available.
+ *
+ * @param src Source to fill
+ * @param read Read callback
+ * @param ctx Passed to read
+ * @param size Source size (exact image length if sequential)
+ * @param sequential true if read() cannot seek back
+ */
+void slave_ota_src_reader(slave_ota_src_t *src, slave_ota_read_fn read, void *ctx,
+                          size_t size, bool sequential);
+
+/**
+ * @brief Source that decompresses an LZFW image on the host
+ *
+ * For slaves that only take plain images over the esp-hosted OTA: the
+ * reader task decodes into the chunk ring while the previous chunks
+ * are being written, and only the decoder's history window (8 KB for
+ * the default window_bits) is allocated. The image digest stored in
+ * the LZFW header is reported by slave_ota_image_sha256(), and the
+ * decoder checks the output CRC32 before the transfer is finished.
+ *
+ * @param src Source to fill, release with slave_ota_src_close()
+ * @param data LZFW stream, must stay valid while the source is used
+ * @param size Bytes at data
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if data is not a complete LZFW
+ *         stream, ESP_ERR_NO_MEM
+ */
+esp_err_t slave_ota_src_lzfw(slave_ota_src_t *src, const void *data, size_t size);
+
+/**
+ * @brief Release a source (unmaps a mapped partition, frees a decoder)
+ *
+ * @param src Source from a slave_ota_src_*() constructor
+ */
+void slave_ota_src_close(slave_ota_src_t *src);
+
+/**
+ * @brief Exact length of the image at the start of a source
+ *
+ * For an ESP image, parsed from the image and segment headers, including
+ * the appended SHA-256 and any Secure Boot v2 signature sector. For an
+ * LZFW image or delta patch, the stream length including its header.
+ * For a sequential source, its size.
+ *
+ * @param src Source to inspect
+ * @param len Image length on success
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if no valid image, ESP_FAIL on read error
+ */
+esp_err_t slave_ota_image_len(const slave_ota_src_t *src, size_t *len);
+
+/**
+ * @brief SHA-256 of the image in a source
+ *
+ * Hashes the image up to its appended digest, which is the value
+ * esp_partition_get_sha256() reports for the app once it runs on the
+ * slave. If the image carries a digest it must match. For an LZFW image
+ * or delta patch, the digest of the resulting image stored in its header
+ * is returned.
+ *
+ * @param src Source holding the image
+ * @param sha256 32-byte result
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if no valid image,
+ *         ESP_ERR_INVALID_CRC if the appended digest does not match,
+ *         ESP_ERR_NOT_SUPPORTED for a sequential source without a
+ *         known digest or an LZFW/delta stream without a digest
+ */
+esp_err_t slave_ota_image_sha256(const slave_ota_src_t *src, uint8_t sha256[32]);
+
+/**
+ * @brief Check whether the slave already runs this image
+ *
+ * Asks the slave for its app hash over CustomRpc. Slaves without the
+ * wifi_raw extension do not answer; after that first timeout they are
+ * not asked again, nor offered a resumable transfer. Then the hash
+ * recorded by slave_ota_mark_installed() is used, provided the slave's
+ * esp-hosted version has not changed since (i.e. it was not reflashed
+ * by other means).
+ *
+ * @param sha256 Hash of the candidate image
+ * @return true if the OTA can be skipped
+ */
+bool slave_ota_is_installed(const uint8_t sha256[32]);
+
+/**
+ * @brief Record an image as installed after a successful OTA
+ *
+ * @param sha256 Hash of the image that was activated
+ */
+void slave_ota_mark_installed(const uint8_t sha256[32]);
+
+/**
+ * @brief Stream the firmware image in a source to the slave
+ *
+ * Sends exactly slave_ota_image_len() bytes: runs
+ * esp_hosted_slave_ota_begin(), the zero-copy or pipelined writes and
+ * esp_hosted_slave_ota_end(), or the wifi_raw OTA_Z_* equivalents for an
+ * LZFW image or delta patch. A patch is refused if the slave reports a
+ * running image other than the one it was built against. Activate the
+ * result with slave_ota_activate().
+ *
+ * If the slave supports resumable OTA, every image goes over OTA_Z with
+ * per-chunk CRC32 acks: a failed chunk is resent up to max_retries
+ * times, and the acknowledged offset is checkpointed in NVS. A transfer
+ * that still fails leaves the session open, and the next call for the
+ * same image continues from the last checkpoint.
+ *
+ * @param src Source holding the image at offset 0
+ * @param cfg Tuning (NULL for defaults)
+ * @param stats Filled on return (may be NULL)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if no valid image,
+ *         ESP_ERR_INVALID_VERSION if a patch does not match the slave,
+ *         or the first error from read/begin/write/end
+ */
+esp_err_t slave_ota_transfer(const slave_ota_src_t *src,
+                             const slave_ota_config_t *cfg,
+                             slave_ota_stats_t *stats);
+
+/**
+ * @brief Restart the slave into the image a transfer installed
+ *
+ * Uses OTA_Z_ACTIVATE for a transfer that went over OTA_Z (the esp-hosted
+ * session was never opened for it), esp_hosted_slave_ota_activate()
+ * otherwise.
+ *
+ * @param stats Result of the successful slave_ota_transfer()
+ * @return ESP_OK once the slave is about to restart, or the error
+ */
+esp_err_t slave_ota_activate(const slave_ota_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLAVE_OTA_H */
@@ -0,0 +1,806 @@
+/*
+ * WiFi Raw - Host-side implementation
+ *
+ * Sends commands to ESP32-C6 slave via CustomRpc and receives
+ * promiscuous packet events and command responses.
+ *
+ * Async commands wait in a small pending table instead of on the event
+ * group. The slave handles commands in order, so a response completes
+ * the oldest pending command with its message ID; a sweep timer, armed
+ * only while commands are pending, fails the ones that get no response
+ * in time.
+ *
+ * The RX and echo callbacks are loaded once per event and counted as
+ * running while called, so registering a new one (or NULL) can wait
+ * until a call of the old one has returned.
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_hosted_misc.h"
+#include "wifi_raw.h"
+#include "wifi_raw_msgs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+
+static const char *TAG = "wifi_raw";
+
+/* ─── Response synchronization ─── */
+static EventGroupHandle_t s_resp_event;
+#define RESP_RECEIVED_BIT  BIT0
+#define FW_INFO_BIT        BIT1
+#define OTA_ACK_BIT        BIT2
+
+static wifi_raw_cmd_response_t s_last_response;
+static wifi_raw_fw_info_t s_fw_info;
+static wifi_raw_ota_z_ack_t s_ota_ack;
+static wifi_raw_rx_cb_t s_rx_cb = NULL;
+static wifi_raw_echo_cb_t s_echo_cb = NULL;
+static uint32_t s_rx_cb_busy;               /* Calls in progress, under s_cb_lock */
+static uint32_t s_echo_cb_busy;
+static portMUX_TYPE s_cb_lock = portMUX_INITIALIZER_UNLOCKED;
+static wifi_raw_state_t s_state = {          /* Under s_async_lock; slave boots with promiscuous off */
+    .filter_set = false,
+    .tx_rate = WIFI_RAW_TX_RATE_DEFAULT,
+};
+
+/* ─── Async command table ─── */
+#define ASYNC_TIMEOUT_US    (5000 * 1000)
+#define ASYNC_SWEEP_US      (100 * 1000)
+
+typedef struct {
+    uint16_t msg_id;        /* 0 = free slot */
+    uint32_t order;         /* Send order, oldest completes first */
+    uint32_t arg;           /* Setting recorded in s_state on success */
+    int64_t deadline;
+    wifi_raw_done_cb_t cb;
+    void *ctx;
+} async_cmd_t;
+
+static async_cmd_t s_async[WIFI_RAW_ASYNC_MAX_PENDING];
+static uint32_t s_async_order;
+static portMUX_TYPE s_async_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t s_async_sweep;    /* One-shot, armed while commands are pending */
+static bool s_async_sweep_armed;            /* Under s_async_lock */
+
+/* Record a setting the slave accepted; runs on the RX task for async commands */
+static void apply_state(uint16_t msg_id, uint32_t arg)
+{
+    portENTER_CRITICAL(&s_async_lock);
+    switch (msg_id) {
+    case WIFI_RAW_MSG_SET_PROMISCUOUS:
+        s_state.promiscuous = arg != 0;
+        break;
+    case WIFI_RAW_MSG_SET_CHANNEL:
+        s_state.primary = arg & 0xFF;
+        s_state.second = (arg >> 8) & 0xFF;
+        break;
+    case WIFI_RAW_MSG_SET_FILTER:
+        s_state.filter_mask = arg;
+        s_state.filter_set = true;
+        break;
+    case WIFI_RAW_MSG_SET_TX_RATE:
+        s_state.tx_rate = arg & 0xFF;
+        break;
+    }
+    portEXIT_CRITICAL(&s_async_lock);
+}
+
+static bool async_complete(uint16_t msg_id, esp_err_t status)
+{
+    async_cmd_t done = { 0 };
+    portENTER_CRITICAL(&s_async_lock);
+    async_cmd_t *oldest = NULL;
+    for (int i = 0; i < WIFI_RAW_ASYNC_MAX_PENDING; i++) {
+        async_cmd_t *c = &s_async[i];
+        if (c->msg_id == msg_id && (!oldest || (int32_t)(c->order - oldest->order) < 0)) {
+            oldest = c;
+        }
+    }
+    if (oldest) {
+        done = *oldest;
+        oldest->msg_id = 0;
+    }
+    portEXIT_CRITICAL(&s_async_lock);
+
+    if (!done.msg_id) {
+        return false;
+    }
+    if (status == ESP_OK) {
+        apply_state(done.msg_id, done.arg);
+    }
+    if (done.cb) {
+        done.cb(status, done.ctx);
+    }
+    return true;
+}
+
+static void async_sweep(void *arg)
+{
+    async_cmd_t expired[WIFI_RAW_ASYNC_MAX_PENDING];
+    int n = 0;
+    int64_t now = esp_timer_get_time();
+    bool pending = false;
+
+    /* Re-arm while anything is left; once the table is empty the timer
+     * stays off until async_send() queues the next command */
+    portENTER_CRITICAL(&s_async_lock);
+    for (int i = 0; i < WIFI_RAW_ASYNC_MAX_PENDING; i++) {
+        if (s_async[i].msg_id && now >= s_async[i].deadline) {
+            expired[n++] = s_async[i];
+            s_async[i].msg_id = 0;
+        } else if (s_async[i].msg_id) {
+            pending = true;
+        }
+    }
+    s_async_sweep_armed = pending;
+    portEXIT_CRITICAL(&s_async_lock);
+
+    if (pending) {
+        esp_err_t ret = esp_timer_start_once(s_async_sweep, ASYNC_SWEEP_US);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Re-arm async timeout sweep: %s", esp_err_to_name(ret));
+            portENTER_CRITICAL(&s_async_lock);
+            s_async_sweep_armed = false;
+            portEXIT_CRITICAL(&s_async_lock);
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        ESP_LOGE(TAG, "Command 0x%04x: timeout", expired[i].msg_id);
+        if (expired[i].cb) {
+            expired[i].cb(ESP_ERR_TIMEOUT, expired[i].ctx);
+        }
+    }
+}
+
+static esp_err_t async_send(uint16_t msg_id, uint32_t arg, const uint8_t *data, size_t len,
+                            wifi_raw_done_cb_t cb, void *ctx)
+{
+    if (!s_async_sweep) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* Claim the slot first: the response can beat the send call back */
+    async_cmd_t *slot = NULL;
+    uint32_t order = 0;
+    bool arm = false;
+    portENTER_CRITICAL(&s_async_lock);
+    for (int i = 0; i < WIFI_RAW_ASYNC_MAX_PENDING && !slot; i++) {
+        if (s_async[i].msg_id == 0) {
+            slot = &s_async[i];
+            order = s_async_order++;
+            *slot = (async_cmd_t) {
+                .msg_id = msg_id,
+                .order = order,
+                .arg = arg,
+                .deadline = esp_timer_get_time() + ASYNC_TIMEOUT_US,
+                .cb = cb,
+                .ctx = ctx,
+            };
+        }
+    }
+    if (slot && !s_async_sweep_armed) {
+        s_async_sweep_armed = arm = true;
+    }
+    portEXIT_CRITICAL(&s_async_lock);
+    if (!slot) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (arm) {
+        ret = esp_timer_start_once(s_async_sweep, ASYNC_SWEEP_US);
+        if (ret != ESP_OK) {
+            portENTER_CRITICAL(&s_async_lock);
+            s_async_sweep_armed = false;
+            portEXIT_CRITICAL(&s_async_lock);
+        }
+    }
+    if (ret == ESP_OK) {
+        ret = esp_hosted_send_custom_data(msg_id, data, len);
+    }
+    if (ret != ESP_OK) {
+        portENTER_CRITICAL(&s_async_lock);
+        if (slot->msg_id == msg_id && slot->order == order) {
+            slot->msg_id = 0;
+        }
+        portEXIT_CRITICAL(&s_async_lock);
+    }
+    return ret;
+}
+
+/* ─── CustomRpc Callbacks ─── */
+
+static void on_cmd_response(uint32_t msg_id, const uint8_t *data, size_t data_len)
+{
+    if (data_len >= sizeof(wifi_raw_cmd_response_t)) {
+        wifi_raw_cmd_response_t resp;
+        memcpy(&resp, data, sizeof(resp));
+        if (async_complete(resp.cmd_msg_id, (esp_err_t)resp.status)) {
+            return;
+        }
+        s_last_response = resp;
+        xEventGroupSetBits(s_resp_event, RESP_RECEIVED_BIT);
+    }
+}
+
+static void on_fw_info(uint32_t msg_id, const uint8_t *data, size_t data_len)
+{
+    if (data_len >= sizeof(wifi_raw_fw_info_t)) {
+        memcpy(&s_fw_info, data, sizeof(wifi_raw_fw_info_t));
+        xEventGroupSetBits(s_resp_event, FW_INFO_BIT);
+    }
+}
+
+static void on_ota_ack(uint32_t msg_id, const uint8_t *data, size_t data_len)
+{
+    if (data_len >= sizeof(wifi_raw_ota_z_ack_t)) {
+        memcpy(&s_ota_ack, data, sizeof(wifi_raw_ota_z_ack_t));
+        xEventGroupSetBits(s_resp_event, OTA_ACK_BIT);
+    }
+}
+
+static void cb_exit(uint32_t *busy)
+{
+    portENTER_CRITICAL(&s_cb_lock);
+    (*busy)--;
+    portEXIT_CRITICAL(&s_cb_lock);
+}
+
+/* After a callback swap: wait out calls that loaded the old one */
+static void cb_wait_idle(uint32_t *busy)
+{
+    for (;;) {
+        portENTER_CRITICAL(&s_cb_lock);
+        uint32_t n = *busy;
+        portEXIT_CRITICAL(&s_cb_lock);
+        if (n == 0) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+}
+
+static void on_echo_reply(uint32_t msg_id, const uint8_t *data, size_t data_len)
+{
+    int64_t now = esp_timer_get_time();
+    if (data_len < sizeof(wifi_raw_echo_reply_t)) {
+        return;
+    }
+
+    const wifi_raw_echo_reply_t *rep = (const wifi_raw_echo_reply_t *)data;
+    if (data_len < sizeof(wifi_raw_echo_reply_t) + rep->data_len) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_cb_lock);
+    wifi_raw_echo_cb_t cb = s_echo_cb;
+    if (cb) {
+        s_echo_cb_busy++;
+    }
+    portEXIT_CRITICAL(&s_cb_lock);
+    if (!cb) {
+        return;
+    }
+
+    wifi_raw_echo_t echo = {
+        .seq = rep->seq,
+        .host_tx_us = rep->host_tx_us,
+        .slave_rx_us = rep->slave_rx_us,
+        .slave_tx_us = rep->slave_tx_us,
+        .host_rx_us = now,
+        .data = rep->data,
+        .data_len = rep->data_len,
+    };
+
+    cb(&echo);
+    cb_exit(&s_echo_cb_busy);
+}
+
+static void on_promisc_pkt(uint32_t msg_id, const uint8_t *data, size_t data_len)
+{
+    if (data_len < sizeof(wifi_raw_promisc_pkt_t)) {
+        return;
+    }
+
+    const wifi_raw_promisc_pkt_t *pkt = (const wifi_raw_promisc_pkt_t *)data;
+
+    if (data_len < sizeof(wifi_raw_promisc_pkt_t) + pkt->data_len) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_cb_lock);
+    wifi_raw_rx_cb_t cb = s_rx_cb;
+    if (cb) {
+        s_rx_cb_busy++;
+    }
+    portEXIT_CRITICAL(&s_cb_lock);
+    if (!cb) {
+        return;
+    }
+
+    wifi_raw_rx_pkt_t rx = {
+        .type = pkt->type,
+        .rssi = pkt->rssi,
+        .channel = pkt->channel,
+        .rate = pkt->rate,
+        .sig_mode = pkt->sig_mode,
+        .rx_state = pkt->rx_state,
+        .payload = pkt->data,
+        .payload_len = pkt->data_len,
+    };
+
+    cb(&rx);
+    cb_exit(&s_rx_cb_busy);
+}
+
+/* ─── Wait for command response ─── */
+
+static esp_err_t wait_cmd_response(uint16_t expected_cmd, TickType_t timeout)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_resp_event, RESP_RECEIVED_BIT,
+                                            pdTRUE, pdTRUE, timeout);
+    if (!(bits & RESP_RECEIVED_BIT)) {
+        ESP_LOGE(TAG, "Command 0x%04x: timeout", expected_cmd);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    if (s_last_response.cmd_msg_id != expected_cmd) {
+        ESP_LOGW(TAG, "Response mismatch: expected 0x%04x got 0x%04x",
+                 expected_cmd, s_last_response.cmd_msg_id);
+    }
+
+    return (esp_err_t)s_last_response.status;
+}
+
+static esp_err_t wait_ota_ack(uint16_t expected_cmd, TickType_t timeout)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_resp_event, OTA_ACK_BIT,
+                                            pdTRUE, pdTRUE, timeout);
+    if (!(bits & OTA_ACK_BIT)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (s_ota_ack.cmd_msg_id != expected_cmd) {
+        ESP_LOGW(TAG, "OTA ack mismatch: expected 0x%04x got 0x%04x",
+                 expected_cmd, s_ota_ack.cmd_msg_id);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return (esp_err_t)s_ota_ack.status;
+}
+
+/* ─── Public API ─── */
+
+esp_err_t wifi_raw_init(void)
+{
+    if (s_resp_event) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Initializing WiFi raw packet system");
+
+    s_resp_event = xEventGroupCreate();
+    if (!s_resp_event) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret;
+
+    ret = esp_hosted_register_custom_callback(WIFI_RAW_MSG_CMD_RESPONSE, on_cmd_response);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register CMD_RESPONSE callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_hosted_register_custom_callback(WIFI_RAW_MSG_FW_INFO, on_fw_info);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register FW_INFO callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_hosted_register_custom_callback(WIFI_RAW_MSG_OTA_Z_ACK, on_ota_ack);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register OTA_Z_ACK callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_hosted_register_custom_callback(WIFI_RAW_MSG_ECHO_REPLY, on_echo_reply);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register ECHO_REPLY callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_hosted_register_custom_callback(WIFI_RAW_MSG_PROMISC_PKT, on_promisc_pkt);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register PROMISC_PKT callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    const esp_timer_create_args_t sweep_args = {
+        .callback = async_sweep,
+        .name = "wifi_raw_async",
+    };
+    ret = esp_timer_create(&sweep_args, &s_async_sweep);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create async timeout sweep: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "WiFi raw packet system ready");
+    return ESP_OK;
+}
+
+esp_err_t wifi_raw_set_promiscuous(bool enable)
+{
+    wifi_raw_cmd_set_promiscuous_t cmd = { .enable = enable ? 1 : 0 };
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_SET_PROMISCUOUS,
+                                                 (const uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_cmd_response(WIFI_RAW_MSG_SET_PROMISCUOUS, pdMS_TO_TICKS(5000));
+    if (ret == ESP_OK) {
+        apply_state(WIFI_RAW_MSG_SET_PROMISCUOUS, enable);
+    }
+    return ret;
+}
+
+esp_err_t wifi_raw_set_channel(uint8_t primary, uint8_t second)
+{
+    wifi_raw_cmd_set_channel_t cmd = { .primary = primary, .second = second };
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_SET_CHANNEL,
+                                                 (const uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_cmd_response(WIFI_RAW_MSG_SET_CHANNEL, pdMS_TO_TICKS(5000));
+    if (ret == ESP_OK) {
+        apply_state(WIFI_RAW_MSG_SET_CHANNEL, primary | (second << 8));
+    }
+    return ret;
+}
+
+esp_err_t wifi_raw_set_filter(uint32_t filter_mask)
+{
+    wifi_raw_cmd_set_filter_t cmd = { .filter_mask = filter_mask };
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_SET_FILTER,
+                                                 (const uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_cmd_response(WIFI_RAW_MSG_SET_FILTER, pdMS_TO_TICKS(5000));
+    if (ret == ESP_OK) {
+        apply_state(WIFI_RAW_MSG_SET_FILTER, filter_mask);
+    }
+    return ret;
+}
+
+/* Build a WIFI_RAW_MSG_80211_TX command; the caller frees it */
+static esp_err_t tx_cmd_new(uint8_t ifx, const void *buffer, int len, bool en_sys_seq,
+                            uint8_t **out, size_t *out_size)
+{
+    if (!buffer || len <= 0 || len > 4000) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t cmd_size = sizeof(wifi_raw_cmd_80211_tx_t) + len;
+    uint8_t *cmd_buf = malloc(cmd_size);
+    if (!cmd_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    wifi_raw_cmd_80211_tx_t *cmd = (wifi_raw_cmd_80211_tx_t *)cmd_buf;
+    cmd->ifx = ifx;
+    cmd->en_sys_seq = en_sys_seq ? 1 : 0;
+    cmd->data_len = (uint16_t)len;
+    memcpy(cmd->data, buffer, len);
+
+    *out = cmd_buf;
+    *out_size = cmd_size;
+    return ESP_OK;
+}
+
+esp_err_t wifi_raw_80211_tx(uint8_t ifx, const void *buffer, int len, bool en_sys_seq)
+{
+    uint8_t *cmd_buf;
+    size_t cmd_size;
+    esp_err_t ret = tx_cmd_new(ifx, buffer, len, en_sys_seq, &cmd_buf, &cmd_size);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_80211_TX, cmd_buf, cmd_size);
+    free(cmd_buf);
+
+    if (ret != ESP_OK) return ret;
+
+    return wait_cmd_response(WIFI_RAW_MSG_80211_TX, pdMS_TO_TICKS(5000));
+}
+
+esp_err_t wifi_raw_set_tx_rate(uint8_t ifx, uint8_t rate)
+{
+    wifi_raw_cmd_set_tx_rate_t cmd = {
+        .ifx = ifx,
+        .rate = rate,
+    };
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_SET_TX_RATE,
+                                                 (uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_cmd_response(WIFI_RAW_MSG_SET_TX_RATE, pdMS_TO_TICKS(5000));
+    if (ret == ESP_OK) {
+        apply_state(WIFI_RAW_MSG_SET_TX_RATE, rate);
+    }
+    return ret;
+}
+
+esp_err_t wifi_raw_80211_tx_rate(uint8_t ifx, const void *buffer, int len, bool en_sys_seq,
+                                 uint8_t rate)
+{
+    if (!buffer || len <= 0 || len > 4000) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t cmd_size = sizeof(wifi_raw_cmd_80211_tx_rate_t) + len;
+    uint8_t *cmd_buf = malloc(cmd_size);
+    if (!cmd_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    wifi_raw_cmd_80211_tx_rate_t *cmd = (wifi_raw_cmd_80211_tx_rate_t *)cmd_buf;
+    cmd->ifx = ifx;
+    cmd->en_sys_seq = en_sys_seq ? 1 : 0;
+    cmd->rate = rate;
+    cmd->data_len = (uint16_t)len;
+    memcpy(cmd->data, buffer, len);
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_80211_TX_RATE, cmd_buf, cmd_size);
+    free(cmd_buf);
+
+    if (ret != ESP_OK) return ret;
+
+    return wait_cmd_response(WIFI_RAW_MSG_80211_TX_RATE, pdMS_TO_TICKS(5000));
+}
+
+esp_err_t wifi_raw_get_slave_fw(wifi_raw_slave_fw_t *out, uint32_t timeout_ms)
+{
+    xEventGroupClearBits(s_resp_event, FW_INFO_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_GET_FW_INFO, NULL, 0);
+    if (ret != ESP_OK) return ret;
+
+    EventBits_t bits = xEventGroupWaitBits(s_resp_event, FW_INFO_BIT,
+                                            pdTRUE, pdTRUE, pdMS_TO_TICKS(timeout_ms));
+    if (!(bits & FW_INFO_BIT)) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    memset(out, 0, sizeof(*out));
+    memcpy(out->sha256, s_fw_info.app_sha256, sizeof(out->sha256));
+    memcpy(out->version, s_fw_info.version, sizeof(s_fw_info.version));
+    memcpy(out->project_name, s_fw_info.project_name, sizeof(s_fw_info.project_name));
+    return ESP_OK;
+}
+
+esp_err_t wifi_raw_ota_z_begin(uint32_t total_len, uint32_t stream_crc32, uint32_t checkpoint_len)
+{
+    wifi_raw_cmd_ota_z_begin_t cmd = {
+        .total_len = total_len,
+        .stream_crc32 = stream_crc32,
+        .checkpoint_len = checkpoint_len,
+    };
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_BEGIN,
+                                                 (const uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    /* The slave only opens the session; it erases as DATA arrives */
+    return wait_cmd_response(WIFI_RAW_MSG_OTA_Z_BEGIN, pdMS_TO_TICKS(5000));
+}
+
+esp_err_t wifi_raw_ota_z_write(uint32_t offset, const void *data, uint16_t len)
+{
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t cmd_size = sizeof(wifi_raw_cmd_ota_z_data_t) + len;
+    uint8_t *cmd_buf = malloc(cmd_size);
+    if (!cmd_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    wifi_raw_cmd_ota_z_data_t *cmd = (wifi_raw_cmd_ota_z_data_t *)cmd_buf;
+    cmd->offset = offset;
+    cmd->data_len = len;
+    memcpy(cmd->data, data, len);
+
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_DATA, cmd_buf, cmd_size);
+    free(cmd_buf);
+
+    if (ret != ESP_OK) return ret;
+
+    return wait_cmd_response(WIFI_RAW_MSG_OTA_Z_DATA, pdMS_TO_TICKS(5000));
+}
+
+esp_err_t wifi_raw_ota_z_resume(uint32_t total_len, uint32_t stream_crc32,
+                                uint32_t *offset, uint32_t timeout_ms)
+{
+    wifi_raw_cmd_ota_z_resume_t cmd = {
+        .total_len = total_len,
+        .stream_crc32 = stream_crc32,
+        .offset = *offset,
+    };
+
+    xEventGroupClearBits(s_resp_event, OTA_ACK_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_RESUME,
+                                                 (const uint8_t *)&cmd, sizeof(cmd));
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_ota_ack(WIFI_RAW_MSG_OTA_Z_RESUME, pdMS_TO_TICKS(timeout_ms));
+    if (ret == ESP_OK) {
+        if (s_ota_ack.offset > cmd.offset) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        *offset = s_ota_ack.offset;
+    }
+    return ret;
+}
+
+esp_err_t wifi_raw_ota_z_write_crc(uint32_t offset, const void *data, uint16_t len, uint32_t crc32)
+{
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t cmd_size = sizeof(wifi_raw_cmd_ota_z_data_crc_t) + len;
+    uint8_t *cmd_buf = malloc(cmd_size);
+    if (!cmd_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    wifi_raw_cmd_ota_z_data_crc_t *cmd = (wifi_raw_cmd_ota_z_data_crc_t *)cmd_buf;
+    cmd->offset = offset;
+    cmd->data_len = len;
+    cmd->crc32 = crc32;
+    memcpy(cmd->data, data, len);
+
+    xEventGroupClearBits(s_resp_event, OTA_ACK_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_DATA_CRC, cmd_buf, cmd_size);
+    free(cmd_buf);
+
+    if (ret != ESP_OK) return ret;
+
+    ret = wait_ota_ack(WIFI_RAW_MSG_OTA_Z_DATA_CRC, pdMS_TO_TICKS(5000));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    /* The slave checks the CRC too; a matching echo also proves the ack is
+     * for this chunk and not a late one for an earlier attempt */
+    if (s_ota_ack.crc32 != crc32 || s_ota_ack.offset != offset + len) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+esp_err_t wifi_raw_ota_z_end(void)
+{
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_END, NULL, 0);
+    if (ret != ESP_OK) return ret;
+
+    return wait_cmd_response(WIFI_RAW_MSG_OTA_Z_END, pdMS_TO_TICKS(10000));
+}
+
+esp_err_t wifi_raw_ota_z_activate(void)
+{
+    xEventGroupClearBits(s_resp_event, RESP_RECEIVED_BIT);
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_OTA_Z_ACTIVATE, NULL, 0);
+    if (ret != ESP_OK) return ret;
+
+    return wait_cmd_response(WIFI_RAW_MSG_OTA_Z_ACTIVATE, pdMS_TO_TICKS(5000));
+}
+
+esp_err_t wifi_raw_echo_send(uint32_t seq, const void *data, uint16_t len)
+{
+    if (!data && len > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t cmd_size = sizeof(wifi_raw_cmd_echo_t) + len;
+    uint8_t *cmd_buf = malloc(cmd_size);
+    if (!cmd_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    wifi_raw_cmd_echo_t *cmd = (wifi_raw_cmd_echo_t *)cmd_buf;
+    cmd->seq = seq;
+    cmd->data_len = len;
+    if (len > 0) {
+        memcpy(cmd->data, data, len);
+    }
+
+    /* Stamp last so the copy is not counted as latency */
+    cmd->host_tx_us = esp_timer_get_time();
+    esp_err_t ret = esp_hosted_send_custom_data(WIFI_RAW_MSG_ECHO, cmd_buf, cmd_size);
+    free(cmd_buf);
+    return ret;
+}
+
+void wifi_raw_register_echo_cb(wifi_raw_echo_cb_t cb)
+{
+    portENTER_CRITICAL(&s_cb_lock);
+    s_echo_cb = cb;
+    portEXIT_CRITICAL(&s_cb_lock);
+    cb_wait_idle(&s_echo_cb_busy);
+}
+
+/* ─── Async Commands ─── */
+
+esp_err_t wifi_raw_set_promiscuous_async(bool enable, wifi_raw_done_cb_t cb, void *ctx)
+{
+    wifi_raw_cmd_set_promiscuous_t cmd = { .enable = enable ? 1 : 0 };
+    return async_send(WIFI_RAW_MSG_SET_PROMISCUOUS, enable, (const uint8_t *)&cmd,
+                      sizeof(cmd), cb, ctx);
+}
+
+esp_err_t wifi_raw_set_channel_async(uint8_t primary, uint8_t second,
+                                     wifi_raw_done_cb_t cb, void *ctx)
+{
+    wifi_raw_cmd_set_channel_t cmd = { .primary = primary, .second = second };
+    return async_send(WIFI_RAW_MSG_SET_CHANNEL, primary | (second << 8), (const uint8_t *)&cmd,
+                      sizeof(cmd), cb, ctx);
+}
+
+esp_err_t wifi_raw_set_filter_async(uint32_t filter_mask, wifi_raw_done_cb_t cb, void *ctx)
+{
+    wifi_raw_cmd_set_filter_t cmd = { .filter_mask = filter_mask };
+    return async_send(WIFI_RAW_MSG_SET_FILTER, filter_mask, (const uint8_t *)&cmd,
+                      sizeof(cmd), cb, ctx);
+}
+
+esp_err_t wifi_raw_set_tx_rate_async(uint8_t ifx, uint8_t rate, wifi_raw_done_cb_t cb, void *ctx)
+{
+    wifi_raw_cmd_set_tx_rate_t cmd = { .ifx = ifx, .rate = rate };
+    return async_send(WIFI_RAW_MSG_SET_TX_RATE, rate, (const uint8_t *)&cmd,
+                      sizeof(cmd), cb, ctx);
+}
+
+esp_err_t wifi_raw_80211_tx_async(uint8_t ifx, const void *buffer, int len, bool en_sys_seq,
+                                  wifi_raw_done_cb_t cb, void *ctx)
+{
+    uint8_t *cmd_buf;
+    size_t cmd_size;
+    esp_err_t ret = tx_cmd_new(ifx, buffer, len, en_sys_seq, &cmd_buf, &cmd_size);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = async_send(WIFI_RAW_MSG_80211_TX, 0, cmd_buf, cmd_size, cb, ctx);
+    free(cmd_buf);
+    return ret;
+}
+
+void wifi_raw_get_state(wifi_raw_state_t *out)
+{
+    portENTER_CRITICAL(&s_async_lock);
+    *out = s_state;
+    portEXIT_CRITICAL(&s_async_lock);
+}
+
+void wifi_raw_register_rx_cb(wifi_raw_rx_cb_t cb)
+{
+    portENTER_CRITICAL(&s_cb_lock);
+    s_rx_cb = cb;
+    portEXIT_CRITICAL(&s_cb_lock);
+    cb_wait_idle(&s_rx_cb_busy);
+}
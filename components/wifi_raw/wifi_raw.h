@@ -0,0 +1,325 @@
+/*
+ * WiFi Raw - Host-side API for packet injection and monitoring
+ *
+ * Wraps esp-hosted CustomRpc to provide clean packet injection
+ * and promiscuous mode monitoring from the ESP32-P4 host.
+ * The actual WiFi operations execute on the ESP32-C6 slave.
+ */
+
+#ifndef WIFI_RAW_H
+#define WIFI_RAW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** wifi_raw_80211_tx_rate(): send at the rate set by wifi_raw_set_tx_rate() */
+#define WIFI_RAW_TX_RATE_DEFAULT    0xFF
+/** Async commands awaiting a response at once */
+#define WIFI_RAW_ASYNC_MAX_PENDING  16
+
+/**
+ * @brief Slave settings as last applied through this API
+ *
+ * Tracked on the host from successful commands, not read back from the
+ * slave. Fields never set keep their boot defaults.
+ */
+typedef struct {
+    bool promiscuous;
+    bool filter_set;        /**< false = slave default filter */
+    uint32_t filter_mask;
+    uint8_t primary;        /**< 0 = channel never set here */
+    uint8_t second;
+    uint8_t tx_rate;        /**< WIFI_RAW_TX_RATE_DEFAULT = never set */
+} wifi_raw_state_t;
+
+/**
+ * @brief Promiscuous packet info passed to the RX callback
+ */
+typedef struct {
+    uint32_t type;          /**< Packet type (wifi_promiscuous_pkt_type_t) */
+    int8_t rssi;            /**< RSSI */
+    uint8_t channel;        /**< Channel */
+    uint8_t rate;           /**< Data rate */
+    uint8_t sig_mode;       /**< 0=non-HT, 1=HT, 3=VHT */
+    uint32_t rx_state;      /**< RX state (0 = no error) */
+    const uint8_t *payload; /**< Raw 802.11 frame data */
+    uint16_t payload_len;   /**< Frame length */
+} wifi_raw_rx_pkt_t;
+
+/**
+ * @brief One answered echo, timestamps in microseconds
+ *
+ * Host and slave timestamps come from different clocks.
+ */
+typedef struct {
+    uint32_t seq;
+    int64_t host_tx_us;         /**< Host time at send */
+    int64_t slave_rx_us;        /**< Slave time on receive */
+    int64_t slave_tx_us;        /**< Slave time before replying */
+    int64_t host_rx_us;         /**< Host time on receive */
+    const uint8_t *data;        /**< Echoed payload */
+    uint16_t data_len;
+} wifi_raw_echo_t;
+
+/**
+ * @brief Callback for echo replies
+ *
+ * Called from the esp-hosted RX task; keep it short.
+ */
+typedef void (*wifi_raw_echo_cb_t)(const wifi_raw_echo_t *echo);
+
+/**
+ * @brief Callback for received promiscuous packets
+ *
+ * @param pkt Packet info (valid only during callback)
+ */
+typedef void (*wifi_raw_rx_cb_t)(const wifi_raw_rx_pkt_t *pkt);
+
+/**
+ * @brief Firmware running on the C6 slave
+ */
+typedef struct {
+    uint8_t sha256[32];     /**< SHA-256 of the running app image */
+    char version[33];       /**< App version string */
+    char project_name[33];  /**< App project name */
+} wifi_raw_slave_fw_t;
+
+/**
+ * @brief Initialize the WiFi raw packet system
+ *
+ * Registers CustomRpc callbacks for command responses and
+ * promiscuous packet events from the C6 slave. Safe to call again
+ * once initialized.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_init(void);
+
+/**
+ * @brief Enable or disable promiscuous (monitor) mode on C6
+ *
+ * @param enable true to enable, false to disable
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_set_promiscuous(bool enable);
+
+/**
+ * @brief Set the WiFi channel for monitoring
+ *
+ * @param primary Primary channel (1-14)
+ * @param second Secondary channel (0=none, 1=above, 2=below)
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_set_channel(uint8_t primary, uint8_t second);
+
+/**
+ * @brief Set promiscuous mode packet filter
+ *
+ * @param filter_mask Bitmask of packet types to capture
+ *                    (WIFI_PROMIS_FILTER_MASK_* values)
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_set_filter(uint32_t filter_mask);
+
+/**
+ * @brief Transmit a raw 802.11 frame (packet injection)
+ *
+ * @param ifx Interface: 0=STA, 1=AP
+ * @param buffer Raw 802.11 frame (including MAC header)
+ * @param len Frame length
+ * @param en_sys_seq If true, driver overwrites sequence number
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_80211_tx(uint8_t ifx, const void *buffer, int len, bool en_sys_seq);
+
+/**
+ * @brief Set the PHY rate of injected frames
+ *
+ * Calls esp_wifi_config_80211_tx_rate() on the slave. Applies to frames
+ * sent with wifi_raw_80211_tx() and to wifi_raw_80211_tx_rate() with
+ * WIFI_RAW_TX_RATE_DEFAULT. HT MCS rates need an HT-capable protocol
+ * on the interface.
+ *
+ * @param ifx WiFi interface (WIFI_IF_STA or WIFI_IF_AP)
+ * @param rate wifi_phy_rate_t, e.g. WIFI_PHY_RATE_MCS7_SGI
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_set_tx_rate(uint8_t ifx, uint8_t rate);
+
+/**
+ * @brief Transmit a raw 802.11 frame at a given PHY rate
+ *
+ * @param ifx WiFi interface (WIFI_IF_STA or WIFI_IF_AP)
+ * @param buffer 802.11 frame data
+ * @param len Frame length (max 4000 bytes)
+ * @param en_sys_seq true = let driver assign sequence number
+ * @param rate wifi_phy_rate_t for this frame, or WIFI_RAW_TX_RATE_DEFAULT
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_80211_tx_rate(uint8_t ifx, const void *buffer, int len, bool en_sys_seq,
+                                 uint8_t rate);
+
+/**
+ * @brief Query the firmware running on the slave
+ *
+ * Slaves without the wifi_raw extension ignore the request, which
+ * shows up as ESP_ERR_TIMEOUT.
+ *
+ * @param out Filled on success
+ * @param timeout_ms How long to wait for the answer
+ * @return ESP_OK, ESP_ERR_TIMEOUT if the slave did not answer
+ */
+esp_err_t wifi_raw_get_slave_fw(wifi_raw_slave_fw_t *out, uint32_t timeout_ms);
+
+/**
+ * @brief Start a streamed (LZFW, delta or, if resumable, plain) OTA on the slave
+ *
+ * The slave only picks its next OTA partition here; it erases 64 KB at
+ * a time ahead of the data as writes arrive.
+ *
+ * @param total_len Stream length including its header
+ * @param stream_crc32 CRC32 of the whole stream, 0 if not resumable
+ * @param checkpoint_len Interval of the slave's resume checkpoints
+ * @return ESP_OK on success
+ */
+esp_err_t wifi_raw_ota_z_begin(uint32_t total_len, uint32_t stream_crc32, uint32_t checkpoint_len);
+
+/**
+ * @brief Continue an interrupted streamed OTA
+ *
+ * Also tells whether the slave supports resumable sessions: slaves that
+ * do not ignore the request, which shows up as ESP_ERR_TIMEOUT.
+ *
+ * @param total_len Stream length given to the interrupted begin
+ * @param stream_crc32 Stream CRC32 given to the interrupted begin
+ * @param offset In: checkpoint to continue from; out: offset the slave
+ *               continues from (never beyond the requested one)
+ * @param timeout_ms How long to wait for the answer
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the slave holds no such session,
+ *         ESP_ERR_TIMEOUT if the slave did not answer
+ */
+esp_err_t wifi_raw_ota_z_resume(uint32_t total_len, uint32_t stream_crc32,
+                                uint32_t *offset, uint32_t timeout_ms);
+
+/**
+ * @brief Send the next piece of a resumable stream, with CRC32
+ *
+ * Safe to repeat after a failure: the slave acknowledges bytes it has
+ * already taken without decoding them again.
+ *
+ * @param offset Stream offset of data
+ * @param data Stream bytes
+ * @param len Length of data
+ * @param crc32 CRC32 of data
+ * @return ESP_OK once the slave acknowledged the chunk with a matching
+ *         CRC32, ESP_ERR_INVALID_CRC if it did not match, ESP_ERR_TIMEOUT
+ */
+esp_err_t wifi_raw_ota_z_write_crc(uint32_t offset, const void *data, uint16_t len, uint32_t crc32);
+
+/**
+ * @brief Send the next piece of the stream
+ *
+ * @param offset Stream offset of data (must follow the previous piece)
+ * @param data Compressed bytes
+ * @param len Length of data
+ * @return ESP_OK once the slave has decoded and written it
+ */
+esp_err_t wifi_raw_ota_z_write(uint32_t offset, const void *data, uint16_t len);
+
+/**
+ * @brief Finish a streamed OTA
+ *
+ * @return ESP_OK if the slave verified length and CRC32 and selected
+ *         the new image for boot
+ */
+esp_err_t wifi_raw_ota_z_end(void);
+
+/**
+ * @brief Restart the slave into the image a streamed OTA installed
+ *
+ * The slave answers first and restarts shortly after.
+ *
+ * @return ESP_OK if the restart is scheduled, ESP_ERR_INVALID_STATE if
+ *         no OTA_Z session has ended successfully since the slave booted
+ */
+esp_err_t wifi_raw_ota_z_activate(void);
+
+/**
+ * @brief Send an echo request without waiting for the reply
+ *
+ * The reply arrives at the callback set with wifi_raw_register_echo_cb().
+ * Slaves without the wifi_raw extension do not reply.
+ *
+ * @param seq Sequence number returned in the reply
+ * @param data Payload to echo (may be NULL if len is 0)
+ * @param len Payload length
+ * @return ESP_OK once handed to the transport
+ */
+esp_err_t wifi_raw_echo_send(uint32_t seq, const void *data, uint16_t len);
+
+/**
+ * @brief Register callback for echo replies
+ *
+ * Returns once no call of the previous callback is running, so whatever
+ * it uses can be freed right after. Do not call from inside a callback.
+ *
+ * @param cb Callback function, NULL to deregister
+ */
+void wifi_raw_register_echo_cb(wifi_raw_echo_cb_t cb);
+
+/**
+ * @brief Completion of an async command
+ *
+ * Runs in the esp_hosted RX task, or the esp_timer task with
+ * ESP_ERR_TIMEOUT after 5 s without a response. Keep it short.
+ *
+ * @param result Slave status, or ESP_ERR_TIMEOUT
+ * @param ctx Context passed with the command
+ */
+typedef void (*wifi_raw_done_cb_t)(esp_err_t result, void *ctx);
+
+/**
+ * @brief Async forms of the commands above
+ *
+ * Return once the command is handed to the transport; cb (may be NULL)
+ * gets the result later. cb is not called when these return an error.
+ * Up to WIFI_RAW_ASYNC_MAX_PENDING commands can be in flight from any
+ * number of tasks (ESP_ERR_NO_MEM beyond that). Do not overlap a
+ * blocking and an async command of the same kind.
+ */
+esp_err_t wifi_raw_set_promiscuous_async(bool enable, wifi_raw_done_cb_t cb, void *ctx);
+esp_err_t wifi_raw_set_channel_async(uint8_t primary, uint8_t second,
+                                     wifi_raw_done_cb_t cb, void *ctx);
+esp_err_t wifi_raw_set_filter_async(uint32_t filter_mask, wifi_raw_done_cb_t cb, void *ctx);
+esp_err_t wifi_raw_set_tx_rate_async(uint8_t ifx, uint8_t rate, wifi_raw_done_cb_t cb, void *ctx);
+esp_err_t wifi_raw_80211_tx_async(uint8_t ifx, const void *buffer, int len, bool en_sys_seq,
+                                  wifi_raw_done_cb_t cb, void *ctx);
+
+/**
+ * @brief Get the slave settings last applied through this API
+ *
+ * @param out Filled with the tracked state
+ */
+void wifi_raw_get_state(wifi_raw_state_t *out);
+
+/**
+ * @brief Register callback for promiscuous packets
+ *
+ * Only one callback can be active at a time. Pass NULL to deregister.
+ * Returns once no call of the previous callback is running, so whatever
+ * it uses can be freed right after. Do not call from inside a callback.
+ *
+ * @param cb Callback function
+ */
+void wifi_raw_register_rx_cb(wifi_raw_rx_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_RAW_H */
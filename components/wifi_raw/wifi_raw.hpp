@@ -0,0 +1,408 @@
+/*
+ * WiFi Raw - header-only C++20 layer over wifi_raw.h
+ *
+ * - Frame / FramePool: move-only frame buffers from a fixed pool, built
+ *   in place with the wifi_raw_frame.h builder
+ * - Packet / Echo: std::span views of received data, valid for the
+ *   duration of the callback only
+ * - on_rx() / on_echo(): subscriptions that store the functor inline and
+ *   register a per-type trampoline, so the call inlines and nothing is
+ *   allocated (no std::function)
+ * - PromiscSession: enables promiscuous mode for a scope and puts the
+ *   tracked slave state (wifi_raw_get_state()) back on exit
+ *
+ * ESP-IDF builds C++ without exceptions by default, so failures are
+ * reported as esp_err_t like the C API.
+ */
+
+#ifndef WIFI_RAW_HPP
+#define WIFI_RAW_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "wifi_raw.h"
+#include "wifi_raw_frame.h"
+
+namespace wifi_raw {
+
+/** Largest frame esp_wifi_80211_tx() sends on the slave */
+inline constexpr size_t kMaxFrameLen = 1500;
+
+/* ─── Frames ─── */
+
+template <size_t Count, size_t Capacity>
+class FramePool;
+
+/**
+ * @brief Frame buffer borrowed from a FramePool, returned on destruction
+ *
+ * A default-constructed or moved-from Frame is empty (false).
+ */
+class Frame {
+public:
+    Frame() = default;
+    Frame(const Frame &) = delete;
+    Frame &operator=(const Frame &) = delete;
+
+    Frame(Frame &&o) noexcept
+        : buf_(std::exchange(o.buf_, nullptr)), cap_(std::exchange(o.cap_, 0)),
+          len_(std::exchange(o.len_, 0)), slot_(std::exchange(o.slot_, nullptr)) {}
+
+    Frame &operator=(Frame &&o) noexcept
+    {
+        if (this != &o) {
+            release();
+            buf_ = std::exchange(o.buf_, nullptr);
+            cap_ = std::exchange(o.cap_, 0);
+            len_ = std::exchange(o.len_, 0);
+            slot_ = std::exchange(o.slot_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Frame() { release(); }
+
+    explicit operator bool() const { return buf_ != nullptr; }
+
+    /** Whole buffer, for filling by hand; then set the length with resize() */
+    std::span<uint8_t> buffer() { return {buf_, cap_}; }
+    /** Frame bytes */
+    std::span<const uint8_t> data() const { return {buf_, len_}; }
+    size_t size() const { return len_; }
+    size_t capacity() const { return cap_; }
+    void resize(size_t len) { len_ = len < cap_ ? len : cap_; }
+
+    /** Builder over the whole buffer; hand it back to finish() */
+    wifi_raw_frame_t builder()
+    {
+        wifi_raw_frame_t f;
+        wifi_raw_frame_init(&f, buf_, cap_);
+        return f;
+    }
+
+    /** Take the length from a builder; false (and empty) on overflow */
+    bool finish(const wifi_raw_frame_t &f)
+    {
+        len_ = wifi_raw_frame_len(&f);
+        return len_ != 0;
+    }
+
+private:
+    template <size_t, size_t>
+    friend class FramePool;
+
+    Frame(uint8_t *buf, size_t cap, std::atomic<bool> *slot) : buf_(buf), cap_(cap), slot_(slot) {}
+
+    void release()
+    {
+        if (slot_) {
+            slot_->store(false, std::memory_order_release);
+        }
+        buf_ = nullptr;
+        cap_ = len_ = 0;
+        slot_ = nullptr;
+    }
+
+    uint8_t *buf_ = nullptr;
+    size_t cap_ = 0;
+    size_t len_ = 0;
+    std::atomic<bool> *slot_ = nullptr;
+};
+
+/**
+ * @brief Fixed pool of Count frame buffers, safe to acquire from any task
+ *
+ * Must outlive every Frame taken from it; usually a static.
+ */
+template <size_t Count, size_t Capacity = kMaxFrameLen>
+class FramePool {
+public:
+    FramePool() = default;
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    /** A free frame, or an empty one when all are in use */
+    Frame acquire()
+    {
+        for (size_t i = 0; i < Count; i++) {
+            bool expected = false;
+            if (used_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return Frame(bufs_[i], Capacity, &used_[i]);
+            }
+        }
+        return Frame();
+    }
+
+    size_t available() const
+    {
+        size_t n = 0;
+        for (const auto &u : used_) {
+            n += !u.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+private:
+    alignas(4) uint8_t bufs_[Count][Capacity];
+    std::atomic<bool> used_[Count] = {};
+};
+
+/**
+ * @brief Inject a frame (wifi_raw_80211_tx(), or _tx_rate() for a rate)
+ */
+inline esp_err_t tx(uint8_t ifx, std::span<const uint8_t> frame, bool en_sys_seq = true,
+                    uint8_t rate = WIFI_RAW_TX_RATE_DEFAULT)
+{
+    if (rate == WIFI_RAW_TX_RATE_DEFAULT) {
+        return wifi_raw_80211_tx(ifx, frame.data(), static_cast<int>(frame.size()), en_sys_seq);
+    }
+    return wifi_raw_80211_tx_rate(ifx, frame.data(), static_cast<int>(frame.size()), en_sys_seq,
+                                  rate);
+}
+
+inline esp_err_t tx(uint8_t ifx, const Frame &frame, bool en_sys_seq = true,
+                    uint8_t rate = WIFI_RAW_TX_RATE_DEFAULT)
+{
+    return tx(ifx, frame.data(), en_sys_seq, rate);
+}
+
+/* ─── Received data views ─── */
+
+/**
+ * @brief Captured packet, valid only inside the RX callback
+ */
+class Packet {
+public:
+    explicit Packet(const wifi_raw_rx_pkt_t &pkt) : pkt_(pkt) {}
+
+    std::span<const uint8_t> data() const { return {pkt_.payload, pkt_.payload_len}; }
+    uint32_t type() const { return pkt_.type; }
+    int8_t rssi() const { return pkt_.rssi; }
+    uint8_t channel() const { return pkt_.channel; }
+    uint8_t rate() const { return pkt_.rate; }
+    uint8_t sig_mode() const { return pkt_.sig_mode; }
+    bool ok() const { return pkt_.rx_state == 0; }
+    bool parse(wifi_raw_frame_info_t &info) const
+    {
+        return wifi_raw_frame_parse(pkt_.payload, pkt_.payload_len, &info);
+    }
+    const wifi_raw_rx_pkt_t &raw() const { return pkt_; }
+
+private:
+    const wifi_raw_rx_pkt_t &pkt_;
+};
+
+/**
+ * @brief Echo reply, valid only inside the echo callback
+ */
+class Echo {
+public:
+    explicit Echo(const wifi_raw_echo_t &echo) : echo_(echo) {}
+
+    std::span<const uint8_t> data() const { return {echo_.data, echo_.data_len}; }
+    uint32_t seq() const { return echo_.seq; }
+    int64_t rtt_us() const { return echo_.host_rx_us - echo_.host_tx_us; }
+    const wifi_raw_echo_t &raw() const { return echo_; }
+
+private:
+    const wifi_raw_echo_t &echo_;
+};
+
+/* ─── Subscriptions ─── */
+
+namespace detail {
+
+/* Subscription currently registered with each C callback slot */
+template <auto Register>
+inline std::atomic<const void *> g_owner{nullptr};
+
+template <typename Raw, typename View, auto Register, typename F>
+class Subscription {
+public:
+    explicit Subscription(F fn) : fn_(std::move(fn)) { attach(); }
+    Subscription(const Subscription &) = delete;
+    Subscription &operator=(const Subscription &) = delete;
+
+    /* Move only while no callback can be running */
+    Subscription(Subscription &&o) noexcept : fn_(std::move(o.fn_))
+    {
+        if (o.detach_quiet()) {
+            attach();
+        }
+    }
+
+    Subscription &operator=(Subscription &&o) noexcept
+    {
+        if (this != &o) {
+            reset();
+            fn_ = std::move(o.fn_);
+            if (o.detach_quiet()) {
+                attach();
+            }
+        }
+        return *this;
+    }
+
+    ~Subscription() { reset(); }
+
+    /** false once replaced by a newer subscription to the same callback */
+    bool active() const { return g_owner<Register>.load() == this; }
+
+    /**
+     * Deregister now rather than at destruction. Returns once no call of
+     * fn is running, so what fn uses can go; not from inside fn.
+     */
+    void reset()
+    {
+        const void *self = this;
+        if (g_owner<Register>.compare_exchange_strong(self, nullptr)) {
+            Register(nullptr);
+        }
+        Subscription *me = this;
+        s_self.compare_exchange_strong(me, nullptr);
+
+        /* A newer subscription may own the C slot while a call that
+         * loaded this one is still running: wait for the calls that
+         * started before s_self was cleared */
+        uint32_t entered = s_entered.load();
+        while (static_cast<int32_t>(s_exited.load() - entered) < 0) {
+            vTaskDelay(1);
+        }
+    }
+
+private:
+    static void trampoline(const Raw *raw)
+    {
+        s_entered.fetch_add(1);
+        Subscription *self = s_self.load();
+        if (self) {
+            self->fn_(View(*raw));
+        }
+        s_exited.fetch_add(1);
+    }
+
+    void attach()
+    {
+        s_self.store(this, std::memory_order_release);
+        g_owner<Register>.store(this);
+        Register(&trampoline);
+    }
+
+    /* Hand the registration over to a move target without a gap */
+    bool detach_quiet()
+    {
+        const void *self = this;
+        Subscription *me = this;
+        s_self.compare_exchange_strong(me, nullptr);
+        return g_owner<Register>.compare_exchange_strong(self, nullptr);
+    }
+
+    static inline std::atomic<Subscription *> s_self{nullptr};
+    static inline std::atomic<uint32_t> s_entered{0};   /* Trampoline calls begun */
+    static inline std::atomic<uint32_t> s_exited{0};    /* ... and returned */
+    F fn_;
+};
+
+} // namespace detail
+
+template <typename F>
+using RxSubscription = detail::Subscription<wifi_raw_rx_pkt_t, Packet, wifi_raw_register_rx_cb, F>;
+
+template <typename F>
+using EchoSubscription =
+    detail::Subscription<wifi_raw_echo_t, Echo, wifi_raw_register_echo_cb, F>;
+
+/**
+ * @brief Call fn(Packet) for every captured packet while the result lives
+ *
+ * Replaces any earlier RX callback. fn runs in the esp_hosted RX task;
+ * destroying or reset()ing the result waits for a call in progress.
+ */
+template <typename F>
+[[nodiscard]] RxSubscription<std::decay_t<F>> on_rx(F &&fn)
+{
+    return RxSubscription<std::decay_t<F>>(std::forward<F>(fn));
+}
+
+/**
+ * @brief Call fn(Echo) for every echo reply while the result lives
+ */
+template <typename F>
+[[nodiscard]] EchoSubscription<std::decay_t<F>> on_echo(F &&fn)
+{
+    return EchoSubscription<std::decay_t<F>>(std::forward<F>(fn));
+}
+
+/* ─── Promiscuous session ─── */
+
+/**
+ * @brief Promiscuous mode for the lifetime of the object
+ *
+ * Applies the optional filter and channel, enables promiscuous mode, and
+ * on destruction undoes exactly what it changed. A filter or channel the
+ * host never set before has no known value to return to and is left as
+ * the session set it. Sessions nest.
+ */
+class PromiscSession {
+public:
+    explicit PromiscSession(std::optional<uint32_t> filter_mask = std::nullopt,
+                            uint8_t primary = 0, uint8_t second = 0)
+    {
+        wifi_raw_get_state(&saved_);
+
+        if (filter_mask && (!saved_.filter_set || saved_.filter_mask != *filter_mask)) {
+            note(wifi_raw_set_filter(*filter_mask), set_filter_);
+        }
+        if (status_ == ESP_OK && primary &&
+            (saved_.primary != primary || saved_.second != second)) {
+            note(wifi_raw_set_channel(primary, second), set_channel_);
+        }
+        if (status_ == ESP_OK && !saved_.promiscuous) {
+            note(wifi_raw_set_promiscuous(true), enabled_);
+        }
+    }
+
+    PromiscSession(const PromiscSession &) = delete;
+    PromiscSession &operator=(const PromiscSession &) = delete;
+
+    ~PromiscSession()
+    {
+        if (enabled_) {
+            wifi_raw_set_promiscuous(false);
+        }
+        if (set_channel_ && saved_.primary) {
+            wifi_raw_set_channel(saved_.primary, saved_.second);
+        }
+        if (set_filter_ && saved_.filter_set) {
+            wifi_raw_set_filter(saved_.filter_mask);
+        }
+    }
+
+    /** ESP_OK if every setting was applied */
+    esp_err_t status() const { return status_; }
+    explicit operator bool() const { return status_ == ESP_OK; }
+
+private:
+    void note(esp_err_t ret, bool &changed)
+    {
+        changed = ret == ESP_OK;
+        status_ = ret;
+    }
+
+    wifi_raw_state_t saved_{};
+    esp_err_t status_ = ESP_OK;
+    bool set_filter_ = false;
+    bool set_channel_ = false;
+    bool enabled_ = false;
+};
+
+} // namespace wifi_raw
+
+#endif /* WIFI_RAW_HPP */
@@ -0,0 +1,300 @@
+/*
+ * WiFi Raw - C++20 coroutine awaitables for wifi_raw commands
+ *
+ * co_await set_channel(6) sends the command with the *_async C API and
+ * suspends; the response callback posts the coroutine back to its
+ * Executor, which resumes it on the executor's task. Any number of
+ * coroutines (channel hopping, injection schedules, stats polling) share
+ * that one task and stack, and their RPCs overlap up to
+ * WIFI_RAW_ASYNC_MAX_PENDING in flight.
+ *
+ *     wifi_raw::co::Executor exec;
+ *     exec.spawn(hopper());        // Task hopper() { co_await ...; }
+ *     exec.spawn(poller());
+ *     exec.run();                  // Returns when both have finished
+ *
+ * Coroutine frames are heap-allocated once per Task. Everything else,
+ * including sleeps, lives in the frames.
+ */
+
+#ifndef WIFI_RAW_CO_HPP
+#define WIFI_RAW_CO_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <utility>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "wifi_raw.h"
+
+namespace wifi_raw::co {
+
+class Executor;
+
+/**
+ * @brief Fire-and-forget coroutine, started by Executor::spawn()
+ */
+class Task {
+public:
+    struct promise_type {
+        Executor *exec = nullptr;
+        promise_type *next_ready = nullptr;     /* Executor's spawn list */
+
+        ~promise_type();
+        Task get_return_object() { return Task(handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::abort(); }
+    };
+    using handle = std::coroutine_handle<promise_type>;
+
+    Task(Task &&o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task &operator=(Task &&) = delete;
+
+    /* A Task that was never spawned never ran: free its frame */
+    ~Task()
+    {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+private:
+    friend class Executor;
+    explicit Task(handle h) : h_(h) {}
+    handle release() { return std::exchange(h_, {}); }
+
+    handle h_;
+};
+
+/**
+ * @brief Runs coroutines on the task that calls run()
+ *
+ * post() may be called from any task; everything else belongs to the
+ * executor's task (or to setup before run()). Spawned Tasks wait on a
+ * list in their frames rather than in the queue, so spawning never
+ * blocks the executor on its own queue.
+ */
+class Executor {
+public:
+    explicit Executor(UBaseType_t queue_len = 32)
+        : queue_(xQueueCreate(queue_len, sizeof(void *))) {}
+    ~Executor()
+    {
+        if (queue_) {
+            vQueueDelete(queue_);
+        }
+    }
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /** false if the ready queue could not be allocated */
+    explicit operator bool() const { return queue_ != nullptr; }
+
+    void spawn(Task t)
+    {
+        Task::handle h = t.release();
+        Task::promise_type *p = &h.promise();
+        p->exec = this;
+        live_.fetch_add(1);
+        *(spawned_tail_ ? &spawned_tail_->next_ready : &spawned_) = p;
+        spawned_tail_ = p;
+    }
+
+    /**
+     * Queue a suspended coroutine for resumption. Blocks while the queue
+     * is full, except on the executor's own task, which would never drain
+     * it: there a full queue aborts.
+     */
+    void post(std::coroutine_handle<> h)
+    {
+        void *addr = h.address();
+        bool self = owner_.load() == xTaskGetCurrentTaskHandle();
+        if (xQueueSend(queue_, &addr, self ? 0 : portMAX_DELAY) != pdTRUE) {
+            std::abort();
+        }
+    }
+
+    /** Resume coroutines until every spawned Task has finished */
+    void run()
+    {
+        owner_.store(xTaskGetCurrentTaskHandle());
+        for (;;) {
+            while (spawned_) {
+                Task::promise_type *p = spawned_;
+                spawned_ = p->next_ready;
+                if (!spawned_) {
+                    spawned_tail_ = nullptr;
+                }
+                Task::handle::from_promise(*p).resume();
+            }
+            if (live_.load() == 0) {
+                break;
+            }
+
+            TickType_t wait = portMAX_DELAY;
+            if (sleepers_) {
+                int64_t left_us = sleepers_->deadline - esp_timer_get_time();
+                int64_t left_ms = left_us > 0 ? (left_us + 999) / 1000 : 0;
+                wait = (left_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+            }
+
+            void *addr;
+            if (xQueueReceive(queue_, &addr, wait) == pdTRUE) {
+                std::coroutine_handle<>::from_address(addr).resume();
+            }
+
+            int64_t now = esp_timer_get_time();
+            while (sleepers_ && sleepers_->deadline <= now) {
+                Sleeper *s = sleepers_;
+                sleepers_ = s->next;
+                s->h.resume();
+            }
+        }
+        owner_.store(nullptr);
+    }
+
+    /** Sleep list node, kept in the sleeping coroutine's frame */
+    struct Sleeper {
+        int64_t deadline;
+        std::coroutine_handle<> h;
+        Sleeper *next = nullptr;
+    };
+
+    void add_sleeper(Sleeper *s)
+    {
+        Sleeper **p = &sleepers_;
+        while (*p && (*p)->deadline <= s->deadline) {
+            p = &(*p)->next;
+        }
+        s->next = *p;
+        *p = s;
+    }
+
+private:
+    friend struct Task::promise_type;
+
+    QueueHandle_t queue_;
+    std::atomic<int> live_{0};
+    std::atomic<TaskHandle_t> owner_{nullptr};  /* Task inside run() */
+    Sleeper *sleepers_ = nullptr;   /* Sorted by deadline */
+    Task::promise_type *spawned_ = nullptr;     /* Spawned, not yet started */
+    Task::promise_type *spawned_tail_ = nullptr;
+};
+
+inline Task::promise_type::~promise_type()
+{
+    if (exec) {
+        exec->live_.fetch_sub(1);
+    }
+}
+
+/**
+ * @brief Awaitable wrapping one *_async C call; co_await yields esp_err_t
+ *
+ * Start is called as start(cb, ctx) and returns the send result.
+ */
+template <typename Start>
+class Command {
+public:
+    explicit Command(Start start) : start_(std::move(start)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(Task::handle h)
+    {
+        h_ = h;
+        exec_ = h.promise().exec;
+        esp_err_t ret = start_(&Command::done, this);
+        if (ret != ESP_OK) {
+            result_ = ret;      /* Not sent, no callback will come */
+            return false;
+        }
+        return true;
+    }
+
+    esp_err_t await_resume() const noexcept { return result_; }
+
+private:
+    static void done(esp_err_t result, void *ctx)
+    {
+        auto *self = static_cast<Command *>(ctx);
+        self->result_ = result;
+        self->exec_->post(self->h_);
+    }
+
+    Start start_;
+    std::coroutine_handle<> h_;
+    Executor *exec_ = nullptr;
+    esp_err_t result_ = ESP_OK;
+};
+
+/**
+ * @brief co_await sleep_ms(n): resume after n ms without blocking the executor
+ */
+class sleep_ms {
+public:
+    explicit sleep_ms(uint32_t ms) : ms_(ms) {}
+
+    bool await_ready() const noexcept { return ms_ == 0; }
+    void await_suspend(Task::handle h)
+    {
+        node_.deadline = esp_timer_get_time() + (int64_t)ms_ * 1000;
+        node_.h = h;
+        h.promise().exec->add_sleeper(&node_);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    uint32_t ms_;
+    Executor::Sleeper node_{};
+};
+
+inline auto set_promiscuous(bool enable)
+{
+    return Command([=](wifi_raw_done_cb_t cb, void *ctx) {
+        return wifi_raw_set_promiscuous_async(enable, cb, ctx);
+    });
+}
+
+inline auto set_channel(uint8_t primary, uint8_t second = 0)
+{
+    return Command([=](wifi_raw_done_cb_t cb, void *ctx) {
+        return wifi_raw_set_channel_async(primary, second, cb, ctx);
+    });
+}
+
+inline auto set_filter(uint32_t filter_mask)
+{
+    return Command([=](wifi_raw_done_cb_t cb, void *ctx) {
+        return wifi_raw_set_filter_async(filter_mask, cb, ctx);
+    });
+}
+
+inline auto set_tx_rate(uint8_t ifx, uint8_t rate)
+{
+    return Command([=](wifi_raw_done_cb_t cb, void *ctx) {
+        return wifi_raw_set_tx_rate_async(ifx, rate, cb, ctx);
+    });
+}
+
+/** The frame is copied when the command is sent, at the co_await */
+inline auto tx(uint8_t ifx, std::span<const uint8_t> frame, bool en_sys_seq = true)
+{
+    return Command([=](wifi_raw_done_cb_t cb, void *ctx) {
+        return wifi_raw_80211_tx_async(ifx, frame.data(), static_cast<int>(frame.size()),
+                                       en_sys_seq, cb, ctx);
+    });
+}
+
+} // namespace wifi_raw::co
+
+#endif /* WIFI_RAW_CO_HPP */
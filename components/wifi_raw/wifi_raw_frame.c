@@ -0,0 +1,189 @@
+/*
+ * WiFi Raw Frame - implementation
+ */
+
+#include <string.h>
+#include "wifi_raw_frame.h"
+
+static const uint8_t s_broadcast[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+void wifi_raw_frame_init(wifi_raw_frame_t *f, void *buf, size_t cap)
+{
+    f->buf = buf;
+    f->cap = cap;
+    f->len = 0;
+    f->overflow = false;
+}
+
+uint8_t *wifi_raw_frame_reserve(wifi_raw_frame_t *f, size_t len)
+{
+    if (f->overflow || len > f->cap - f->len) {
+        f->overflow = true;
+        return NULL;
+    }
+    uint8_t *p = f->buf + f->len;
+    f->len += len;
+    return p;
+}
+
+wifi_raw_mac_hdr_t *wifi_raw_frame_hdr(wifi_raw_frame_t *f, uint8_t fc0, const uint8_t *da,
+                                       const uint8_t *sa, const uint8_t *bssid)
+{
+    wifi_raw_mac_hdr_t *hdr = (wifi_raw_mac_hdr_t *)wifi_raw_frame_reserve(f, sizeof(*hdr));
+    if (!hdr) {
+        return NULL;
+    }
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->fc[0] = fc0;
+    memcpy(hdr->addr1, da ? da : s_broadcast, 6);
+    memcpy(hdr->addr2, sa, 6);
+    memcpy(hdr->addr3, bssid ? bssid : sa, 6);
+    return hdr;
+}
+
+wifi_raw_beacon_fixed_t *wifi_raw_frame_beacon(wifi_raw_frame_t *f, const uint8_t *bssid,
+                                               uint16_t interval_tu, uint16_t capability)
+{
+    if (!wifi_raw_frame_hdr(f, WIFI_RAW_FC_BEACON, NULL, bssid, bssid)) {
+        return NULL;
+    }
+    wifi_raw_beacon_fixed_t *fixed =
+        (wifi_raw_beacon_fixed_t *)wifi_raw_frame_reserve(f, sizeof(*fixed));
+    if (!fixed) {
+        return NULL;
+    }
+    memset(fixed->timestamp, 0, sizeof(fixed->timestamp));
+    fixed->interval[0] = interval_tu & 0xFF;
+    fixed->interval[1] = interval_tu >> 8;
+    fixed->capability[0] = capability & 0xFF;
+    fixed->capability[1] = capability >> 8;
+    return fixed;
+}
+
+wifi_raw_mac_hdr_t *wifi_raw_frame_probe_req(wifi_raw_frame_t *f, const uint8_t *sa)
+{
+    return wifi_raw_frame_hdr(f, WIFI_RAW_FC_PROBE_REQ, NULL, sa, s_broadcast);
+}
+
+wifi_raw_action_vendor_t *wifi_raw_frame_action_vendor(wifi_raw_frame_t *f, const uint8_t *da,
+                                                       const uint8_t *sa, const uint8_t *oui)
+{
+    if (!wifi_raw_frame_hdr(f, WIFI_RAW_FC_ACTION, da, sa, sa)) {
+        return NULL;
+    }
+    wifi_raw_action_vendor_t *act =
+        (wifi_raw_action_vendor_t *)wifi_raw_frame_reserve(f, sizeof(*act));
+    if (!act) {
+        return NULL;
+    }
+    act->category = WIFI_RAW_ACTION_VENDOR;
+    memcpy(act->oui, oui, 3);
+    return act;
+}
+
+uint8_t *wifi_raw_frame_ie(wifi_raw_frame_t *f, uint8_t id, size_t len)
+{
+    if (len > WIFI_RAW_IE_MAX_BODY) {
+        f->overflow = true;
+        return NULL;
+    }
+    uint8_t *p = wifi_raw_frame_reserve(f, WIFI_RAW_IE_LEN(len));
+    if (!p) {
+        return NULL;
+    }
+    p[0] = id;
+    p[1] = (uint8_t)len;
+    return p + 2;
+}
+
+bool wifi_raw_frame_ie_put(wifi_raw_frame_t *f, uint8_t id, const void *data, size_t len)
+{
+    uint8_t *body = wifi_raw_frame_ie(f, id, len);
+    if (!body) {
+        return false;
+    }
+    memcpy(body, data, len);
+    return true;
+}
+
+uint8_t *wifi_raw_frame_vendor_ie(wifi_raw_frame_t *f, const uint8_t *oui, size_t len)
+{
+    uint8_t *body = wifi_raw_frame_ie(f, WIFI_RAW_IE_VENDOR, 3 + len);
+    if (!body) {
+        return NULL;
+    }
+    memcpy(body, oui, 3);
+    return body + 3;
+}
+
+size_t wifi_raw_frame_len(const wifi_raw_frame_t *f)
+{
+    return f->overflow ? 0 : f->len;
+}
+
+bool wifi_raw_frame_parse(const uint8_t *frame, size_t len, wifi_raw_frame_info_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (len < WIFI_RAW_HDR_LEN) {
+        return false;
+    }
+    out->hdr = (const wifi_raw_mac_hdr_t *)frame;
+    out->type = WIFI_RAW_FC_TYPE(frame[0]);
+    out->subtype = WIFI_RAW_FC_SUBTYPE(frame[0]);
+    out->body = frame + WIFI_RAW_HDR_LEN;
+    out->body_len = len - WIFI_RAW_HDR_LEN;
+
+    /* Elements start after the fixed fields, which depend on the subtype */
+    size_t fixed = SIZE_MAX;
+    if (out->type == 0) {
+        switch (frame[0] & 0xF0) {
+        case WIFI_RAW_FC_BEACON:
+        case WIFI_RAW_FC_PROBE_RESP:
+            fixed = sizeof(wifi_raw_beacon_fixed_t);
+            break;
+        case WIFI_RAW_FC_PROBE_REQ:
+            fixed = 0;
+            break;
+        }
+    }
+    if (fixed <= out->body_len) {
+        out->ies = out->body + fixed;
+        out->ies_len = out->body_len - fixed;
+    }
+    return true;
+}
+
+const uint8_t *wifi_raw_ie_find(const uint8_t *ies, size_t len, uint8_t id, size_t *body_len)
+{
+    size_t pos = 0;
+    while (pos + 2 <= len) {
+        size_t n = ies[pos + 1];
+        if (pos + 2 + n > len) {
+            return NULL;
+        }
+        if (ies[pos] == id) {
+            *body_len = n;
+            return ies + pos + 2;
+        }
+        pos += 2 + n;
+    }
+    return NULL;
+}
+
+const uint8_t *wifi_raw_vendor_ie_find(const uint8_t *ies, size_t len, const uint8_t *oui,
+                                       size_t *body_len)
+{
+    size_t pos = 0;
+    while (pos + 2 <= len) {
+        size_t n = ies[pos + 1];
+        if (pos + 2 + n > len) {
+            return NULL;
+        }
+        if (ies[pos] == WIFI_RAW_IE_VENDOR && n >= 3 && memcmp(ies + pos + 2, oui, 3) == 0) {
+            *body_len = n - 3;
+            return ies + pos + 5;
+        }
+        pos += 2 + n;
+    }
+    return NULL;
+}
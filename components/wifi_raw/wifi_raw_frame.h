@@ -0,0 +1,221 @@
+/*
+ * WiFi Raw Frame - 802.11 management/data frame builder and parser
+ *
+ * Fixed parts of a frame are packed structs whose sizes and offsets are
+ * checked at compile time, and the *_LEN macros give exact frame sizes
+ * for static buffers. A builder writes straight into the caller's buffer:
+ * element bodies are reserved in place and filled by the caller, so
+ * nothing is allocated or copied twice. Overflow is sticky and reported
+ * once by wifi_raw_frame_len().
+ *
+ * Pure C with no ESP-IDF dependencies, so it builds and runs on Linux
+ * against captured frames as well as on the host MCU.
+ */
+
+#ifndef WIFI_RAW_FRAME_H
+#define WIFI_RAW_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Frame control byte 0: subtype << 4 | type << 2 (protocol version 0) */
+#define WIFI_RAW_FC_ASSOC_REQ       0x00
+#define WIFI_RAW_FC_PROBE_REQ       0x40
+#define WIFI_RAW_FC_PROBE_RESP      0x50
+#define WIFI_RAW_FC_BEACON          0x80
+#define WIFI_RAW_FC_DISASSOC        0xA0
+#define WIFI_RAW_FC_AUTH            0xB0
+#define WIFI_RAW_FC_DEAUTH          0xC0
+#define WIFI_RAW_FC_ACTION          0xD0
+#define WIFI_RAW_FC_DATA            0x08
+
+#define WIFI_RAW_FC_TYPE(fc0)       (((fc0) >> 2) & 0x03)   /**< 0=mgmt 1=ctrl 2=data */
+#define WIFI_RAW_FC_SUBTYPE(fc0)    (((fc0) >> 4) & 0x0F)
+
+/* Element IDs */
+#define WIFI_RAW_IE_SSID            0
+#define WIFI_RAW_IE_SUPP_RATES      1
+#define WIFI_RAW_IE_DS_PARAMS       3
+#define WIFI_RAW_IE_VENDOR          221
+
+#define WIFI_RAW_ACTION_VENDOR      127     /**< Vendor-specific action category */
+#define WIFI_RAW_IE_MAX_BODY        255
+
+/**
+ * @brief Generic 3-address MAC header
+ */
+typedef struct {
+    uint8_t fc[2];
+    uint8_t duration[2];
+    uint8_t addr1[6];       /**< Receiver / DA */
+    uint8_t addr2[6];       /**< Transmitter / SA */
+    uint8_t addr3[6];       /**< BSSID */
+    uint8_t seq_ctrl[2];
+} __attribute__((packed)) wifi_raw_mac_hdr_t;
+
+/**
+ * @brief Beacon and probe response fixed fields
+ */
+typedef struct {
+    uint8_t timestamp[8];
+    uint8_t interval[2];    /**< Beacon interval, TU, little-endian */
+    uint8_t capability[2];
+} __attribute__((packed)) wifi_raw_beacon_fixed_t;
+
+/**
+ * @brief Vendor-specific action header
+ */
+typedef struct {
+    uint8_t category;       /**< WIFI_RAW_ACTION_VENDOR */
+    uint8_t oui[3];
+} __attribute__((packed)) wifi_raw_action_vendor_t;
+
+#ifdef __cplusplus
+#define WIFI_RAW_STATIC_ASSERT static_assert
+#else
+#define WIFI_RAW_STATIC_ASSERT _Static_assert
+#endif
+WIFI_RAW_STATIC_ASSERT(sizeof(wifi_raw_mac_hdr_t) == 24, "MAC header is 24 bytes");
+WIFI_RAW_STATIC_ASSERT(offsetof(wifi_raw_mac_hdr_t, addr2) == 10, "SA at offset 10");
+WIFI_RAW_STATIC_ASSERT(offsetof(wifi_raw_mac_hdr_t, seq_ctrl) == 22, "Seq control at offset 22");
+WIFI_RAW_STATIC_ASSERT(sizeof(wifi_raw_beacon_fixed_t) == 12, "Beacon fixed fields are 12 bytes");
+WIFI_RAW_STATIC_ASSERT(sizeof(wifi_raw_action_vendor_t) == 4, "Vendor action header is 4 bytes");
+
+/* Exact sizes, usable for static buffers */
+#define WIFI_RAW_HDR_LEN            sizeof(wifi_raw_mac_hdr_t)
+#define WIFI_RAW_IE_LEN(body)       (2 + (body))
+#define WIFI_RAW_VENDOR_IE_LEN(body) WIFI_RAW_IE_LEN(3 + (body))
+#define WIFI_RAW_BEACON_LEN(ies)    (WIFI_RAW_HDR_LEN + sizeof(wifi_raw_beacon_fixed_t) + (ies))
+#define WIFI_RAW_PROBE_REQ_LEN(ies) (WIFI_RAW_HDR_LEN + (ies))
+#define WIFI_RAW_ACTION_VENDOR_LEN(body) \
+    (WIFI_RAW_HDR_LEN + sizeof(wifi_raw_action_vendor_t) + (body))
+
+/**
+ * @brief Builder cursor over a caller-owned buffer
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} wifi_raw_frame_t;
+
+/**
+ * @brief Start a frame in buf
+ */
+void wifi_raw_frame_init(wifi_raw_frame_t *f, void *buf, size_t cap);
+
+/**
+ * @brief Append a MAC header (duration and sequence zero)
+ *
+ * @param fc0 Frame control byte 0, e.g. WIFI_RAW_FC_BEACON
+ * @param da Receiver address, NULL = broadcast
+ * @param sa Transmitter address
+ * @param bssid BSSID, NULL = sa
+ * @return The header, or NULL on overflow
+ */
+wifi_raw_mac_hdr_t *wifi_raw_frame_hdr(wifi_raw_frame_t *f, uint8_t fc0, const uint8_t *da,
+                                       const uint8_t *sa, const uint8_t *bssid);
+
+/**
+ * @brief Start a broadcast beacon: header and fixed fields
+ *
+ * The timestamp is left zero for the driver to fill.
+ */
+wifi_raw_beacon_fixed_t *wifi_raw_frame_beacon(wifi_raw_frame_t *f, const uint8_t *bssid,
+                                               uint16_t interval_tu, uint16_t capability);
+
+/**
+ * @brief Start a broadcast probe request (elements follow)
+ */
+wifi_raw_mac_hdr_t *wifi_raw_frame_probe_req(wifi_raw_frame_t *f, const uint8_t *sa);
+
+/**
+ * @brief Start a vendor-specific action frame
+ *
+ * @param da Receiver address, NULL = broadcast
+ * @param sa Transmitter address, also used as BSSID
+ * @param oui Vendor OUI (3 bytes)
+ */
+wifi_raw_action_vendor_t *wifi_raw_frame_action_vendor(wifi_raw_frame_t *f, const uint8_t *da,
+                                                       const uint8_t *sa, const uint8_t *oui);
+
+/**
+ * @brief Reserve len bytes of frame body for the caller to fill
+ *
+ * @return Pointer into the frame buffer, or NULL on overflow
+ */
+uint8_t *wifi_raw_frame_reserve(wifi_raw_frame_t *f, size_t len);
+
+/**
+ * @brief Append an element header and reserve its body
+ *
+ * @return The element body, or NULL on overflow or len > 255
+ */
+uint8_t *wifi_raw_frame_ie(wifi_raw_frame_t *f, uint8_t id, size_t len);
+
+/**
+ * @brief Append an element with the given body
+ */
+bool wifi_raw_frame_ie_put(wifi_raw_frame_t *f, uint8_t id, const void *data, size_t len);
+
+/**
+ * @brief Append a vendor-specific element and reserve len bytes after the OUI
+ */
+uint8_t *wifi_raw_frame_vendor_ie(wifi_raw_frame_t *f, const uint8_t *oui, size_t len);
+
+/**
+ * @brief Frame length, or 0 if anything overflowed the buffer
+ */
+size_t wifi_raw_frame_len(const wifi_raw_frame_t *f);
+
+/**
+ * @brief Fields of a received frame, pointing into the frame
+ */
+typedef struct {
+    uint8_t type;           /**< 0=mgmt 1=ctrl 2=data */
+    uint8_t subtype;
+    const wifi_raw_mac_hdr_t *hdr;
+    const uint8_t *body;    /**< After the MAC header */
+    size_t body_len;
+    const uint8_t *ies;     /**< Elements of beacon/probe frames, else NULL */
+    size_t ies_len;
+} wifi_raw_frame_info_t;
+
+/**
+ * @brief Split a 3-address frame into header, body and elements
+ *
+ * @param frame Frame without FCS (or with it: trailing bytes only lengthen the body)
+ * @return false if shorter than a MAC header
+ */
+bool wifi_raw_frame_parse(const uint8_t *frame, size_t len, wifi_raw_frame_info_t *out);
+
+/**
+ * @brief Find the first element with the given ID
+ *
+ * @param ies Element list
+ * @param id Element ID
+ * @param body_len Set to the body length when found
+ * @return The element body, or NULL when absent or the list is malformed
+ *         before it
+ */
+const uint8_t *wifi_raw_ie_find(const uint8_t *ies, size_t len, uint8_t id, size_t *body_len);
+
+/**
+ * @brief Find the first vendor-specific element with the given OUI
+ *
+ * @return Body after the OUI, or NULL; body_len excludes the OUI
+ */
+const uint8_t *wifi_raw_vendor_ie_find(const uint8_t *ies, size_t len, const uint8_t *oui,
+                                       size_t *body_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_RAW_FRAME_H */
@@ -0,0 +1,294 @@
+/*
+ * WiFi Raw Layout - compile-time 802.11 frame layouts over wifi_raw_frame.h
+ *
+ * A frame type is a packed struct composed of the C header structs and a
+ * typed element list, so its size and every element offset are constant
+ * expressions:
+ *
+ *     using wifi_raw::layout::Beacon, wifi_raw::layout::Ssid, ...;
+ *     using MyBeacon = Beacon<Ssid<4>, SuppRates<4>, DsParams>;
+ *     static_assert(MyBeacon::size() == 51);
+ *
+ *     uint8_t buf[MyBeacon::size()];      // or a wifi_raw::Frame's buffer()
+ *     MyBeacon *b = MyBeacon::build(buf, bssid, 100, 0x0421);
+ *     memcpy(b->ie<0>().body, "test", 4);
+ *     b->ie<2>().body[0] = 6;
+ *
+ * build() writes the header and fixed fields with the C builder, and the
+ * element IDs and lengths from the types, straight into the caller's
+ * buffer; the caller fills the bodies in place.
+ *
+ * Header only, with no ESP-IDF dependencies, so it builds and runs on
+ * Linux like wifi_raw_frame.c.
+ */
+
+#ifndef WIFI_RAW_LAYOUT_HPP
+#define WIFI_RAW_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "wifi_raw_frame.h"
+
+namespace wifi_raw::layout {
+
+/* ─── Elements ─── */
+
+/**
+ * @brief Element with an N-byte body
+ */
+template <uint8_t Id, size_t N>
+struct __attribute__((packed)) Ie {
+    static_assert(N <= WIFI_RAW_IE_MAX_BODY, "element body is at most 255 bytes");
+    static constexpr size_t size() { return WIFI_RAW_IE_LEN(N); }
+
+    uint8_t id;
+    uint8_t len;
+    uint8_t body[N];
+
+    void init()
+    {
+        id = Id;
+        len = N;
+    }
+};
+
+/* Empty body, e.g. the wildcard SSID of a probe request */
+template <uint8_t Id>
+struct __attribute__((packed)) Ie<Id, 0> {
+    static constexpr size_t size() { return WIFI_RAW_IE_LEN(0); }
+
+    uint8_t id;
+    uint8_t len;
+
+    void init()
+    {
+        id = Id;
+        len = 0;
+    }
+};
+
+template <size_t N>
+using Ssid = Ie<WIFI_RAW_IE_SSID, N>;
+
+template <size_t N>
+using SuppRates = Ie<WIFI_RAW_IE_SUPP_RATES, N>;
+
+using DsParams = Ie<WIFI_RAW_IE_DS_PARAMS, 1>;
+
+/**
+ * @brief Vendor-specific element: OUI (as written, 0x021122 = 02:11:22) and N body bytes
+ */
+template <uint32_t Oui, size_t N>
+struct __attribute__((packed)) VendorIe {
+    static_assert(Oui <= 0xFFFFFF, "OUI is 3 bytes");
+    static_assert(N > 0 && 3 + N <= WIFI_RAW_IE_MAX_BODY, "vendor body is 1..252 bytes");
+    static constexpr size_t size() { return WIFI_RAW_VENDOR_IE_LEN(N); }
+
+    uint8_t id;
+    uint8_t len;
+    uint8_t oui[3];
+    uint8_t body[N];
+
+    void init()
+    {
+        id = WIFI_RAW_IE_VENDOR;
+        len = 3 + N;
+        oui[0] = (Oui >> 16) & 0xFF;
+        oui[1] = (Oui >> 8) & 0xFF;
+        oui[2] = Oui & 0xFF;
+    }
+};
+
+/**
+ * @brief Elements laid out back to back, in order
+ */
+template <typename... Ies>
+struct IeList;
+
+template <typename Head>
+struct __attribute__((packed)) IeList<Head> {
+    Head head;
+
+    static constexpr size_t size() { return Head::size(); }
+
+    template <size_t I>
+    static constexpr size_t offset()
+    {
+        static_assert(I == 0, "element index out of range");
+        return 0;
+    }
+
+    template <size_t I>
+    auto &get()
+    {
+        static_assert(I == 0, "element index out of range");
+        return head;
+    }
+
+    void init() { head.init(); }
+};
+
+template <typename Head, typename... Tail>
+struct __attribute__((packed)) IeList<Head, Tail...> {
+    Head head;
+    IeList<Tail...> tail;
+
+    static constexpr size_t size() { return Head::size() + IeList<Tail...>::size(); }
+
+    template <size_t I>
+    static constexpr size_t offset()
+    {
+        if constexpr (I == 0) {
+            return 0;
+        } else {
+            return Head::size() + IeList<Tail...>::template offset<I - 1>();
+        }
+    }
+
+    template <size_t I>
+    auto &get()
+    {
+        if constexpr (I == 0) {
+            return head;
+        } else {
+            return tail.template get<I - 1>();
+        }
+    }
+
+    void init()
+    {
+        head.init();
+        tail.init();
+    }
+};
+
+/* ─── Frames ─── */
+
+namespace detail {
+
+/* The layout at the start of buf once the C builder has written its
+ * fixed part, or nullptr if that failed or buf is short */
+template <typename L>
+L *place(std::span<uint8_t> buf, bool started)
+{
+    static_assert(sizeof(L) == L::size(), "layout has no padding");
+    if (!started || buf.size() < L::size()) {
+        return nullptr;
+    }
+    return reinterpret_cast<L *>(buf.data());
+}
+
+} // namespace detail
+
+/**
+ * @brief Broadcast beacon: MAC header, fixed fields, elements
+ */
+template <typename... Ies>
+struct __attribute__((packed)) Beacon {
+    static_assert(sizeof...(Ies) > 0, "a beacon carries at least the SSID element");
+
+    wifi_raw_mac_hdr_t hdr;
+    wifi_raw_beacon_fixed_t fixed;
+    IeList<Ies...> ies;
+
+    static constexpr size_t size() { return WIFI_RAW_BEACON_LEN(IeList<Ies...>::size()); }
+
+    /** Offset of element I from the start of the frame */
+    template <size_t I>
+    static constexpr size_t ie_offset()
+    {
+        return WIFI_RAW_BEACON_LEN(0) + IeList<Ies...>::template offset<I>();
+    }
+
+    template <size_t I>
+    auto &ie() { return ies.template get<I>(); }
+
+    /** Header, fixed fields and element headers; bodies are left to fill */
+    static Beacon *build(std::span<uint8_t> buf, const uint8_t *bssid, uint16_t interval_tu,
+                         uint16_t capability)
+    {
+        wifi_raw_frame_t f;
+        wifi_raw_frame_init(&f, buf.data(), buf.size());
+        bool started = buf.size() >= size() &&
+                       wifi_raw_frame_beacon(&f, bssid, interval_tu, capability) != nullptr;
+        Beacon *b = detail::place<Beacon>(buf, started);
+        if (b) {
+            b->ies.init();
+        }
+        return b;
+    }
+};
+
+/**
+ * @brief Broadcast probe request: MAC header, elements
+ */
+template <typename... Ies>
+struct __attribute__((packed)) ProbeReq {
+    static_assert(sizeof...(Ies) > 0, "a probe request carries at least the SSID element");
+
+    wifi_raw_mac_hdr_t hdr;
+    IeList<Ies...> ies;
+
+    static constexpr size_t size() { return WIFI_RAW_PROBE_REQ_LEN(IeList<Ies...>::size()); }
+
+    template <size_t I>
+    static constexpr size_t ie_offset()
+    {
+        return WIFI_RAW_PROBE_REQ_LEN(0) + IeList<Ies...>::template offset<I>();
+    }
+
+    template <size_t I>
+    auto &ie() { return ies.template get<I>(); }
+
+    static ProbeReq *build(std::span<uint8_t> buf, const uint8_t *sa)
+    {
+        wifi_raw_frame_t f;
+        wifi_raw_frame_init(&f, buf.data(), buf.size());
+        bool started = buf.size() >= size() && wifi_raw_frame_probe_req(&f, sa) != nullptr;
+        ProbeReq *p = detail::place<ProbeReq>(buf, started);
+        if (p) {
+            p->ies.init();
+        }
+        return p;
+    }
+};
+
+/**
+ * @brief Raw body bytes, for a frame body without its own struct
+ */
+template <size_t N>
+struct Bytes {
+    uint8_t data[N];
+};
+
+/**
+ * @brief Vendor-specific action frame with a packed Body struct
+ */
+template <typename Body>
+struct __attribute__((packed)) ActionVendor {
+    static_assert(std::is_trivially_copyable_v<Body> && alignof(Body) == 1,
+                  "body is a packed plain struct");
+
+    wifi_raw_mac_hdr_t hdr;
+    wifi_raw_action_vendor_t action;
+    Body body;
+
+    static constexpr size_t size() { return WIFI_RAW_ACTION_VENDOR_LEN(sizeof(Body)); }
+
+    /** da NULL = broadcast; sa is also the BSSID */
+    static ActionVendor *build(std::span<uint8_t> buf, const uint8_t *da, const uint8_t *sa,
+                               const uint8_t *oui)
+    {
+        wifi_raw_frame_t f;
+        wifi_raw_frame_init(&f, buf.data(), buf.size());
+        bool started = buf.size() >= size() &&
+                       wifi_raw_frame_action_vendor(&f, da, sa, oui) != nullptr;
+        return detail::place<ActionVendor>(buf, started);
+    }
+};
+
+} // namespace wifi_raw::layout
+
+#endif /* WIFI_RAW_LAYOUT_HPP */
@@ -0,0 +1,189 @@
+/*
+ * WiFi Raw Packet Injection/Monitoring Protocol
+ *
+ * Shared message definitions for CustomRpc communication between
+ * ESP32-P4 host and ESP32-C6 slave via esp-hosted.
+ */
+
+#ifndef WIFI_RAW_MSGS_H
+#define WIFI_RAW_MSGS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ─── Command Message IDs (Host → Slave) ─── */
+#define WIFI_RAW_MSG_SET_PROMISCUOUS    0x0100
+#define WIFI_RAW_MSG_SET_CHANNEL        0x0101
+#define WIFI_RAW_MSG_SET_FILTER         0x0102
+#define WIFI_RAW_MSG_80211_TX           0x0103
+#define WIFI_RAW_MSG_GET_FW_INFO        0x0104
+#define WIFI_RAW_MSG_OTA_Z_BEGIN        0x0105
+#define WIFI_RAW_MSG_OTA_Z_DATA         0x0106
+#define WIFI_RAW_MSG_OTA_Z_END          0x0107
+#define WIFI_RAW_MSG_OTA_Z_RESUME       0x0108
+#define WIFI_RAW_MSG_OTA_Z_DATA_CRC     0x0109
+#define WIFI_RAW_MSG_ECHO               0x010A
+#define WIFI_RAW_MSG_SET_TX_RATE        0x010B
+#define WIFI_RAW_MSG_80211_TX_RATE      0x010C
+#define WIFI_RAW_MSG_OTA_Z_ACTIVATE     0x010D
+
+/* ─── Response/Event Message IDs (Slave → Host) ─── */
+#define WIFI_RAW_MSG_CMD_RESPONSE       0x0180
+#define WIFI_RAW_MSG_FW_INFO            0x0181
+#define WIFI_RAW_MSG_OTA_Z_ACK          0x0182
+#define WIFI_RAW_MSG_ECHO_REPLY         0x0183
+#define WIFI_RAW_MSG_PROMISC_PKT        0x0200
+
+/* ─── Command Payloads (Host → Slave) ─── */
+
+typedef struct {
+    uint8_t enable;         /* 1 = enable, 0 = disable */
+} __attribute__((packed)) wifi_raw_cmd_set_promiscuous_t;
+
+typedef struct {
+    uint8_t primary;        /* Primary channel (1-14) */
+    uint8_t second;         /* Secondary channel: 0=none, 1=above, 2=below */
+} __attribute__((packed)) wifi_raw_cmd_set_channel_t;
+
+typedef struct {
+    uint32_t filter_mask;   /* wifi_promiscuous_filter_t filter bits */
+} __attribute__((packed)) wifi_raw_cmd_set_filter_t;
+
+typedef struct {
+    uint8_t ifx;            /* wifi_interface_t: 0=STA, 1=AP */
+    uint8_t en_sys_seq;     /* 1 = let driver set sequence number */
+    uint16_t data_len;      /* Length of 802.11 frame data */
+    uint8_t data[];         /* Raw 802.11 frame (flexible array) */
+} __attribute__((packed)) wifi_raw_cmd_80211_tx_t;
+
+/* Rate for injected frames, passed to esp_wifi_config_80211_tx_rate() */
+typedef struct {
+    uint8_t ifx;            /* wifi_interface_t: 0=STA, 1=AP */
+    uint8_t rate;           /* wifi_phy_rate_t */
+} __attribute__((packed)) wifi_raw_cmd_set_tx_rate_t;
+
+/* As WIFI_RAW_MSG_80211_TX, with a rate for this frame only. The slave
+ * reconfigures only when the rate differs from the last one applied
+ * (0xFF restores the SET_TX_RATE rate), so a stream at one rate costs
+ * no extra driver calls. */
+typedef struct {
+    uint8_t ifx;            /* wifi_interface_t: 0=STA, 1=AP */
+    uint8_t en_sys_seq;     /* 1 = let driver set sequence number */
+    uint8_t rate;           /* wifi_phy_rate_t, 0xFF = rate set by SET_TX_RATE */
+    uint16_t data_len;      /* Length of 802.11 frame data */
+    uint8_t data[];         /* Raw 802.11 frame (flexible array) */
+} __attribute__((packed)) wifi_raw_cmd_80211_tx_rate_t;
+
+/* WIFI_RAW_MSG_GET_FW_INFO has no payload; the slave answers with
+ * WIFI_RAW_MSG_FW_INFO instead of a CMD_RESPONSE */
+
+/*
+ * Streamed OTA: the host sends an LZFW image (lzfw.h) or a delta patch
+ * (fwdelta.h) in order; the slave tells them apart by the header magic.
+ * It opens its next OTA partition on BEGIN and feeds each DATA payload
+ * to a streaming decoder that writes the output into that partition
+ * (slave/components/wifi_raw_ota).
+ * A delta decoder reads the old image from the running partition. On END
+ * the slave checks length and CRC32, then selects the partition for
+ * boot. Every message gets a CMD_RESPONSE. ACTIVATE, accepted only after
+ * a successful END, is answered and then restarts the slave into the new
+ * image; the esp-hosted activate call knows nothing of these sessions.
+ *
+ * Resumable sessions: a slave that answers OTA_Z_RESUME also accepts a
+ * plain ESP image (magic 0xE9, written as-is) and DATA_CRC. It persists
+ * its write position and decoder state whenever the stream position
+ * crosses a multiple of checkpoint_len, keyed by total_len and
+ * stream_crc32. RESUME asks to continue at a checkpoint; the slave
+ * answers with an OTA_Z_ACK carrying the offset it continues from, or
+ * ESP_ERR_NOT_FOUND, after which the host sends BEGIN. DATA_CRC is
+ * answered with an OTA_Z_ACK instead of a CMD_RESPONSE. A repeated
+ * DATA_CRC for bytes already taken (its ACK was lost) is acknowledged
+ * again without decoding it twice.
+ */
+typedef struct {
+    uint32_t total_len;     /* Stream length including header */
+    uint32_t stream_crc32;  /* CRC32 of the whole stream, 0 = not resumable */
+    uint32_t checkpoint_len; /* Slave checkpoints every this many bytes */
+} __attribute__((packed)) wifi_raw_cmd_ota_z_begin_t;
+
+typedef struct {
+    uint32_t total_len;     /* Must match the interrupted BEGIN */
+    uint32_t stream_crc32;  /* Must match the interrupted BEGIN */
+    uint32_t offset;        /* Checkpoint the host wants to continue from */
+} __attribute__((packed)) wifi_raw_cmd_ota_z_resume_t;
+
+typedef struct {
+    uint32_t offset;        /* Stream offset of data[0], must be contiguous */
+    uint16_t data_len;      /* Length of data */
+    uint8_t data[];         /* Compressed stream bytes (flexible array) */
+} __attribute__((packed)) wifi_raw_cmd_ota_z_data_t;
+
+typedef struct {
+    uint32_t offset;        /* Stream offset of data[0] */
+    uint16_t data_len;      /* Length of data */
+    uint32_t crc32;         /* CRC32 of data */
+    uint8_t data[];         /* Stream bytes (flexible array) */
+} __attribute__((packed)) wifi_raw_cmd_ota_z_data_crc_t;
+
+/* WIFI_RAW_MSG_OTA_Z_END and WIFI_RAW_MSG_OTA_Z_ACTIVATE have no payload */
+
+/*
+ * Transport benchmark: the slave answers each ECHO at once with an
+ * ECHO_REPLY carrying the same seq, host timestamp and payload, plus its
+ * own esp_timer_get_time() on receive and just before sending.
+ */
+typedef struct {
+    uint32_t seq;           /* Host sequence number */
+    int64_t host_tx_us;     /* Host esp_timer_get_time() at send */
+    uint16_t data_len;      /* Length of data */
+    uint8_t data[];         /* Payload to echo (flexible array) */
+} __attribute__((packed)) wifi_raw_cmd_echo_t;
+
+/* ─── Response/Event Payloads (Slave → Host) ─── */
+
+typedef struct {
+    uint16_t cmd_msg_id;    /* Original command message ID */
+    int32_t status;         /* esp_err_t result */
+} __attribute__((packed)) wifi_raw_cmd_response_t;
+
+typedef struct {
+    uint8_t app_sha256[32]; /* esp_partition_get_sha256() of the running app */
+    char version[32];       /* esp_app_desc_t.version */
+    char project_name[32];  /* esp_app_desc_t.project_name */
+} __attribute__((packed)) wifi_raw_fw_info_t;
+
+typedef struct {
+    uint16_t cmd_msg_id;    /* OTA_Z_RESUME or OTA_Z_DATA_CRC */
+    int32_t status;         /* esp_err_t result */
+    uint32_t offset;        /* Next stream offset the slave expects */
+    uint32_t crc32;         /* DATA_CRC: CRC32 the slave computed over data */
+} __attribute__((packed)) wifi_raw_ota_z_ack_t;
+
+typedef struct {
+    uint32_t seq;           /* From the ECHO */
+    int64_t host_tx_us;     /* From the ECHO */
+    int64_t slave_rx_us;    /* Slave esp_timer_get_time() on receive */
+    int64_t slave_tx_us;    /* Slave esp_timer_get_time() before sending */
+    uint16_t data_len;      /* Length of data */
+    uint8_t data[];         /* The ECHO payload (flexible array) */
+} __attribute__((packed)) wifi_raw_echo_reply_t;
+
+typedef struct {
+    uint32_t type;          /* wifi_promiscuous_pkt_type_t */
+    int8_t rssi;            /* Signal strength */
+    uint8_t channel;        /* Channel packet was received on */
+    uint8_t rate;           /* Data rate */
+    uint8_t sig_mode;       /* 0=non-HT, 1=HT, 3=VHT */
+    uint32_t rx_state;      /* RX state (0 = no error) */
+    uint16_t data_len;      /* Length of 802.11 frame */
+    uint8_t data[];         /* Raw 802.11 frame (flexible array) */
+} __attribute__((packed)) wifi_raw_promisc_pkt_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_RAW_MSGS_H */
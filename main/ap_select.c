@@ -0,0 +1,94 @@
+/*
+ * AP Select - implementation
+ */
+
+#include <string.h>
+#include "ap_select.h"
+
+#define CONGESTION_MIN_RSSI     -85     /* BSSes weaker than this do not count */
+#define CONGESTION_CO_CHANNEL   4       /* Penalty per co-channel BSS */
+#define CONGESTION_OVERLAP      2       /* Penalty per overlapping-channel BSS */
+#define CONGESTION_MAX          24
+#define PREFERENCE_STEP         3       /* Bonus per position earlier in the list */
+
+static int16_t security_bonus(ap_select_sec_t sec)
+{
+    switch (sec) {
+    case AP_SEC_WPA3: return 6;
+    case AP_SEC_WPA2: return 4;
+    case AP_SEC_WPA:  return 0;
+    default:          return -10;
+    }
+}
+
+static int16_t congestion_penalty(const ap_select_scan_entry_t *scan, size_t n_scan,
+                                  size_t self)
+{
+    int16_t penalty = 0;
+    uint8_t ch = scan[self].channel;
+
+    for (size_t i = 0; i < n_scan; i++) {
+        if (i == self || scan[i].rssi < CONGESTION_MIN_RSSI) {
+            continue;
+        }
+        /* Every other BSS shares airtime, including our own extenders */
+        int d = (int)scan[i].channel - (int)ch;
+        if (d < 0) d = -d;
+        if (d == 0) {
+            penalty += CONGESTION_CO_CHANNEL;
+        } else if (d <= 4) {
+            penalty += CONGESTION_OVERLAP;
+        }
+    }
+    return (penalty > CONGESTION_MAX) ? CONGESTION_MAX : penalty;
+}
+
+static int find_candidate(const ap_select_candidate_t *candidates, size_t n,
+                          const char *ssid)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (candidates[i].ssid && strcmp(candidates[i].ssid, ssid) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+size_t ap_select_rank(const ap_select_scan_entry_t *scan, size_t n_scan,
+                      const ap_select_candidate_t *candidates, size_t n_candidates,
+                      ap_select_ranked_t *out, size_t max_out)
+{
+    size_t n_out = 0;
+
+    for (size_t i = 0; i < n_scan && i <= UINT8_MAX; i++) {
+        int c = find_candidate(candidates, n_candidates, scan[i].ssid);
+        if (c < 0 || scan[i].security < candidates[c].min_security) {
+            continue;
+        }
+
+        ap_select_ranked_t r = {
+            .candidate = (uint8_t)c,
+            .scan_index = (uint8_t)i,
+            .congestion = congestion_penalty(scan, n_scan, i),
+        };
+        int pref = (int)(n_candidates - 1 - (size_t)c) * PREFERENCE_STEP;
+        r.score = (int16_t)(scan[i].rssi - r.congestion +
+                            security_bonus(scan[i].security) + pref);
+
+        /* Insertion into the sorted output; drop the worst when full */
+        size_t pos = n_out;
+        while (pos > 0 && out[pos - 1].score < r.score) {
+            pos--;
+        }
+        if (pos >= max_out) {
+            continue;
+        }
+        size_t last = (n_out < max_out) ? n_out : max_out - 1;
+        memmove(&out[pos + 1], &out[pos], (last - pos) * sizeof(out[0]));
+        out[pos] = r;
+        if (n_out < max_out) {
+            n_out++;
+        }
+    }
+    return n_out;
+}
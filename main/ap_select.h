@@ -0,0 +1,91 @@
+/*
+ * AP Select - rank configured networks from a single scan
+ *
+ * Scores every scanned BSS whose SSID is in the candidate list by
+ * signal strength, channel congestion and security, and returns them
+ * best-first so the caller can connect to the top entry and fail over
+ * down the list without scanning again.
+ *
+ * Pure logic with no ESP-IDF dependencies: scan results are passed in
+ * as plain structs so the ranking can be exercised off-target.
+ */
+
+#ifndef AP_SELECT_H
+#define AP_SELECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum ranked entries returned */
+#define AP_SELECT_MAX_RANKED    8
+
+/**
+ * @brief Security level, ordered weakest to strongest
+ */
+typedef enum {
+    AP_SEC_OPEN = 0,
+    AP_SEC_WEP,
+    AP_SEC_WPA,
+    AP_SEC_WPA2,
+    AP_SEC_WPA3,
+} ap_select_sec_t;
+
+/**
+ * @brief One scanned BSS
+ */
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;        /**< Primary channel (1-14) */
+    int8_t rssi;            /**< dBm */
+    ap_select_sec_t security;
+} ap_select_scan_entry_t;
+
+/**
+ * @brief A network we are willing to join
+ */
+typedef struct {
+    const char *ssid;
+    ap_select_sec_t min_security;   /**< BSSes weaker than this are ignored */
+} ap_select_candidate_t;
+
+/**
+ * @brief A scored BSS, returned best-first
+ */
+typedef struct {
+    uint8_t candidate;      /**< Index into the candidate list */
+    uint8_t scan_index;     /**< Index into the scan results */
+    int16_t score;          /**< Higher is better */
+    int16_t congestion;     /**< Penalty applied for overlapping BSSes */
+} ap_select_ranked_t;
+
+/**
+ * @brief Rank scan results against the candidate list
+ *
+ * Score = RSSI (dBm) - congestion + security bonus + list-order bonus.
+ * Congestion counts other BSSes (any SSID) on the same channel at full
+ * weight and on overlapping 2.4 GHz channels (within 4) at half weight,
+ * ignoring very weak ones. Earlier candidates get a small bonus so
+ * configured preference breaks near-ties.
+ *
+ * @param scan Scan results
+ * @param n_scan Number of scan results
+ * @param candidates Acceptable networks, most preferred first
+ * @param n_candidates Number of candidates
+ * @param out Ranked output, best first
+ * @param max_out Capacity of out
+ * @return Number of ranked entries written
+ */
+size_t ap_select_rank(const ap_select_scan_entry_t *scan, size_t n_scan,
+                      const ap_select_candidate_t *candidates, size_t n_candidates,
+                      ap_select_ranked_t *out, size_t max_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AP_SELECT_H */
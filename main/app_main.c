@@ -7,6 +7,8 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -19,7 +21,21 @@
 #include "nvs_flash.h"
 #include "lwip/sockets.h"
 #include "lwip/netdb.h"
+#include "lwip/tcpip.h"
+#include "lwip/dhcp.h"
+#include "lwip/prot/dhcp.h"
 #include "wifi_raw.h"
+#include "tcp_probe.h"
+#include "mem_prof.h"
+#include "cpu_prof.h"
+#include "traffic_gen.h"
+#include "wifi_cache.h"
+#include "boot_timeline.h"
+#include "ap_select.h"
+#include "slave_ota.h"
+#include "rpc_bench.h"
+#include "inject_bench.h"
+#include "bin_log.h"
 #include "esp_partition.h"
 #include "esp_hosted_ota.h"
 
@@ -30,38 +46,176 @@ static const char *TAG = "wifi_stream";
 #define WIFI_SSID_FALLBACK    "MALARnet"
 #define WIFI_PASS             "Peter@1954"
 #define WIFI_MAX_RETRY        5
+#define WIFI_CONNECT_TIMEOUT_MS 30000
+#define WIFI_DIRECTED_TIMEOUT_MS 8000 /* Connect to a known BSSID/channel */
+#define WIFI_DIRECTED_MAX_RETRY 1
+#define WIFI_FAST_REUSE_IP    0      /* Reuse a cached lease younger than half its time instead of DHCP */
+#define WIFI_SCAN_MAX_APS     32
 
 /* ─── Streaming Configuration ─── */
 #define TARGET_IP             "192.168.1.128"
 #define TARGET_PORT           5001
 #define TX_PACKET_SIZE        1400   /* UDP (must fit in MTU) */
+#define TX_SIZE_SEED          0x1234ABCD
 #define TCP_TX_CHUNK_SIZE     16384  /* TCP (stack handles segmentation) */
 #define TEST_DURATION_SEC     30
 #define STATS_INTERVAL_MS     1000
+#define TX_WRITABLE_TIMEOUT_MS 100   /* select() timeout while send buffer is full */
+#define TASK_JOIN_TIMEOUT_MS  5000   /* Worker teardown, including the TCP drain */
+#define TCP_DRAIN_TIMEOUT_MS  3000   /* Wait for unacked data before close() */
+
+/* ─── Deferred Log Configuration ─── */
+#define BIN_LOG_RAW           0      /* 1 = BLOG hex records for tools/bin_log_decode */
+
+/* ─── TCP Soak Configuration ─── */
+#define SOAK_DURATION_SEC     0      /* 0 = disabled; e.g. (4 * 3600) for overnight runs */
+#define SOAK_STALL_SEC        5      /* Zero-progress seconds before a stall is declared */
+#define SOAK_REPORT_SEC       60     /* Summary line interval */
+
+/* ─── Slave OTA Configuration ─── */
+#define SLAVE_OTA_CHUNK_SIZE  1400   /* Bytes per esp_hosted_slave_ota_write() */
+#define SLAVE_OTA_RING_DEPTH  4      /* Chunk buffers between flash reader and writer */
+#define SLAVE_OTA_RETRIES     3      /* Resends of a failed chunk (resumable slaves) */
+#define SLAVE_OTA_CHECKPOINT  (64 * 1024)  /* Bytes between NVS resume checkpoints */
+
+/* ─── RPC Benchmark Configuration ─── */
+#define RPC_BENCH_ENABLE      1      /* CustomRpc echo sweep before the throughput tests */
+#define RPC_BENCH_MSGS        200    /* Echoes per (size, depth) point */
+#define RPC_BENCH_TIMEOUT_MS  1000   /* Reply timeout before an echo counts as lost */
+static const uint16_t s_rpc_bench_sizes[] = { 16, 64, 256, 1024, 1400 };
+static const uint8_t s_rpc_bench_depths[] = { 1, 2, 4, 8 };
+
+/* ─── Raw Injection Benchmark Configuration ─── */
+#define INJECT_BENCH_ENABLE   1      /* wifi_raw_80211_tx() sweep after the monitor test */
+#define INJECT_BENCH_TYPE     INJECT_FRAME_BEACON
+#define INJECT_BENCH_FRAMES   500    /* Frames per (size, rate) point */
+#define INJECT_BENCH_VERIFY   1      /* Count own frames via promiscuous RX */
+static const uint16_t s_inject_bench_sizes[] = { 64, 256, 1024, 1500 };
+static const uint32_t s_inject_bench_rates[] = { 0, 100, 1000 };  /* frames/s, 0 = unpaced */
+#define INJECT_LOOP_ENABLE    1      /* Inject-to-capture latency histogram */
+#define INJECT_LOOP_FRAMES    200    /* Tagged frames per (size, rate) point */
+static const uint16_t s_inject_loop_sizes[] = { 64, 1024 };
+static const uint32_t s_inject_loop_rates[] = { 10, 200, 0 };     /* Light to saturated load */
 
 /* ─── WiFi Event Handling ─── */
 static EventGroupHandle_t s_wifi_event_group;
 #define WIFI_CONNECTED_BIT    BIT0
 #define WIFI_FAIL_BIT         BIT1
 
+/* Networks to join, most preferred first. One scan ranks every BSS of
+ * these SSIDs; connection then walks the ranked list without rescanning. */
+static const ap_select_candidate_t s_wifi_candidates[] = {
+    { WIFI_SSID_PRIMARY,  AP_SEC_WPA2 },
+    { WIFI_SSID_FALLBACK, AP_SEC_WPA2 },
+};
+#define WIFI_CANDIDATE_COUNT  (sizeof(s_wifi_candidates) / sizeof(s_wifi_candidates[0]))
+
 static int s_retry_num = 0;
+static int s_max_retry = WIFI_MAX_RETRY;
 static char s_connected_ssid[33] = {0};
+static esp_netif_t *s_sta_netif = NULL;
+static const wifi_cache_t *s_static_lease = NULL;   /* Set during a fast reconnect */
+static bool s_connect_on_start = true;              /* false while scanning */
+
+/* Ranked scan results, kept for failover */
+static ap_select_scan_entry_t s_scan_entries[WIFI_SCAN_MAX_APS];
+static ap_select_ranked_t s_ranked[AP_SELECT_MAX_RANKED];
+static size_t s_ranked_count = 0;
+
+/* Apply the cached lease once associated; lwIP then posts GOT_IP without DHCP */
+static void apply_static_lease(const wifi_cache_t *lease)
+{
+    esp_netif_dhcpc_stop(s_sta_netif);
+
+    esp_netif_ip_info_t ip = {
+        .ip.addr = lease->ip,
+        .netmask.addr = lease->netmask,
+        .gw.addr = lease->gw,
+    };
+    esp_err_t ret = esp_netif_set_ip_info(s_sta_netif, &ip);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Static lease rejected: %s", esp_err_to_name(ret));
+        esp_netif_dhcpc_start(s_sta_netif);
+        return;
+    }
+
+    if (lease->dns) {
+        esp_netif_dns_info_t dns = { 0 };
+        dns.ip.u_addr.ip4.addr = lease->dns;
+        dns.ip.type = ESP_IPADDR_TYPE_V4;
+        esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+    }
+}
+
+/* A cached lease may be reused only while the server still holds it for
+ * us: before T1, half the lease time, when a DHCP client would renew.
+ * Its age comes from the RTC clock behind time(), which keeps counting
+ * across software resets, panics and deep sleep but restarts at power-on;
+ * after any other reset the age is unknown and DHCP runs. */
+static bool lease_usable(const wifi_cache_t *c)
+{
+    if (!WIFI_FAST_REUSE_IP || !c->ip || !c->lease_s) {
+        return false;
+    }
+    switch (esp_reset_reason()) {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_DEEPSLEEP:
+        break;
+    default:
+        ESP_LOGI(TAG, "Cached lease age unknown after this reset, using DHCP");
+        return false;
+    }
+
+    int64_t now = (int64_t)time(NULL);
+    if (now < c->acquired_s || now - c->acquired_s >= c->lease_s / 2) {
+        ESP_LOGI(TAG, "Cached lease past half of its %lu s, using DHCP",
+                 (unsigned long)c->lease_s);
+        return false;
+    }
+    return true;
+}
+
+/* Lease time the DHCP client is bound with, 0 if not bound */
+static uint32_t dhcp_lease_s(void)
+{
+    uint32_t lease = 0;
+    LOCK_TCPIP_CORE();
+    struct netif *nif = esp_netif_get_netif_impl(s_sta_netif);
+    struct dhcp *dhcp = nif ? netif_dhcp_data(nif) : NULL;
+    if (dhcp && dhcp->state == DHCP_STATE_BOUND) {
+        lease = dhcp->offered_t0_lease;
+    }
+    UNLOCK_TCPIP_CORE();
+    return lease;
+}
 
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                                int32_t event_id, void *event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
+        boot_timeline_mark(BOOT_MS_STA_START);
+        if (s_connect_on_start) {
+            esp_wifi_connect();
+        }
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        boot_timeline_mark(BOOT_MS_CONNECTED);
+        if (s_static_lease) {
+            apply_static_lease(s_static_lease);
+        }
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < WIFI_MAX_RETRY) {
+        if (s_retry_num < s_max_retry) {
             esp_wifi_connect();
             s_retry_num++;
-            ESP_LOGI(TAG, "Retry WiFi connection (%d/%d)...", s_retry_num, WIFI_MAX_RETRY);
+            ESP_LOGI(TAG, "Retry WiFi connection (%d/%d)...", s_retry_num, s_max_retry);
         } else {
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+        boot_timeline_mark(BOOT_MS_GOT_IP);
         ESP_LOGI(TAG, "[OK] Got IP: " IPSTR, IP2STR(&event->ip_info.ip));
         s_retry_num = 0;
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
@@ -69,35 +223,159 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
 }
 
 /* ─── WiFi STA Init & Connect ─── */
-static esp_err_t wifi_connect(const char *ssid)
+/* Connect to an SSID. With a `bssid`, connect directly to that BSS on
+ * `channel` (no full scan); with a `lease` (see lease_usable()), reuse it
+ * instead of DHCP. */
+static esp_err_t wifi_connect(const char *ssid, const uint8_t *bssid, uint8_t channel,
+                              const wifi_cache_t *lease)
 {
-    ESP_LOGI(TAG, "Connecting to '%s'...", ssid);
+    if (bssid) {
+        ESP_LOGI(TAG, "Connecting to '%s' (%02x:%02x:%02x:%02x:%02x:%02x ch:%d)%s...",
+                 ssid, bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5],
+                 channel, lease ? " with cached lease" : "");
+    } else {
+        ESP_LOGI(TAG, "Connecting to '%s'...", ssid);
+    }
 
     s_retry_num = 0;
+    s_max_retry = bssid ? WIFI_DIRECTED_MAX_RETRY : WIFI_MAX_RETRY;
+    s_static_lease = lease;
     xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT);
 
     wifi_config_t sta_config = {0};
     strncpy((char *)sta_config.sta.ssid, ssid, sizeof(sta_config.sta.ssid) - 1);
     strncpy((char *)sta_config.sta.password, WIFI_PASS, sizeof(sta_config.sta.password) - 1);
     sta_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+    if (bssid) {
+        sta_config.sta.bssid_set = true;
+        memcpy(sta_config.sta.bssid, bssid, sizeof(sta_config.sta.bssid));
+        sta_config.sta.channel = channel;
+        sta_config.sta.scan_method = WIFI_FAST_SCAN;
+    }
 
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &sta_config));
     ESP_ERROR_CHECK(esp_wifi_start());
 
     EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
         WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-        pdFALSE, pdFALSE, pdMS_TO_TICKS(30000));
+        pdFALSE, pdFALSE,
+        pdMS_TO_TICKS(bssid ? WIFI_DIRECTED_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS));
 
+    bool had_lease = (s_static_lease != NULL);
+    s_static_lease = NULL;
     if (bits & WIFI_CONNECTED_BIT) {
         strncpy(s_connected_ssid, ssid, sizeof(s_connected_ssid) - 1);
         return ESP_OK;
     }
 
-    /* Stop before trying next SSID */
+    /* Stop before trying next SSID; undo a static lease so DHCP runs next time */
     esp_wifi_stop();
+    if (had_lease) {
+        esp_netif_dhcpc_start(s_sta_netif);
+    }
     return ESP_FAIL;
 }
 
+static ap_select_sec_t auth_to_sec(wifi_auth_mode_t mode)
+{
+    switch (mode) {
+    case WIFI_AUTH_OPEN:          return AP_SEC_OPEN;
+    case WIFI_AUTH_WEP:           return AP_SEC_WEP;
+    case WIFI_AUTH_WPA_PSK:       return AP_SEC_WPA;
+    case WIFI_AUTH_WPA3_PSK:
+    case WIFI_AUTH_WPA2_WPA3_PSK: return AP_SEC_WPA3;
+    default:                      return AP_SEC_WPA2;
+    }
+}
+
+/* One all-channel scan, ranked against s_wifi_candidates into s_ranked */
+static size_t wifi_scan_rank(void)
+{
+    wifi_ap_record_t *records = malloc(WIFI_SCAN_MAX_APS * sizeof(wifi_ap_record_t));
+    if (!records) {
+        return 0;
+    }
+
+    s_connect_on_start = false;
+    ESP_ERROR_CHECK(esp_wifi_start());
+
+    int64_t t0 = esp_timer_get_time();
+    uint16_t n = 0;
+    esp_err_t ret = esp_wifi_scan_start(NULL, true);
+    if (ret == ESP_OK) {
+        n = WIFI_SCAN_MAX_APS;
+        ret = esp_wifi_scan_get_ap_records(&n, records);
+    }
+    esp_wifi_stop();
+    s_connect_on_start = true;
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Scan failed: %s", esp_err_to_name(ret));
+        free(records);
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+        ap_select_scan_entry_t *e = &s_scan_entries[i];
+        strncpy(e->ssid, (const char *)records[i].ssid, sizeof(e->ssid) - 1);
+        e->ssid[sizeof(e->ssid) - 1] = '\0';
+        memcpy(e->bssid, records[i].bssid, sizeof(e->bssid));
+        e->channel = records[i].primary;
+        e->rssi = records[i].rssi;
+        e->security = auth_to_sec(records[i].authmode);
+    }
+    free(records);
+
+    s_ranked_count = ap_select_rank(s_scan_entries, n, s_wifi_candidates,
+                                    WIFI_CANDIDATE_COUNT, s_ranked, AP_SELECT_MAX_RANKED);
+
+    ESP_LOGI(TAG, "[OK] Scan: %u BSS in %lu ms, %u candidate(s)", n,
+             (unsigned long)((esp_timer_get_time() - t0) / 1000), (unsigned)s_ranked_count);
+    for (size_t i = 0; i < s_ranked_count; i++) {
+        const ap_select_scan_entry_t *e = &s_scan_entries[s_ranked[i].scan_index];
+        ESP_LOGI(TAG, "  #%u '%s' ch:%d rssi:%d congestion:-%d score:%d",
+                 (unsigned)(i + 1), e->ssid, e->channel, e->rssi,
+                 s_ranked[i].congestion, s_ranked[i].score);
+    }
+    return s_ranked_count;
+}
+
+/* Remember the AP and lease we ended up with for the next boot. A reused
+ * lease keeps its original time and age; only DHCP starts a new one. */
+static void wifi_save_cache(uint32_t full_connect_ms, const wifi_cache_t *reused)
+{
+    wifi_ap_record_t ap;
+    esp_netif_ip_info_t ip;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK ||
+        esp_netif_get_ip_info(s_sta_netif, &ip) != ESP_OK) {
+        return;
+    }
+
+    wifi_cache_t cache = {
+        .channel = ap.primary,
+        .ip = ip.ip.addr,
+        .netmask = ip.netmask.addr,
+        .gw = ip.gw.addr,
+        .full_connect_ms = full_connect_ms,
+    };
+    strncpy(cache.ssid, s_connected_ssid, sizeof(cache.ssid) - 1);
+    memcpy(cache.bssid, ap.bssid, sizeof(cache.bssid));
+    if (reused) {
+        cache.lease_s = reused->lease_s;
+        cache.acquired_s = reused->acquired_s;
+    } else {
+        cache.lease_s = dhcp_lease_s();
+        cache.acquired_s = (int64_t)time(NULL);
+    }
+
+    esp_netif_dns_info_t dns;
+    if (esp_netif_get_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK) {
+        cache.dns = dns.ip.u_addr.ip4.addr;
+    }
+
+    wifi_cache_save(&cache);
+}
+
 static esp_err_t wifi_init_sta(void)
 {
     ESP_LOGI(TAG, "════════════════════════════════════════");
@@ -111,6 +389,7 @@ static esp_err_t wifi_init_sta(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    boot_timeline_mark(BOOT_MS_NVS);
     ESP_LOGI(TAG, "[OK] NVS initialized");
 
     /* Network stack */
@@ -122,7 +401,8 @@ static esp_err_t wifi_init_sta(void)
     ESP_LOGI(TAG, "[OK] Network stack initialized");
 
     /* Create STA netif */
-    esp_netif_create_default_wifi_sta();
+    s_sta_netif = esp_netif_create_default_wifi_sta();
+    boot_timeline_mark(BOOT_MS_NETIF);
     ESP_LOGI(TAG, "[OK] STA netif created");
 
     /* WiFi init */
@@ -132,6 +412,7 @@ static esp_err_t wifi_init_sta(void)
         ESP_LOGE(TAG, "[FAIL] esp_wifi_init: %s (0x%x)", esp_err_to_name(ret), ret);
         return ret;
     }
+    boot_timeline_mark(BOOT_MS_WIFI_INIT);
     ESP_LOGI(TAG, "[OK] esp_wifi_init succeeded");
 
     /* Register event handlers */
@@ -142,15 +423,38 @@ static esp_err_t wifi_init_sta(void)
     ESP_ERROR_CHECK(esp_event_handler_instance_register(
         IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, &inst_got_ip));
 
-    /* Set STA mode (HT20 — HT40 tested but worse due to 2.4GHz congestion) */
+    /* Set STA mode (HT20 — HT40 tested but worse due to 2.4GHz congestion).
+     * This is the first RPC to the C6, so it returns once SDIO is up. */
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    boot_timeline_mark(BOOT_MS_TRANSPORT);
     esp_wifi_set_ps(WIFI_PS_NONE);
 
-    /* Try primary SSID, then fallback */
-    ret = wifi_connect(WIFI_SSID_PRIMARY);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "'%s' failed, trying '%s'...", WIFI_SSID_PRIMARY, WIFI_SSID_FALLBACK);
-        ret = wifi_connect(WIFI_SSID_FALLBACK);
+    /* Try the cached AP first, then the best scanned candidates in rank order */
+    int64_t connect_start = esp_timer_get_time();
+    wifi_cache_t cache;
+    bool fast = (wifi_cache_load(&cache) == ESP_OK);
+    bool reuse_lease = fast && lease_usable(&cache);
+    if (fast) {
+        ret = wifi_connect(cache.ssid, cache.bssid, cache.channel,
+                           reuse_lease ? &cache : NULL);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Fast connect failed, falling back to full scan");
+            wifi_cache_erase();
+            fast = false;
+        }
+    }
+
+    if (!fast) {
+        ret = ESP_FAIL;
+        size_t ranked = wifi_scan_rank();
+        for (size_t i = 0; i < ranked && ret != ESP_OK; i++) {
+            const ap_select_scan_entry_t *e = &s_scan_entries[s_ranked[i].scan_index];
+            ret = wifi_connect(e->ssid, e->bssid, e->channel, NULL);
+        }
+        /* Nothing usable in the scan (e.g. hidden SSID): try each by name */
+        for (size_t i = 0; ranked == 0 && i < WIFI_CANDIDATE_COUNT && ret != ESP_OK; i++) {
+            ret = wifi_connect(s_wifi_candidates[i].ssid, NULL, 0, NULL);
+        }
     }
 
     if (ret != ESP_OK) {
@@ -158,6 +462,21 @@ static esp_err_t wifi_init_sta(void)
         return ret;
     }
 
+    uint32_t connect_ms = (uint32_t)((esp_timer_get_time() - connect_start) / 1000);
+    if (fast) {
+        if (cache.full_connect_ms > connect_ms) {
+            ESP_LOGI(TAG, "[OK] Time to IP: %lu ms (fast path, saved %lu ms vs full scan)",
+                     (unsigned long)connect_ms,
+                     (unsigned long)(cache.full_connect_ms - connect_ms));
+        } else {
+            ESP_LOGI(TAG, "[OK] Time to IP: %lu ms (fast path)", (unsigned long)connect_ms);
+        }
+        wifi_save_cache(cache.full_connect_ms, reuse_lease ? &cache : NULL);
+    } else {
+        ESP_LOGI(TAG, "[OK] Time to IP: %lu ms (full scan + DHCP)", (unsigned long)connect_ms);
+        wifi_save_cache(connect_ms, NULL);
+    }
+
     /* Read back info */
     uint8_t mac[6];
     if (esp_wifi_get_mac(WIFI_IF_STA, mac) == ESP_OK) {
@@ -175,17 +494,107 @@ static esp_err_t wifi_init_sta(void)
     return ESP_OK;
 }
 
+/* ─── UDP Size Distribution ───
+ * Fixed TX_PACKET_SIZE by default. Alternatives:
+ *   TRAFFIC_DIST_UNIFORM_INIT(64, 1472)
+ *   TRAFFIC_DIST_IMIX_INIT()
+ *   TRAFFIC_DIST_TABLE_INIT(s_udp_size_table, 3)  (see table below) */
+static const traffic_size_weight_t s_udp_size_table[] __attribute__((unused)) = {
+    { 64,   8 },    /* telemetry */
+    { 256,  1 },    /* control */
+    { 1400, 4 },    /* bulk */
+};
+static const traffic_dist_t s_udp_dist = TRAFFIC_DIST_FIXED_INIT(TX_PACKET_SIZE);
+
+/* ─── Worker Task Signaling ─── */
+static EventGroupHandle_t s_test_events;
+#define UDP_TX_DONE_BIT       BIT0   /* udp_tx task has torn down */
+#define TCP_TX_READY_BIT      BIT1   /* TCP stream connected */
+#define TCP_TX_DONE_BIT       BIT2   /* TCP stream task has torn down */
+
+/* Signal the waiting test, then end the calling worker */
+static void worker_exit(EventBits_t done_bit)
+{
+    xEventGroupSetBits(s_test_events, done_bit);
+    vTaskDelete(NULL);
+}
+
+/* Wait for a worker to finish its teardown after being told to stop */
+static bool worker_join(EventBits_t done_bit, const char *name)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_test_events, done_bit, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(TASK_JOIN_TIMEOUT_MS));
+    if (!(bits & done_bit)) {
+        ESP_LOGW(TAG, "%s did not stop within %d ms", name, TASK_JOIN_TIMEOUT_MS);
+        return false;
+    }
+    return true;
+}
+
 /* ─── Counters ─── */
 static volatile uint32_t s_tx_packets = 0;
 static volatile uint64_t s_tx_bytes = 0;
 static volatile uint32_t s_tx_errors = 0;
+static volatile uint32_t s_tx_waits = 0;
 static volatile bool s_tx_running = false;
+static volatile uint32_t s_tx_class_packets[TRAFFIC_CLASS_COUNT];
+static volatile uint64_t s_tx_class_bytes[TRAFFIC_CLASS_COUNT];
 
 static void reset_counters(void)
 {
     s_tx_packets = 0;
     s_tx_bytes = 0;
     s_tx_errors = 0;
+    s_tx_waits = 0;
+    for (int i = 0; i < TRAFFIC_CLASS_COUNT; i++) {
+        s_tx_class_packets[i] = 0;
+        s_tx_class_bytes[i] = 0;
+    }
+}
+
+static void print_tx_class_stats(int elapsed_sec)
+{
+    if (s_udp_dist.type == TRAFFIC_DIST_FIXED || elapsed_sec <= 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "  Per size class:");
+    for (int i = 0; i < TRAFFIC_CLASS_COUNT; i++) {
+        uint32_t pkts = s_tx_class_packets[i];
+        if (pkts == 0) continue;
+        uint64_t bytes = s_tx_class_bytes[i];
+        ESP_LOGI(TAG, "    %-9s %8lu pkts (%6.0f pps) | %6.2f Mbps | avg %4lu B",
+                 traffic_size_class_name(i), (unsigned long)pkts,
+                 (float)pkts / elapsed_sec, bytes * 8.0f / 1000000.0f / elapsed_sec,
+                 (unsigned long)(bytes / pkts));
+    }
+}
+
+/* ─── Send Backpressure ─── */
+/* Block until the socket can take more data instead of spinning on
+ * ENOMEM/EAGAIN. lwIP always reports UDP sockets as writable (ENOMEM
+ * there means the pbuf pool or netif queue is full), so when select()
+ * returns straight away the sender sleeps one tick to let the SDIO
+ * driver drain. */
+static void wait_writable(int sock, bool is_udp)
+{
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(sock, &wfds);
+    struct timeval tv = {
+        .tv_sec = 0,
+        .tv_usec = TX_WRITABLE_TIMEOUT_MS * 1000,
+    };
+
+    int n = select(sock + 1, NULL, &wfds, NULL, &tv);
+    if (n > 0 && is_udp) {
+        vTaskDelay(1);
+    }
+}
+
+static void set_nonblocking(int sock)
+{
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
 }
 
 static void print_tx_stats(int elapsed_sec)
@@ -193,12 +602,13 @@ static void print_tx_stats(int elapsed_sec)
     uint32_t pkts = s_tx_packets;
     uint64_t bytes = s_tx_bytes;
     uint32_t errs = s_tx_errors;
+    uint32_t waits = s_tx_waits;
     float mbps = (elapsed_sec > 0) ? (bytes * 8.0f / 1000000.0f / elapsed_sec) : 0;
     float pps = (elapsed_sec > 0) ? ((float)pkts / elapsed_sec) : 0;
 
-    ESP_LOGI(TAG, "  [%2ds] %6lu pkts (%4.0f pps) | %6.2f Mbps | err:%lu",
-             elapsed_sec,
-             (unsigned long)pkts, pps, mbps, (unsigned long)errs);
+    BIN_LOG("  [%2ds] %6lu pkts (%4.0f pps) | %6.2f Mbps | err:%lu wait:%lu",
+            elapsed_sec,
+            (unsigned long)pkts, pps, mbps, (unsigned long)errs, (unsigned long)waits);
 }
 
 /* ─── UDP Streaming Task ─── */
@@ -207,7 +617,7 @@ static void udp_stream_task(void *arg)
     int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock < 0) {
         ESP_LOGE(TAG, "socket() failed: %d", errno);
-        vTaskDelete(NULL);
+        worker_exit(UDP_TX_DONE_BIT);
         return;
     }
 
@@ -220,41 +630,57 @@ static void udp_stream_task(void *arg)
     /* Increase send buffer */
     int sndbuf = 65536;
     setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    set_nonblocking(sock);
 
-    uint8_t *buf = malloc(TX_PACKET_SIZE);
+    traffic_gen_t gen;
+    if (traffic_gen_init(&gen, &s_udp_dist, TX_SIZE_SEED) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid UDP size distribution");
+        close(sock);
+        worker_exit(UDP_TX_DONE_BIT);
+        return;
+    }
+
+    uint16_t max_size = traffic_gen_max_size(&gen);
+    uint8_t *buf = malloc(max_size);
     if (!buf) {
         close(sock);
-        vTaskDelete(NULL);
+        worker_exit(UDP_TX_DONE_BIT);
         return;
     }
     /* Fill with pattern */
-    for (int i = 0; i < TX_PACKET_SIZE; i++)
+    for (int i = 0; i < max_size; i++)
         buf[i] = (uint8_t)(i & 0xFF);
 
-    ESP_LOGI(TAG, "UDP stream started -> %s:%d (%d byte packets)",
-             TARGET_IP, TARGET_PORT, TX_PACKET_SIZE);
+    ESP_LOGI(TAG, "UDP stream started -> %s:%d (%s sizes, max %u bytes)",
+             TARGET_IP, TARGET_PORT, traffic_gen_name(&gen), max_size);
 
+    uint16_t len = traffic_gen_next(&gen);
     while (s_tx_running) {
-        int sent = sendto(sock, buf, TX_PACKET_SIZE, 0,
+        int sent = sendto(sock, buf, len, 0,
                           (struct sockaddr *)&dest, sizeof(dest));
         if (sent > 0) {
+            traffic_size_class_t cls = traffic_size_class(len);
             s_tx_packets++;
             s_tx_bytes += sent;
+            s_tx_class_packets[cls]++;
+            s_tx_class_bytes[cls] += sent;
+            len = traffic_gen_next(&gen);
+        } else if (errno == ENOMEM || errno == EAGAIN) {
+            s_tx_waits++;
+            wait_writable(sock, true);
         } else {
             s_tx_errors++;
-            if (errno == ENOMEM || errno == EAGAIN) {
-                taskYIELD();
-            }
         }
     }
 
     free(buf);
     close(sock);
     ESP_LOGI(TAG, "UDP stream task stopped");
-    vTaskDelete(NULL);
+    worker_exit(UDP_TX_DONE_BIT);
 }
 
-static void test_udp_stream(void)
+/* Returns false if the worker is still running after the join timeout */
+static bool test_udp_stream(void)
 {
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "════════════════════════════════════════");
@@ -263,17 +689,24 @@ static void test_udp_stream(void)
 
     reset_counters();
     s_tx_running = true;
+    xEventGroupClearBits(s_test_events, UDP_TX_DONE_BIT);
+
+    cpu_prof_begin();
 
     xTaskCreatePinnedToCore(udp_stream_task, "udp_tx", 4096, NULL,
                             configMAX_PRIORITIES - 2, NULL, 0);
 
+    TickType_t wake = xTaskGetTickCount();
     for (int sec = 1; sec <= TEST_DURATION_SEC; sec++) {
-        vTaskDelay(pdMS_TO_TICKS(STATS_INTERVAL_MS));
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(STATS_INTERVAL_MS));
         print_tx_stats(sec);
     }
 
+    cpu_prof_end(s_tx_bytes, s_tx_packets);
+    bin_log_flush();
+    mem_prof_sample_stacks();
     s_tx_running = false;
-    vTaskDelay(pdMS_TO_TICKS(200));
+    bool joined = worker_join(UDP_TX_DONE_BIT, "udp_tx");
 
     float mbps = s_tx_bytes * 8.0f / 1000000.0f / TEST_DURATION_SEC;
 
@@ -281,24 +714,50 @@ static void test_udp_stream(void)
     ESP_LOGI(TAG, "╔═══════════════════════════════════════════════╗");
     ESP_LOGI(TAG, "║  RESULT: %.2f Mbps (%lu pkts, %lu err)  ║",
              mbps, (unsigned long)s_tx_packets, (unsigned long)s_tx_errors);
+    ESP_LOGI(TAG, "║  Backpressure waits: %lu                  ║",
+             (unsigned long)s_tx_waits);
     ESP_LOGI(TAG, "║  Target: %s:%d via '%s'  ║",
              TARGET_IP, TARGET_PORT, s_connected_ssid);
     ESP_LOGI(TAG, "╚═══════════════════════════════════════════════╝");
+    print_tx_class_stats(TEST_DURATION_SEC);
+    cpu_prof_report("UDP");
+    return joined;
 }
 
 /* ─── TCP Streaming Task ─── */
 static volatile uint32_t s_tcp_tx_packets = 0;
 static volatile uint64_t s_tcp_tx_bytes = 0;
 static volatile uint32_t s_tcp_tx_errors = 0;
+static volatile uint32_t s_tcp_tx_waits = 0;
 static volatile bool s_tcp_tx_running = false;
 
+/* Let queued data reach the receiver before close(), so the next phase
+ * starts on an idle link */
+static void tcp_drain(void)
+{
+    struct in_addr remote;
+    inet_aton(TARGET_IP, &remote);
+    int64_t deadline = esp_timer_get_time() + TCP_DRAIN_TIMEOUT_MS * 1000LL;
+
+    tcp_probe_snapshot_t snap;
+    while (tcp_probe_sample(remote.s_addr, TARGET_PORT + 1, &snap) == ESP_OK &&
+           (snap.unsent || snap.unacked)) {
+        if (esp_timer_get_time() >= deadline) {
+            ESP_LOGW(TAG, "TCP drain timeout: %u unsent, %u unacked segments",
+                     snap.unsent, snap.unacked);
+            break;
+        }
+        vTaskDelay(1);
+    }
+}
+
 static void tcp_stream_task(void *arg)
 {
     int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (sock < 0) {
         ESP_LOGE(TAG, "TCP socket() failed: %d", errno);
         s_tcp_tx_running = false;
-        vTaskDelete(NULL);
+        worker_exit(TCP_TX_DONE_BIT);
         return;
     }
 
@@ -336,16 +795,18 @@ static void tcp_stream_task(void *arg)
         ESP_LOGE(TAG, "TCP connect failed after 10 attempts. Start receiver: iperf3 -s -p 5002");
         if (sock >= 0) close(sock);
         s_tcp_tx_running = false;
-        vTaskDelete(NULL);
+        worker_exit(TCP_TX_DONE_BIT);
         return;
     }
     ESP_LOGI(TAG, "TCP connected!");
+    set_nonblocking(sock);
+    xEventGroupSetBits(s_test_events, TCP_TX_READY_BIT);
 
     uint8_t *buf = malloc(TCP_TX_CHUNK_SIZE);
     if (!buf) {
         close(sock);
         s_tcp_tx_running = false;
-        vTaskDelete(NULL);
+        worker_exit(TCP_TX_DONE_BIT);
         return;
     }
     for (int i = 0; i < TCP_TX_CHUNK_SIZE; i++)
@@ -356,59 +817,92 @@ static void tcp_stream_task(void *arg)
         if (sent > 0) {
             s_tcp_tx_packets++;
             s_tcp_tx_bytes += sent;
+        } else if (errno == ENOMEM || errno == EAGAIN) {
+            s_tcp_tx_waits++;
+            wait_writable(sock, false);
         } else {
             s_tcp_tx_errors++;
-            if (errno == ENOMEM || errno == EAGAIN) {
-                taskYIELD();
-            } else {
-                ESP_LOGE(TAG, "TCP send error: %d", errno);
-                break;
-            }
+            ESP_LOGE(TAG, "TCP send error: %d", errno);
+            break;
         }
     }
+    s_tcp_tx_running = false;
 
+    tcp_drain();
     free(buf);
     close(sock);
     ESP_LOGI(TAG, "TCP stream task stopped");
-    vTaskDelete(NULL);
+    worker_exit(TCP_TX_DONE_BIT);
 }
 
-static void test_tcp_stream(void)
+/* Start the TCP stream task; returns once it is connected (true) or has
+ * given up (false) */
+static bool tcp_stream_start(const char *name)
 {
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "════════════════════════════════════════");
-    ESP_LOGI(TAG, "  TCP Stream to %s:%d (%ds)", TARGET_IP, TARGET_PORT + 1, TEST_DURATION_SEC);
-    ESP_LOGI(TAG, "════════════════════════════════════════");
-
     s_tcp_tx_packets = 0;
     s_tcp_tx_bytes = 0;
     s_tcp_tx_errors = 0;
+    s_tcp_tx_waits = 0;
     s_tcp_tx_running = true;
+    xEventGroupClearBits(s_test_events, TCP_TX_READY_BIT | TCP_TX_DONE_BIT);
 
-    xTaskCreatePinnedToCore(tcp_stream_task, "tcp_tx", 4096, NULL,
+    xTaskCreatePinnedToCore(tcp_stream_task, name, 4096, NULL,
                             configMAX_PRIORITIES - 2, NULL, 0);
 
-    /* Wait a moment for connection */
-    vTaskDelay(pdMS_TO_TICKS(500));
-    if (!s_tcp_tx_running) {
+    /* The task's connect retries are bounded, so one of the bits comes */
+    EventBits_t bits = xEventGroupWaitBits(s_test_events, TCP_TX_READY_BIT | TCP_TX_DONE_BIT,
+                                           pdFALSE, pdFALSE, portMAX_DELAY);
+    return (bits & TCP_TX_READY_BIT) && !(bits & TCP_TX_DONE_BIT);
+}
+
+/* Wait one stats interval; false if the stream task exited meanwhile */
+static bool tcp_stream_wait(TickType_t *wake)
+{
+    TickType_t next = *wake + pdMS_TO_TICKS(STATS_INTERVAL_MS);
+    TickType_t now = xTaskGetTickCount();
+    TickType_t left = (int32_t)(next - now) > 0 ? next - now : 0;
+    *wake = next;
+    EventBits_t bits = xEventGroupWaitBits(s_test_events, TCP_TX_DONE_BIT,
+                                           pdFALSE, pdFALSE, left);
+    return !(bits & TCP_TX_DONE_BIT);
+}
+
+/* Returns false if the worker is still running after the join timeout */
+static bool test_tcp_stream(void)
+{
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+    ESP_LOGI(TAG, "  TCP Stream to %s:%d (%ds)", TARGET_IP, TARGET_PORT + 1, TEST_DURATION_SEC);
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+
+    if (!tcp_stream_start("tcp_tx")) {
         ESP_LOGE(TAG, "TCP connection failed, skipping test");
-        return;
+        return true;
     }
 
+    cpu_prof_begin();
+    uint64_t bytes_start = s_tcp_tx_bytes;
+    uint32_t pkts_start = s_tcp_tx_packets;
+
+    TickType_t wake = xTaskGetTickCount();
     for (int sec = 1; sec <= TEST_DURATION_SEC; sec++) {
-        vTaskDelay(pdMS_TO_TICKS(STATS_INTERVAL_MS));
-        if (!s_tcp_tx_running) break;
+        if (!tcp_stream_wait(&wake)) break;
         uint64_t bytes = s_tcp_tx_bytes;
         uint32_t pkts = s_tcp_tx_packets;
         uint32_t errs = s_tcp_tx_errors;
+        uint32_t waits = s_tcp_tx_waits;
         float mbps = (sec > 0) ? (bytes * 8.0f / 1000000.0f / sec) : 0;
         float pps = (sec > 0) ? ((float)pkts / sec) : 0;
-        ESP_LOGI(TAG, "  [%2ds] %6lu pkts (%4.0f pps) | %6.2f Mbps | err:%lu",
-                 sec, (unsigned long)pkts, pps, mbps, (unsigned long)errs);
+        BIN_LOG("  [%2ds] %6lu pkts (%4.0f pps) | %6.2f Mbps | err:%lu wait:%lu",
+                sec, (unsigned long)pkts, pps, mbps, (unsigned long)errs,
+                (unsigned long)waits);
     }
 
+    cpu_prof_end(s_tcp_tx_bytes - bytes_start, s_tcp_tx_packets - pkts_start);
+    bin_log_flush();
+    mem_prof_sample_stacks();
     s_tcp_tx_running = false;
-    vTaskDelay(pdMS_TO_TICKS(500));
+    bool joined = worker_join(TCP_TX_DONE_BIT, "tcp_tx");
 
     float mbps = s_tcp_tx_bytes * 8.0f / 1000000.0f / TEST_DURATION_SEC;
 
@@ -416,9 +910,100 @@ static void test_tcp_stream(void)
     ESP_LOGI(TAG, "╔═══════════════════════════════════════════════╗");
     ESP_LOGI(TAG, "║  TCP RESULT: %.2f Mbps (%lu pkts, %lu err)  ║",
              mbps, (unsigned long)s_tcp_tx_packets, (unsigned long)s_tcp_tx_errors);
+    ESP_LOGI(TAG, "║  Backpressure waits: %lu                  ║",
+             (unsigned long)s_tcp_tx_waits);
     ESP_LOGI(TAG, "║  Target: %s:%d via '%s'  ║",
              TARGET_IP, TARGET_PORT + 1, s_connected_ssid);
     ESP_LOGI(TAG, "╚═══════════════════════════════════════════════╝");
+    cpu_prof_report("TCP");
+    return joined;
+}
+
+/* ─── TCP Soak Test ─── */
+/* Returns false if the worker is still running after the join timeout */
+static bool test_tcp_soak(void)
+{
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+    ESP_LOGI(TAG, "  TCP Soak to %s:%d (%lus, stall after %ds)",
+             TARGET_IP, TARGET_PORT + 1, (unsigned long)SOAK_DURATION_SEC, SOAK_STALL_SEC);
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+
+    struct in_addr remote;
+    inet_aton(TARGET_IP, &remote);
+
+    tcp_probe_ring_reset();
+    if (!tcp_stream_start("tcp_soak")) {
+        ESP_LOGE(TAG, "TCP connection failed, skipping soak");
+        return true;
+    }
+
+    uint32_t stalls = 0;
+    uint32_t idle_sec = 0;
+    uint32_t longest_stall_sec = 0;
+    uint64_t last_bytes = 0;
+    int64_t start_us = esp_timer_get_time();
+    TickType_t wake = xTaskGetTickCount();
+
+    for (uint32_t sec = 1; sec <= SOAK_DURATION_SEC; sec++) {
+        bool alive = tcp_stream_wait(&wake);
+
+        tcp_probe_snapshot_t snap = {0};
+        bool have_pcb = tcp_probe_sample(remote.s_addr, TARGET_PORT + 1, &snap) == ESP_OK;
+        snap.t_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
+        snap.app_bytes = s_tcp_tx_bytes;
+        tcp_probe_ring_push(&snap);
+
+        if (snap.app_bytes == last_bytes) {
+            idle_sec++;
+            if (idle_sec == SOAK_STALL_SEC) {
+                stalls++;
+                ESP_LOGW(TAG, "  [%lus] STALL #%lu: no progress for %ds%s",
+                         (unsigned long)sec, (unsigned long)stalls, SOAK_STALL_SEC,
+                         have_pcb ? "" : " (pcb gone)");
+                tcp_probe_ring_dump("stall");
+            }
+        } else {
+            if (idle_sec >= SOAK_STALL_SEC) {
+                ESP_LOGW(TAG, "  [%lus] stall recovered after %lus",
+                         (unsigned long)sec, (unsigned long)idle_sec);
+            }
+            if (idle_sec > longest_stall_sec) longest_stall_sec = idle_sec;
+            idle_sec = 0;
+        }
+        last_bytes = snap.app_bytes;
+
+        if (!alive) {
+            ESP_LOGE(TAG, "  [%lus] TCP stream task exited", (unsigned long)sec);
+            tcp_probe_ring_dump("stream exit");
+            break;
+        }
+
+        if ((sec % SOAK_REPORT_SEC) == 0) {
+            float mbps = snap.app_bytes * 8.0f / 1000000.0f / sec;
+            ESP_LOGI(TAG, "  [%5lus] %6.2f Mbps avg | stalls:%lu | err:%lu wait:%lu",
+                     (unsigned long)sec, mbps, (unsigned long)stalls,
+                     (unsigned long)s_tcp_tx_errors, (unsigned long)s_tcp_tx_waits);
+            tcp_probe_log(&snap);
+        }
+    }
+    if (idle_sec > longest_stall_sec) longest_stall_sec = idle_sec;
+
+    mem_prof_sample_stacks();
+    s_tcp_tx_running = false;
+    bool joined = worker_join(TCP_TX_DONE_BIT, "tcp_soak");
+
+    uint32_t elapsed = (uint32_t)((esp_timer_get_time() - start_us) / 1000000);
+    float mbps = (elapsed > 0) ? s_tcp_tx_bytes * 8.0f / 1000000.0f / elapsed : 0;
+
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "╔═══════════════════════════════════════════════╗");
+    ESP_LOGI(TAG, "║  SOAK RESULT: %.2f Mbps over %lus           ║",
+             mbps, (unsigned long)elapsed);
+    ESP_LOGI(TAG, "║  Stalls: %lu (longest %lus)                  ║",
+             (unsigned long)stalls, (unsigned long)longest_stall_sec);
+    ESP_LOGI(TAG, "╚═══════════════════════════════════════════════╝");
+    return joined;
 }
 
 /* ─── Packet Monitor Test ─── */
@@ -426,6 +1011,7 @@ static volatile uint32_t s_mon_mgmt = 0;
 static volatile uint32_t s_mon_ctrl = 0;
 static volatile uint32_t s_mon_data = 0;
 static volatile uint32_t s_mon_misc = 0;
+static volatile uint64_t s_mon_bytes = 0;
 
 static void monitor_rx_cb(const wifi_raw_rx_pkt_t *pkt)
 {
@@ -436,6 +1022,7 @@ static void monitor_rx_cb(const wifi_raw_rx_pkt_t *pkt)
         case 2: s_mon_data++; break;  /* WIFI_PKT_DATA */
         default: s_mon_misc++; break; /* WIFI_PKT_MISC */
     }
+    s_mon_bytes += pkt->payload_len;
 
     /* Log first bytes of management frames for beacon/probe detection */
     if (pkt->type == 0 && pkt->payload_len >= 24) {
@@ -453,8 +1040,8 @@ static void monitor_rx_cb(const wifi_raw_rx_pkt_t *pkt)
         }
         /* Only log non-beacon frames or every 100th beacon to avoid flooding */
         if (subtype != 8 || (s_mon_mgmt % 100) == 1) {
-            ESP_LOGI("monitor", "MGMT %s ch:%d rssi:%d len:%d",
-                     name, pkt->channel, pkt->rssi, pkt->payload_len);
+            BIN_LOG("MGMT %s ch:%d rssi:%d len:%d",
+                    name, pkt->channel, pkt->rssi, pkt->payload_len);
         }
     }
 }
@@ -487,6 +1074,7 @@ static void test_packet_monitor(void)
     s_mon_ctrl = 0;
     s_mon_data = 0;
     s_mon_misc = 0;
+    s_mon_bytes = 0;
 
     ret = wifi_raw_set_promiscuous(true);
     if (ret != ESP_OK) {
@@ -494,16 +1082,22 @@ static void test_packet_monitor(void)
         return;
     }
     ESP_LOGI(TAG, "Promiscuous mode ENABLED - capturing packets...");
+    cpu_prof_begin();
 
-    /* Monitor for 10 seconds with stats every second */
+    /* Monitor for 10 seconds with stats every second; the period holds
+     * however long each stats line takes */
+    TickType_t wake = xTaskGetTickCount();
     for (int sec = 1; sec <= 10; sec++) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        ESP_LOGI(TAG, "  [%2ds] mgmt:%lu ctrl:%lu data:%lu misc:%lu",
-                 sec,
-                 (unsigned long)s_mon_mgmt, (unsigned long)s_mon_ctrl,
-                 (unsigned long)s_mon_data, (unsigned long)s_mon_misc);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(1000));
+        BIN_LOG("  [%2ds] mgmt:%lu ctrl:%lu data:%lu misc:%lu",
+                sec,
+                (unsigned long)s_mon_mgmt, (unsigned long)s_mon_ctrl,
+                (unsigned long)s_mon_data, (unsigned long)s_mon_misc);
     }
 
+    cpu_prof_end(s_mon_bytes, s_mon_mgmt + s_mon_ctrl + s_mon_data + s_mon_misc);
+    bin_log_flush();
+
     /* Disable promiscuous mode */
     ret = wifi_raw_set_promiscuous(false);
     if (ret != ESP_OK) {
@@ -518,6 +1112,68 @@ static void test_packet_monitor(void)
              (unsigned long)s_mon_mgmt, (unsigned long)s_mon_ctrl,
              (unsigned long)s_mon_data, (unsigned long)s_mon_misc);
     ESP_LOGI(TAG, "╚═══════════════════════════════════════════════╝");
+    cpu_prof_report("Monitor");
+}
+
+/* ─── RPC Echo Benchmark ─── */
+static void test_rpc_bench(void)
+{
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+    ESP_LOGI(TAG, "  RPC Echo Benchmark (CustomRpc baseline)");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+
+    esp_err_t ret = wifi_raw_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "wifi_raw_init failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    rpc_bench_config_t cfg = {
+        .sizes = s_rpc_bench_sizes,
+        .n_sizes = sizeof(s_rpc_bench_sizes) / sizeof(s_rpc_bench_sizes[0]),
+        .depths = s_rpc_bench_depths,
+        .n_depths = sizeof(s_rpc_bench_depths) / sizeof(s_rpc_bench_depths[0]),
+        .msgs_per_point = RPC_BENCH_MSGS,
+        .timeout_ms = RPC_BENCH_TIMEOUT_MS,
+    };
+    rpc_bench_run(&cfg);
+}
+
+/* ─── Raw Injection Benchmark ─── */
+static void test_inject_bench(void)
+{
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+    ESP_LOGI(TAG, "  Phase 4b: Raw Injection Benchmark");
+    ESP_LOGI(TAG, "════════════════════════════════════════");
+
+    esp_err_t ret = wifi_raw_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "wifi_raw_init failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    inject_bench_config_t cfg = {
+        .type = INJECT_BENCH_TYPE,
+        .ifx = WIFI_IF_STA,
+        .sizes = s_inject_bench_sizes,
+        .n_sizes = sizeof(s_inject_bench_sizes) / sizeof(s_inject_bench_sizes[0]),
+        .rates = s_inject_bench_rates,
+        .n_rates = sizeof(s_inject_bench_rates) / sizeof(s_inject_bench_rates[0]),
+        .frames_per_point = INJECT_BENCH_FRAMES,
+        .verify = INJECT_BENCH_VERIFY,
+    };
+    inject_bench_run(&cfg);
+
+    if (INJECT_LOOP_ENABLE) {
+        cfg.sizes = s_inject_loop_sizes;
+        cfg.n_sizes = sizeof(s_inject_loop_sizes) / sizeof(s_inject_loop_sizes[0]);
+        cfg.rates = s_inject_loop_rates;
+        cfg.n_rates = sizeof(s_inject_loop_rates) / sizeof(s_inject_loop_rates[0]);
+        cfg.frames_per_point = INJECT_LOOP_FRAMES;
+        inject_bench_loopback_run(&cfg);
+    }
 }
 
 /* ─── Slave OTA Update ─── */
@@ -534,101 +1190,84 @@ static void try_slave_ota(void)
         return;
     }
 
-    /* Check if partition has valid data (first 4 bytes = ESP image magic 0xE9) */
-    uint8_t magic;
-    esp_partition_read(part, 0, &magic, 1);
-    if (magic != 0xE9) {
-        ESP_LOGI(TAG, "  slave_fw partition empty (magic=0x%02x), skipping OTA", magic);
-        return;
-    }
-
-    /* Read image size from header (bytes 16-19 in esp_image_header_t contain segment count,
-     * but we'll just send the whole partition — the slave validates internally) */
-    ESP_LOGI(TAG, "  Found slave firmware in partition (%lu bytes), starting OTA...",
-             (unsigned long)part->size);
-
-    esp_err_t ret = esp_hosted_slave_ota_begin();
+    /* Mapped in place when MMU pages allow, so OTA writes send from flash */
+    slave_ota_src_t src;
+    esp_err_t ret = slave_ota_src_partition(&src, part);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "  OTA begin failed: %s", esp_err_to_name(ret));
         return;
     }
 
-    /* Send firmware in 1400-byte chunks */
-    const size_t chunk_size = 1400;
-    uint8_t *buf = malloc(chunk_size);
-    if (!buf) {
-        ESP_LOGE(TAG, "  OTA malloc failed");
-        esp_hosted_slave_ota_end();
-        return;
+    /* ESP image (magic 0xE9), LZFW-compressed image or delta patch */
+    uint8_t sha256[32];
+    ret = slave_ota_image_sha256(&src, sha256);
+    bool have_sha = (ret == ESP_OK);
+    if (ret == ESP_ERR_NOT_FOUND) {
+        ESP_LOGI(TAG, "  slave_fw partition holds no image, skipping OTA");
+        goto out;
     }
-
-    /* Find actual firmware size from image header */
-    uint8_t header[24];
-    esp_partition_read(part, 0, header, sizeof(header));
-    /* ESP image: total size is not in header, scan until we find 0xFF padding.
-     * Simpler: just send until we hit all-0xFF blocks or reach partition end. */
-    size_t total_sent = 0;
-    bool done = false;
-    for (size_t offset = 0; offset < part->size && !done; offset += chunk_size) {
-        size_t to_read = (offset + chunk_size <= part->size) ? chunk_size : (part->size - offset);
-        esp_partition_read(part, offset, buf, to_read);
-
-        /* Check if this block is all 0xFF (erased flash = end of firmware) */
-        bool all_ff = true;
-        for (size_t i = 0; i < to_read; i++) {
-            if (buf[i] != 0xFF) { all_ff = false; break; }
-        }
-        if (all_ff && offset > 0x1000) {
-            done = true;
-            break;
-        }
-
-        ret = esp_hosted_slave_ota_write(buf, to_read);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "  OTA write failed at offset %u: %s",
-                     (unsigned)offset, esp_err_to_name(ret));
-            free(buf);
-            esp_hosted_slave_ota_end();
-            return;
-        }
-        total_sent += to_read;
-
-        if ((offset % (100 * chunk_size)) == 0) {
-            ESP_LOGI(TAG, "  OTA progress: %lu bytes sent...", (unsigned long)total_sent);
-        }
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGE(TAG, "  slave_fw image unusable (%s), skipping OTA", esp_err_to_name(ret));
+        goto out;
+    }
+    if (have_sha && slave_ota_is_installed(sha256)) {
+        ESP_LOGI(TAG, "  Slave already runs this image, skipping OTA");
+        goto out;
     }
-    free(buf);
 
-    ESP_LOGI(TAG, "  OTA write complete: %lu bytes sent", (unsigned long)total_sent);
+    ESP_LOGI(TAG, "  Found new slave firmware in partition, starting OTA...");
 
-    ret = esp_hosted_slave_ota_end();
+    slave_ota_config_t cfg = {
+        .chunk_size = SLAVE_OTA_CHUNK_SIZE,
+        .ring_depth = SLAVE_OTA_RING_DEPTH,
+        .max_retries = SLAVE_OTA_RETRIES,
+        .checkpoint_len = SLAVE_OTA_CHECKPOINT,
+    };
+    slave_ota_stats_t stats;
+    ret = slave_ota_transfer(&src, &cfg, &stats);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "  OTA end failed: %s", esp_err_to_name(ret));
-        return;
+        goto out;
     }
 
+    float ota_secs = stats.elapsed_us / 1000000.0f;
+    ESP_LOGI(TAG, "  OTA write complete: %lu bytes sent in %.1f s (%.1f KB/s)%s",
+             (unsigned long)stats.bytes_sent, ota_secs,
+             ota_secs > 0 ? stats.bytes_sent / 1024.0f / ota_secs : 0.0f,
+             stats.zero_copy ? ", zero-copy" : "");
+
     ESP_LOGI(TAG, "  Activating new slave firmware...");
-    ret = esp_hosted_slave_ota_activate();
+    ret = slave_ota_activate(&stats);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "  OTA activate failed: %s", esp_err_to_name(ret));
-        return;
+        goto out;
+    }
+    if (have_sha) {
+        slave_ota_mark_installed(sha256);
     }
 
     ESP_LOGI(TAG, "  ╔═══════════════════════════════════════╗");
     ESP_LOGI(TAG, "  ║  Slave OTA COMPLETE — rebooting...    ║");
     ESP_LOGI(TAG, "  ╚═══════════════════════════════════════╝");
 
-    /* Erase the partition so we don't OTA again on next boot */
-    esp_partition_erase_range(part, 0, part->size);
+    /* Erase only what held the image so we don't OTA again on next boot;
+     * unmap first so no stale cache lines of it remain */
+    slave_ota_src_close(&src);
+    size_t image_len = stats.resumed_from + stats.bytes_sent;
+    size_t erase_len = (image_len + part->erase_size - 1) & ~(size_t)(part->erase_size - 1);
+    esp_partition_erase_range(part, 0, erase_len);
 
     /* Give slave time to reboot, then restart host */
     vTaskDelay(pdMS_TO_TICKS(3000));
     esp_restart();
+
+out:
+    slave_ota_src_close(&src);
 }
 
 /* ─── Main ─── */
 void app_main(void)
 {
+    boot_timeline_mark(BOOT_MS_APP_MAIN);
+
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "╔═══════════════════════════════════════════════════╗");
     ESP_LOGI(TAG, "║  ESP32-P4 WiFi Streaming Test via esp-hosted     ║");
@@ -636,8 +1275,17 @@ void app_main(void)
     ESP_LOGI(TAG, "╚═══════════════════════════════════════════════════╝");
     ESP_LOGI(TAG, "");
 
+    s_test_events = xEventGroupCreate();
+
+    /* Hot-path logging (capture callback, per-second stats) is deferred to
+     * a task just above idle so console output does not skew measurements */
+    bin_log_start(tskIDLE_PRIORITY + 1, BIN_LOG_RAW);
+
     /* Phase 1: Connect to WiFi (also brings up SDIO transport to C6) */
+    mem_prof_phase_begin("wifi_init");
     esp_err_t ret = wifi_init_sta();
+    mem_prof_phase_end();
+    boot_timeline_print();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "WiFi connection failed. Halting.");
         while (1) vTaskDelay(pdMS_TO_TICKS(10000));
@@ -650,8 +1298,6 @@ void app_main(void)
      * channel is up. If OTA succeeds, device restarts automatically. */
     try_slave_ota();
 
-    vTaskDelay(pdMS_TO_TICKS(2000));
-
     /* Heap diagnostics */
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "════════════════════════════════════════");
@@ -660,19 +1306,58 @@ void app_main(void)
     ESP_LOGI(TAG, "  Free heap:     %lu bytes", (unsigned long)esp_get_free_heap_size());
     ESP_LOGI(TAG, "  Free internal: %lu bytes", (unsigned long)esp_get_free_internal_heap_size());
     ESP_LOGI(TAG, "  Min free heap: %lu bytes", (unsigned long)esp_get_minimum_free_heap_size());
+    mem_prof_snapshot_t heap;
+    mem_prof_snapshot(&heap);
+    mem_prof_log_snapshot("By capability:", &heap);
+
+    /* Transport baseline on an idle link, before any WiFi traffic */
+    if (RPC_BENCH_ENABLE) {
+        mem_prof_phase_begin("rpc_bench");
+        test_rpc_bench();
+        mem_prof_phase_end();
+    }
 
-    /* Phase 2: UDP TX throughput test */
-    test_udp_stream();
+    /* Phases run back to back: each one joins its worker tasks before it
+     * returns, so the next starts on an idle link with no fixed sleeps.
+     * A worker that does not stop would still be loading the link and
+     * sharing its counters, so the remaining phases are skipped. */
 
-    vTaskDelay(pdMS_TO_TICKS(3000));
+    /* Phase 2: UDP TX throughput test */
+    mem_prof_phase_begin("udp");
+    bool joined = test_udp_stream();
+    mem_prof_phase_end();
 
     /* Phase 3: TCP TX throughput test */
-    test_tcp_stream();
-
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    if (joined) {
+        mem_prof_phase_begin("tcp");
+        joined = test_tcp_stream();
+        mem_prof_phase_end();
+    }
 
     /* Phase 4: Packet monitor test */
-    test_packet_monitor();
+    if (joined) {
+        mem_prof_phase_begin("monitor");
+        test_packet_monitor();
+        mem_prof_phase_end();
+    }
+
+    /* Phase 4b: Raw injection throughput */
+    if (joined && INJECT_BENCH_ENABLE) {
+        mem_prof_phase_begin("inject");
+        test_inject_bench();
+        mem_prof_phase_end();
+    }
+
+    /* Phase 5: Long-duration TCP soak (opt-in) */
+    if (joined && SOAK_DURATION_SEC > 0) {
+        mem_prof_phase_begin("soak");
+        joined = test_tcp_soak();
+        mem_prof_phase_end();
+    }
+
+    if (!joined) {
+        ESP_LOGE(TAG, "A worker task did not stop, remaining phases skipped");
+    }
 
     /* Done */
     ESP_LOGI(TAG, "");
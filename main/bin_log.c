@@ -0,0 +1,184 @@
+/*
+ * Bin Log - implementation
+ *
+ * Each core has a ring of fixed-size slots. A writer reserves the next
+ * index with a compare-and-swap on head (so tasks and ISRs preempting
+ * each other on one core, or a task that migrated, are all safe), fills
+ * the slot and publishes it by storing index + 1 in its seq. The single
+ * reader (drain task or bin_log_flush, serialized by a mutex) takes the
+ * slot at tail once its seq matches and then advances tail, which frees
+ * the slot for writers.
+ */
+
+#include <stdatomic.h>
+#include <inttypes.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "bin_log.h"
+#include "bin_log_fmt.h"
+
+static const char *TAG = "bin_log";
+
+_Static_assert((BIN_LOG_RING_SLOTS & (BIN_LOG_RING_SLOTS - 1)) == 0,
+               "BIN_LOG_RING_SLOTS must be a power of 2");
+
+typedef struct {
+    _Atomic uint32_t seq;       /* Index + 1 once the record is complete */
+    uint32_t nargs;
+    const char *fmt;
+    int64_t ts_us;
+    uint32_t args[BIN_LOG_MAX_ARGS];
+} slot_t;
+
+typedef struct {
+    _Atomic uint32_t head;      /* Next index to reserve */
+    _Atomic uint32_t tail;      /* Next index to read */
+    _Atomic uint32_t dropped;
+    slot_t slots[BIN_LOG_RING_SLOTS];
+} ring_t;
+
+static ring_t s_rings[portNUM_PROCESSORS];
+static SemaphoreHandle_t s_read_lock;
+static bool s_raw;
+static uint32_t s_reported_drops;
+static char s_line[256];        /* Under s_read_lock */
+
+void IRAM_ATTR bin_log_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1,
+                             uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5)
+{
+    ring_t *r = &s_rings[xPortGetCoreID()];
+
+    uint32_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    do {
+        if (h - atomic_load_explicit(&r->tail, memory_order_acquire) >= BIN_LOG_RING_SLOTS) {
+            atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&r->head, &h, h + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    slot_t *s = &r->slots[h & (BIN_LOG_RING_SLOTS - 1)];
+    s->ts_us = esp_timer_get_time();
+    s->fmt = fmt;
+    s->nargs = nargs;
+    s->args[0] = a0;
+    s->args[1] = a1;
+    s->args[2] = a2;
+    s->args[3] = a3;
+    s->args[4] = a4;
+    s->args[5] = a5;
+    atomic_store_explicit(&s->seq, h + 1, memory_order_release);
+}
+
+/* Completed record at the tail of r, or NULL */
+static const slot_t *peek(ring_t *r)
+{
+    uint32_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    const slot_t *s = &r->slots[t & (BIN_LOG_RING_SLOTS - 1)];
+    if (atomic_load_explicit(&r->head, memory_order_relaxed) == t ||
+        atomic_load_explicit(&s->seq, memory_order_acquire) != t + 1) {
+        return NULL;
+    }
+    return s;
+}
+
+static const char *resolve_str(uint32_t addr, void *ctx)
+{
+    return (const char *)(uintptr_t)addr;
+}
+
+static void emit(int core, const slot_t *s)
+{
+    if (s_raw) {
+        /* BLOG <ts_us> <core> <fmt> <args...>, decoded against the ELF */
+        int n = snprintf(s_line, sizeof(s_line), "BLOG %" PRId64 " %d %08" PRIx32,
+                         s->ts_us, core, (uint32_t)(uintptr_t)s->fmt);
+        for (uint32_t i = 0; i < s->nargs && n > 0 && (size_t)n < sizeof(s_line); i++) {
+            n += snprintf(s_line + n, sizeof(s_line) - n, " %08" PRIx32, s->args[i]);
+        }
+        printf("%s\n", s_line);
+        return;
+    }
+
+    bin_log_format(s_line, sizeof(s_line), s->fmt, s->args, s->nargs, resolve_str, NULL);
+    printf("I (%lu) %s: %s\n", (unsigned long)(s->ts_us / 1000), TAG, s_line);
+}
+
+/* Print records in timestamp order across cores until none is ready */
+static void drain(void)
+{
+    for (;;) {
+        const slot_t *next = NULL;
+        int core = 0;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            const slot_t *s = peek(&s_rings[c]);
+            if (s && (!next || s->ts_us < next->ts_us)) {
+                next = s;
+                core = c;
+            }
+        }
+        if (!next) {
+            break;
+        }
+        emit(core, next);
+        atomic_fetch_add_explicit(&s_rings[core].tail, 1, memory_order_release);
+    }
+
+    uint32_t dropped = bin_log_dropped();
+    if (dropped != s_reported_drops) {
+        ESP_LOGW(TAG, "%lu records dropped, ring full", (unsigned long)(dropped - s_reported_drops));
+        s_reported_drops = dropped;
+    }
+}
+
+void bin_log_flush(void)
+{
+    if (s_read_lock) {
+        xSemaphoreTake(s_read_lock, portMAX_DELAY);
+    }
+    drain();
+    if (s_read_lock) {
+        xSemaphoreGive(s_read_lock);
+    }
+}
+
+uint32_t bin_log_dropped(void)
+{
+    uint32_t n = 0;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        n += atomic_load_explicit(&s_rings[c].dropped, memory_order_relaxed);
+    }
+    return n;
+}
+
+static void drain_task(void *arg)
+{
+    for (;;) {
+        bin_log_flush();
+        vTaskDelay(pdMS_TO_TICKS(BIN_LOG_DRAIN_MS));
+    }
+}
+
+esp_err_t bin_log_start(UBaseType_t priority, bool raw)
+{
+    if (s_read_lock) {
+        return ESP_OK;
+    }
+    s_raw = raw;
+    s_read_lock = xSemaphoreCreateMutex();
+    if (!s_read_lock) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(drain_task, "bin_log", 3072, NULL, priority, NULL) != pdPASS) {
+        vSemaphoreDelete(s_read_lock);
+        s_read_lock = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "%d x %d-record rings, %s output", portNUM_PROCESSORS, BIN_LOG_RING_SLOTS,
+             raw ? "BLOG raw" : "text");
+    return ESP_OK;
+}
@@ -0,0 +1,138 @@
+/*
+ * Bin Log - deferred binary logging for hot paths
+ *
+ * BIN_LOG("ch:%d rssi:%d", ch, rssi) stores a record of (timestamp,
+ * format address, raw 32-bit args) in a lock-free ring of the calling
+ * core and returns; nothing is formatted or written to the console.
+ * A low-priority task merges the per-core rings by timestamp and prints
+ * the records, or dumps them as BLOG hex lines for tools/bin_log_decode,
+ * which formats them on the development machine from the firmware ELF.
+ *
+ * The format must be a string literal. Its address in flash is the
+ * record's format ID, so the registry is built by the compiler and
+ * linker and costs nothing at run time; the format is still checked
+ * against the arguments like printf. Arguments are stored as 32-bit
+ * words: integers up to 32 bits, floats and doubles (as float), and %s
+ * strings that live for the whole run (literals, static tables). A
+ * 64-bit integer argument is a build error.
+ * At most BIN_LOG_MAX_ARGS arguments. C only.
+ *
+ * A full ring drops new records and counts them; nothing blocks.
+ */
+
+#ifndef BIN_LOG_H
+#define BIN_LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef BIN_LOG_ENABLE
+#define BIN_LOG_ENABLE          1       /**< 0 = BIN_LOG is a plain ESP_LOGI */
+#endif
+
+#define BIN_LOG_MAX_ARGS        6
+#define BIN_LOG_RING_SLOTS      256     /**< Records per core, power of 2 */
+#define BIN_LOG_DRAIN_MS        20      /**< Drain task poll interval */
+
+/**
+ * @brief Start the drain task
+ *
+ * Records written before this are kept and printed once it runs.
+ *
+ * @param priority Task priority, normally just above idle
+ * @param raw true = BLOG hex lines for tools/bin_log_decode,
+ *            false = formatted text
+ * @return ESP_OK, ESP_ERR_NO_MEM
+ */
+esp_err_t bin_log_start(UBaseType_t priority, bool raw);
+
+/**
+ * @brief Print everything logged so far from the calling task
+ *
+ * Call before regular ESP_LOG output that must come after the records.
+ */
+void bin_log_flush(void);
+
+/**
+ * @brief Records dropped on full rings since boot
+ */
+uint32_t bin_log_dropped(void);
+
+/**
+ * @brief Store one record (use BIN_LOG)
+ */
+void bin_log_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2,
+                   uint32_t a3, uint32_t a4, uint32_t a5);
+
+/* Argument words */
+static inline uint32_t bin_log_u32(uint32_t v) { return v; }
+static inline uint32_t bin_log_str(const char *s) { return (uint32_t)(uintptr_t)s; }
+static inline uint32_t bin_log_f32(float f)
+{
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    return w;
+}
+static inline uint32_t bin_log_f64(double d) { return bin_log_f32((float)d); }
+
+/* 64-bit integers do not fit a word; BIN_LOG_ARG maps them here so the
+ * build fails instead of truncating them */
+uint32_t bin_log_64bit(unsigned long long v)
+    __attribute__((error("BIN_LOG arguments are 32-bit: cast, or use ESP_LOGI for 64-bit values")));
+
+/* int64_t and uint64_t are long long on the ESP32 targets */
+#define BIN_LOG_ARG(x) _Generic((x),        \
+    float: bin_log_f32,                     \
+    double: bin_log_f64,                    \
+    long long: bin_log_64bit,               \
+    unsigned long long: bin_log_64bit,      \
+    char *: bin_log_str,                    \
+    const char *: bin_log_str,              \
+    default: bin_log_u32)(x)
+
+#define BIN_LOG_NARGS(...) BIN_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define BIN_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define BIN_LOG_CAT(a, b) BIN_LOG_CAT_(a, b)
+#define BIN_LOG_CAT_(a, b) a##b
+
+#define BIN_LOG_0(f) bin_log_write(f, 0, 0, 0, 0, 0, 0, 0)
+#define BIN_LOG_1(f, a) bin_log_write(f, 1, BIN_LOG_ARG(a), 0, 0, 0, 0, 0)
+#define BIN_LOG_2(f, a, b) bin_log_write(f, 2, BIN_LOG_ARG(a), BIN_LOG_ARG(b), 0, 0, 0, 0)
+#define BIN_LOG_3(f, a, b, c) \
+    bin_log_write(f, 3, BIN_LOG_ARG(a), BIN_LOG_ARG(b), BIN_LOG_ARG(c), 0, 0, 0)
+#define BIN_LOG_4(f, a, b, c, d) \
+    bin_log_write(f, 4, BIN_LOG_ARG(a), BIN_LOG_ARG(b), BIN_LOG_ARG(c), BIN_LOG_ARG(d), 0, 0)
+#define BIN_LOG_5(f, a, b, c, d, e) \
+    bin_log_write(f, 5, BIN_LOG_ARG(a), BIN_LOG_ARG(b), BIN_LOG_ARG(c), BIN_LOG_ARG(d), \
+                  BIN_LOG_ARG(e), 0)
+#define BIN_LOG_6(f, a, b, c, d, e, g) \
+    bin_log_write(f, 6, BIN_LOG_ARG(a), BIN_LOG_ARG(b), BIN_LOG_ARG(c), BIN_LOG_ARG(d), \
+                  BIN_LOG_ARG(e), BIN_LOG_ARG(g))
+
+#if BIN_LOG_ENABLE
+/**
+ * @brief Log from a hot path; fmt must be a string literal
+ */
+#define BIN_LOG(fmt, ...) do {                                              \
+        static const char bin_log_fmt_[] = fmt;                             \
+        if (0) printf(fmt, ##__VA_ARGS__);  /* Format check only */         \
+        BIN_LOG_CAT(BIN_LOG_, BIN_LOG_NARGS(__VA_ARGS__))(bin_log_fmt_, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define BIN_LOG(fmt, ...) ESP_LOGI("bin_log", fmt, ##__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIN_LOG_H */
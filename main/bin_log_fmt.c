@@ -0,0 +1,121 @@
+/*
+ * Bin Log Format - implementation
+ *
+ * Literal text is copied as is. Each conversion is rebuilt without its
+ * length modifier into a small format of its own and handed to snprintf
+ * with the argument word widened to the type that format expects, so the
+ * output matches what printf would have produced on the target.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "bin_log_fmt.h"
+
+#define SPEC_MAX 16
+
+static void put(char *out, size_t size, size_t *pos, const char *s, size_t n)
+{
+    for (size_t i = 0; i < n && *pos + 1 < size; i++) {
+        out[(*pos)++] = s[i];
+    }
+}
+
+static float word_to_float(uint32_t w)
+{
+    float f;
+    memcpy(&f, &w, sizeof(f));
+    return f;
+}
+
+size_t bin_log_format(char *out, size_t size, const char *fmt, const uint32_t *args,
+                      unsigned nargs, bin_log_str_fn_t str, void *ctx)
+{
+    size_t pos = 0;
+    unsigned arg = 0;
+    if (size == 0) {
+        return 0;
+    }
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            const char *lit = fmt;
+            while (*fmt && *fmt != '%') fmt++;
+            put(out, size, &pos, lit, (size_t)(fmt - lit));
+            continue;
+        }
+        if (fmt[1] == '%') {
+            put(out, size, &pos, "%", 1);
+            fmt += 2;
+            continue;
+        }
+
+        /* Flags, width and precision are kept; length modifiers dropped */
+        char spec[SPEC_MAX];
+        size_t n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && n < SPEC_MAX - 3) {
+            spec[n++] = *fmt++;
+        }
+        while (*fmt && strchr("hlLqjzt", *fmt)) {
+            fmt++;
+        }
+        char conv = *fmt;
+        if (conv == '\0') {
+            break;
+        }
+        fmt++;
+
+        if (arg >= nargs) {
+            put(out, size, &pos, "?", 1);
+            continue;
+        }
+        uint32_t w = args[arg++];
+        char tmp[64];
+        int len;
+
+        switch (conv) {
+        case 'd': case 'i': case 'c':
+            spec[n++] = conv;
+            spec[n] = '\0';
+            len = snprintf(tmp, sizeof(tmp), spec, (int)(int32_t)w);
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            spec[n++] = conv;
+            spec[n] = '\0';
+            len = snprintf(tmp, sizeof(tmp), spec, (unsigned)w);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec[n++] = conv;
+            spec[n] = '\0';
+            len = snprintf(tmp, sizeof(tmp), spec, (double)word_to_float(w));
+            break;
+        case 's': {
+            const char *s = str ? str(w, ctx) : NULL;
+            if (s) {
+                spec[n++] = 's';
+                spec[n] = '\0';
+                /* Not via tmp: the string may be longer */
+                len = snprintf(out + pos, size - pos, spec, s);
+                if (len > 0) {
+                    pos += ((size_t)len < size - pos) ? (size_t)len : size - pos - 1;
+                }
+                continue;
+            }
+            len = snprintf(tmp, sizeof(tmp), "<0x%08x>", (unsigned)w);
+            break;
+        }
+        case 'p':
+            len = snprintf(tmp, sizeof(tmp), "0x%08x", (unsigned)w);
+            break;
+        default:
+            len = snprintf(tmp, sizeof(tmp), "%%%c?", conv);
+            break;
+        }
+        if (len > 0) {
+            put(out, size, &pos, tmp, ((size_t)len < sizeof(tmp)) ? (size_t)len : sizeof(tmp) - 1);
+        }
+    }
+
+    out[pos] = '\0';
+    return pos;
+}
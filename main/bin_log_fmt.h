@@ -0,0 +1,53 @@
+/*
+ * Bin Log Format - printf-style formatting of deferred log records
+ *
+ * Formats a record's format string against its raw 32-bit argument
+ * words. Shared by the on-target drain task and the Linux decoder
+ * (tools/bin_log_decode.c), which resolves format and %s string
+ * addresses from the firmware ELF instead of dereferencing them.
+ *
+ * Pure C with no ESP-IDF dependencies.
+ */
+
+#ifndef BIN_LOG_FMT_H
+#define BIN_LOG_FMT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map a %s argument word to a string
+ *
+ * @return The string, or NULL if the address is not known
+ */
+typedef const char *(*bin_log_str_fn_t)(uint32_t addr, void *ctx);
+
+/**
+ * @brief Format one record
+ *
+ * Integer conversions (d i u o x X c) take one word, length modifiers
+ * are ignored, so %lld and %llu print only the low 32 bits. Floating
+ * conversions (f e g a) take the bits of a float. %p prints the word in
+ * hex; %s goes through str. '*' widths are not supported.
+ *
+ * @param out Output buffer, always NUL-terminated
+ * @param size Output buffer size
+ * @param fmt Format string
+ * @param args Argument words
+ * @param nargs Number of words; conversions beyond it print '?'
+ * @param str %s resolver, NULL = print the address
+ * @param ctx Passed to str
+ * @return Length written, excluding the NUL
+ */
+size_t bin_log_format(char *out, size_t size, const char *fmt, const uint32_t *args,
+                      unsigned nargs, bin_log_str_fn_t str, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIN_LOG_FMT_H */
@@ -0,0 +1,69 @@
+/*
+ * Boot Timeline - implementation
+ *
+ * Timestamps come from esp_timer, which starts counting during early
+ * startup, so absolute values approximate time since reset.
+ */
+
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "boot_timeline.h"
+
+static const char *TAG = "boot";
+
+static const char *s_names[BOOT_MS_COUNT] = {
+    [BOOT_MS_APP_MAIN]  = "app_main",
+    [BOOT_MS_NVS]       = "nvs",
+    [BOOT_MS_NETIF]     = "netif",
+    [BOOT_MS_WIFI_INIT] = "wifi_init",
+    [BOOT_MS_TRANSPORT] = "transport",
+    [BOOT_MS_STA_START] = "sta_start",
+    [BOOT_MS_CONNECTED] = "connected",
+    [BOOT_MS_GOT_IP]    = "got_ip",
+};
+
+static int64_t s_marks[BOOT_MS_COUNT];   /* 0 = not reached */
+
+void boot_timeline_mark(boot_milestone_t ms)
+{
+    if (ms < BOOT_MS_COUNT && s_marks[ms] == 0) {
+        s_marks[ms] = esp_timer_get_time();
+    }
+}
+
+int64_t boot_timeline_get_us(boot_milestone_t ms)
+{
+    return (ms < BOOT_MS_COUNT && s_marks[ms] != 0) ? s_marks[ms] : -1;
+}
+
+void boot_timeline_print(void)
+{
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "── Boot timeline ──");
+    ESP_LOGI(TAG, "  %-10s %9s %9s", "milestone", "t (ms)", "+delta");
+
+    int64_t prev = 0;
+    for (int i = 0; i < BOOT_MS_COUNT; i++) {
+        if (s_marks[i] == 0) {
+            ESP_LOGI(TAG, "  %-10s %9s", s_names[i], "-");
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-10s %9.1f %+9.1f", s_names[i],
+                 s_marks[i] / 1000.0, (s_marks[i] - prev) / 1000.0);
+        prev = s_marks[i];
+    }
+
+    /* One grep-able line for log scrapers: BOOT_METRICS {"nvs_ms":12.3,...} */
+    char line[256];
+    int len = snprintf(line, sizeof(line), "{");
+    for (int i = 0; i < BOOT_MS_COUNT && len < (int)sizeof(line); i++) {
+        if (s_marks[i] == 0) continue;
+        len += snprintf(line + len, sizeof(line) - len, "%s\"%s_ms\":%.1f",
+                        len > 1 ? "," : "", s_names[i], s_marks[i] / 1000.0);
+    }
+    if (len < (int)sizeof(line)) {
+        snprintf(line + len, sizeof(line) - len, "}");
+    }
+    ESP_LOGI(TAG, "BOOT_METRICS %s", line);
+}
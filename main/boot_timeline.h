@@ -0,0 +1,52 @@
+/*
+ * Boot Timeline - timestamped startup milestones
+ *
+ * Records when each step of bring-up (NVS, netif, WiFi init, SDIO
+ * transport, association, DHCP) first completes and prints the
+ * timeline with per-step deltas plus a machine-readable metrics line.
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Startup milestones in expected order
+ */
+typedef enum {
+    BOOT_MS_APP_MAIN = 0,   /**< app_main() entered */
+    BOOT_MS_NVS,            /**< nvs_flash_init() done */
+    BOOT_MS_NETIF,          /**< esp_netif + event loop + STA netif created */
+    BOOT_MS_WIFI_INIT,      /**< esp_wifi_init() returned */
+    BOOT_MS_TRANSPORT,      /**< First RPC to the C6 completed (SDIO transport up) */
+    BOOT_MS_STA_START,      /**< WIFI_EVENT_STA_START */
+    BOOT_MS_CONNECTED,      /**< WIFI_EVENT_STA_CONNECTED (auth + assoc + 4-way handshake) */
+    BOOT_MS_GOT_IP,         /**< IP_EVENT_STA_GOT_IP */
+    BOOT_MS_COUNT,
+} boot_milestone_t;
+
+/**
+ * @brief Record a milestone (only the first call per milestone counts)
+ */
+void boot_timeline_mark(boot_milestone_t ms);
+
+/**
+ * @brief Time of a milestone since boot, or -1 if not reached
+ */
+int64_t boot_timeline_get_us(boot_milestone_t ms);
+
+/**
+ * @brief Log the timeline and a single-line "BOOT_METRICS" JSON record
+ */
+void boot_timeline_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TIMELINE_H */
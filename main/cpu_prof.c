@@ -0,0 +1,148 @@
+/*
+ * CPU Profiler - implementation
+ *
+ * The run-time counter is clocked from esp_timer (microseconds), so a
+ * counter delta divided by the wall-clock span is the fraction of one
+ * core a task used. Busy cycles are derived from the per-core idle
+ * counters and the configured CPU frequency.
+ */
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "cpu_prof.h"
+
+static const char *TAG = "cpu_prof";
+
+#define CPU_PROF_MAX_TASKS      32
+#define CPU_PROF_NAME_LEN       16
+#define CPU_PROF_MIN_PCT        0.5f    /* Hide tasks below this share of a core */
+
+typedef struct {
+    TaskHandle_t handle;
+    char name[CPU_PROF_NAME_LEN];
+    int core;                           /* tskNO_AFFINITY -> -1 */
+    uint32_t runtime;
+} task_sample_t;
+
+typedef struct {
+    int64_t time_us;
+    uint32_t idle[portNUM_PROCESSORS];
+    int n_tasks;
+    task_sample_t tasks[CPU_PROF_MAX_TASKS];
+} cpu_sample_t;
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+
+static cpu_sample_t s_start;
+static cpu_sample_t s_end;
+static uint64_t s_bytes;
+static uint32_t s_packets;
+static TaskStatus_t s_status[CPU_PROF_MAX_TASKS];
+
+static void take_sample(cpu_sample_t *s)
+{
+    UBaseType_t n = uxTaskGetSystemState(s_status, CPU_PROF_MAX_TASKS, NULL);
+    s->time_us = esp_timer_get_time();
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        s->idle[core] = ulTaskGetIdleRunTimeCounterForCore(core);
+    }
+
+    s->n_tasks = (int)n;
+    for (UBaseType_t i = 0; i < n; i++) {
+        task_sample_t *t = &s->tasks[i];
+        t->handle = s_status[i].xHandle;
+        strncpy(t->name, s_status[i].pcTaskName, CPU_PROF_NAME_LEN - 1);
+        t->name[CPU_PROF_NAME_LEN - 1] = '\0';
+        t->core = (s_status[i].xCoreID == tskNO_AFFINITY) ? -1 : (int)s_status[i].xCoreID;
+        t->runtime = s_status[i].ulRunTimeCounter;
+    }
+}
+
+static uint32_t start_runtime(TaskHandle_t handle)
+{
+    for (int i = 0; i < s_start.n_tasks; i++) {
+        if (s_start.tasks[i].handle == handle) {
+            return s_start.tasks[i].runtime;
+        }
+    }
+    return 0;   /* Created inside the window */
+}
+
+void cpu_prof_begin(void)
+{
+    s_bytes = 0;
+    s_packets = 0;
+    s_end.n_tasks = 0;
+    take_sample(&s_start);
+}
+
+void cpu_prof_end(uint64_t bytes, uint32_t packets)
+{
+    take_sample(&s_end);
+    s_bytes = bytes;
+    s_packets = packets;
+}
+
+void cpu_prof_report(const char *label)
+{
+    uint32_t span = (uint32_t)(s_end.time_us - s_start.time_us);
+    if (span == 0) {
+        return;
+    }
+
+    const uint32_t mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    uint64_t busy_us = 0;
+
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "── CPU: %s (%.1fs @ %lu MHz) ──", label, span / 1000000.0f,
+             (unsigned long)mhz);
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        uint32_t idle = s_end.idle[core] - s_start.idle[core];
+        if (idle > span) idle = span;
+        busy_us += span - idle;
+        ESP_LOGI(TAG, "  CPU%d load: %5.1f%%  (idle %5.1f%%)", core,
+                 100.0f * (span - idle) / span, 100.0f * idle / span);
+    }
+
+    ESP_LOGI(TAG, "  Tasks (%% of one core):");
+    for (int i = 0; i < s_end.n_tasks; i++) {
+        const task_sample_t *t = &s_end.tasks[i];
+        float pct = 100.0f * (t->runtime - start_runtime(t->handle)) / span;
+        if (pct < CPU_PROF_MIN_PCT) continue;
+        if (t->core >= 0) {
+            ESP_LOGI(TAG, "    %-16s %5.1f%%  core %d", t->name, pct, t->core);
+        } else {
+            ESP_LOGI(TAG, "    %-16s %5.1f%%  any", t->name, pct);
+        }
+    }
+
+    uint64_t busy_cycles = busy_us * mhz;
+    if (s_bytes > 0) {
+        ESP_LOGI(TAG, "  Cost: %.1f cycles/byte, %.0f cycles/packet (%llu bytes, %lu pkts)",
+                 (double)busy_cycles / s_bytes,
+                 s_packets ? (double)busy_cycles / s_packets : 0.0,
+                 (unsigned long long)s_bytes, (unsigned long)s_packets);
+    }
+}
+
+#else
+
+void cpu_prof_begin(void)
+{
+}
+
+void cpu_prof_end(uint64_t bytes, uint32_t packets)
+{
+}
+
+void cpu_prof_report(const char *label)
+{
+    ESP_LOGW(TAG, "%s: enable CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and "
+             "CONFIG_FREERTOS_USE_TRACE_FACILITY for CPU stats", label);
+}
+
+#endif
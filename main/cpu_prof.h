@@ -0,0 +1,49 @@
+/*
+ * CPU Profiler - per-task and per-core utilization for test phases
+ *
+ * Samples FreeRTOS run-time stats at the start and end of a measurement
+ * window and reports per-task CPU %, per-core load and the derived cost
+ * of the traffic in cycles/byte and cycles/packet.
+ */
+
+#ifndef CPU_PROF_H
+#define CPU_PROF_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start a measurement window
+ *
+ * Records run-time counters for all tasks and the per-core idle tasks.
+ * Requires CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and
+ * CONFIG_FREERTOS_USE_TRACE_FACILITY; otherwise reports are skipped.
+ */
+void cpu_prof_begin(void);
+
+/**
+ * @brief Close the measurement window
+ *
+ * Call while worker tasks are still running so their counters are
+ * included, and pass the traffic moved inside the window.
+ *
+ * @param bytes Payload bytes transferred during the window
+ * @param packets Packets (or send calls) during the window
+ */
+void cpu_prof_end(uint64_t bytes, uint32_t packets);
+
+/**
+ * @brief Log per-core load, per-task CPU % and cycles/byte, cycles/packet
+ *
+ * @param label Phase name shown in the report
+ */
+void cpu_prof_report(const char *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_PROF_H */
@@ -0,0 +1,524 @@
+/*
+ * Inject Bench - implementation
+ *
+ * Every frame carries the same locally administered source address, so
+ * the RX callback can tell injected frames from other traffic on the
+ * channel. Whether they show up at all depends on the slave reporting
+ * its own transmissions to the promiscuous callback; a second device in
+ * monitor mode is the fallback when it does not.
+ *
+ * Loopback frames are vendor-specific actions carrying a loop_tag_t.
+ * The nonce changes every point, so stragglers from an earlier point are
+ * not mistaken for replies; the sequence number indexes the sample slot.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "wifi_raw.h"
+#include "wifi_raw_frame.h"
+#include "inject_bench.h"
+
+static const char *TAG = "inject_bench";
+
+#define CAPTURE_TAIL_MS 200     /* Wait for late captures after the last frame */
+
+static const uint8_t s_src_addr[6] = { 0x02, 'I', 'N', 'J', 0x00, 0x01 };
+static const char s_ssid[] = "inject";
+
+/* Follows the vendor action header; OUI is s_src_addr[0..2] */
+typedef struct {
+    uint32_t nonce;
+    uint32_t seq;
+    int64_t tx_us;          /* Host esp_timer time just before the TX call */
+} __attribute__((packed)) loop_tag_t;
+
+#define LOOP_TAG_OFFSET     WIFI_RAW_ACTION_VENDOR_LEN(0)
+#define LOOP_MIN_FRAME      WIFI_RAW_ACTION_VENDOR_LEN(sizeof(loop_tag_t))
+
+static volatile uint32_t s_captured;
+
+static struct {
+    uint32_t nonce;
+    uint32_t count;
+    uint32_t *lat_us;       /* Per seq, 0 until captured */
+    volatile uint32_t matched;
+} s_loop;
+
+static void capture_cb(const wifi_raw_rx_pkt_t *pkt)
+{
+    wifi_raw_frame_info_t info;
+    if (wifi_raw_frame_parse(pkt->payload, pkt->payload_len, &info) &&
+        memcmp(info.hdr->addr2, s_src_addr, 6) == 0) {
+        s_captured++;
+    }
+}
+
+static void loop_cb(const wifi_raw_rx_pkt_t *pkt)
+{
+    int64_t now = esp_timer_get_time();
+    wifi_raw_frame_info_t info;
+    if (pkt->payload_len < LOOP_MIN_FRAME ||
+        !wifi_raw_frame_parse(pkt->payload, pkt->payload_len, &info) ||
+        info.subtype != WIFI_RAW_FC_SUBTYPE(WIFI_RAW_FC_ACTION) || info.type != 0 ||
+        memcmp(info.hdr->addr2, s_src_addr, 6) != 0 ||
+        info.body[0] != WIFI_RAW_ACTION_VENDOR) {
+        return;
+    }
+
+    loop_tag_t tag;
+    memcpy(&tag, pkt->payload + LOOP_TAG_OFFSET, sizeof(tag));
+    if (tag.nonce != s_loop.nonce || tag.seq >= s_loop.count || s_loop.lat_us[tag.seq] != 0) {
+        return;     /* Earlier point, or duplicate */
+    }
+    int64_t lat = now - tag.tx_us;
+    s_loop.lat_us[tag.seq] = lat < 1 ? 1 : lat > UINT32_MAX ? UINT32_MAX : (uint32_t)lat;
+    s_loop.matched++;
+}
+
+static void fill_pattern(uint8_t *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        p[i] = (uint8_t)(i * 7 + 1);
+    }
+}
+
+/* Smallest frame build_frame() can produce for a type */
+static size_t min_frame(inject_frame_type_t type)
+{
+    switch (type) {
+    case INJECT_FRAME_BEACON:
+        return WIFI_RAW_BEACON_LEN(WIFI_RAW_IE_LEN(sizeof(s_ssid) - 1));
+    case INJECT_FRAME_PROBE_REQ:
+        return WIFI_RAW_PROBE_REQ_LEN(WIFI_RAW_IE_LEN(0));
+    case INJECT_FRAME_ACTION:
+        return WIFI_RAW_ACTION_VENDOR_LEN(0);
+    case INJECT_FRAME_DATA:
+        return WIFI_RAW_HDR_LEN;
+    }
+    return SIZE_MAX;
+}
+
+/* Pad to the frame size with vendor-specific elements. They are split so
+ * no single byte is left over; if that is all the room there is, the last
+ * element (ie, its header) grows by one byte instead. */
+static bool fill_elements(wifi_raw_frame_t *f, size_t size, uint8_t *ie)
+{
+    size_t left;
+    while ((left = size - f->len) >= 2) {
+        size_t n = left - 2 > WIFI_RAW_IE_MAX_BODY ? WIFI_RAW_IE_MAX_BODY : left - 2;
+        if (left - 2 - n == 1) {
+            n--;
+        }
+        uint8_t *body = wifi_raw_frame_ie(f, WIFI_RAW_IE_VENDOR, n);
+        if (!body) {
+            return false;
+        }
+        fill_pattern(body, n);
+        ie = body - 2;
+    }
+
+    if (left == 1) {
+        uint8_t *p = wifi_raw_frame_reserve(f, 1);
+        if (!p || ie[1] == WIFI_RAW_IE_MAX_BODY) {
+            return false;
+        }
+        *p = ' ';           /* A grown SSID stays printable */
+        ie[1]++;
+    }
+    return true;
+}
+
+/* Build a frame of exactly size bytes; false if it does not fit */
+static bool build_frame(inject_frame_type_t type, uint8_t *buf, uint16_t size)
+{
+    wifi_raw_frame_t f;
+    wifi_raw_frame_init(&f, buf, size);
+    uint8_t *body;
+    size_t n;
+
+    switch (type) {
+    case INJECT_FRAME_BEACON:
+        if (!wifi_raw_frame_beacon(&f, s_src_addr, 100, 0x0001) ||      /* 100 TU, ESS */
+            !(body = wifi_raw_frame_ie(&f, WIFI_RAW_IE_SSID, sizeof(s_ssid) - 1))) {
+            return false;
+        }
+        memcpy(body, s_ssid, sizeof(s_ssid) - 1);
+        if (!fill_elements(&f, size, body - 2)) {
+            return false;
+        }
+        break;
+    case INJECT_FRAME_PROBE_REQ:
+        if (!wifi_raw_frame_probe_req(&f, s_src_addr) ||
+            !(body = wifi_raw_frame_ie(&f, WIFI_RAW_IE_SSID, 0)) ||     /* Wildcard */
+            !fill_elements(&f, size, body - 2)) {
+            return false;
+        }
+        break;
+    case INJECT_FRAME_ACTION:
+        if (!wifi_raw_frame_action_vendor(&f, NULL, s_src_addr, s_src_addr) ||
+            !(body = wifi_raw_frame_reserve(&f, n = size - f.len))) {
+            return false;
+        }
+        fill_pattern(body, n);
+        break;
+    case INJECT_FRAME_DATA:
+        if (!wifi_raw_frame_hdr(&f, WIFI_RAW_FC_DATA, NULL, s_src_addr, s_src_addr) ||
+            !(body = wifi_raw_frame_reserve(&f, n = size - f.len))) {
+            return false;
+        }
+        fill_pattern(body, n);
+        break;
+    }
+    return wifi_raw_frame_len(&f) == size;
+}
+
+/* Sleep most of the way, then yield until the deadline */
+static void wait_until(int64_t deadline_us)
+{
+    int64_t left;
+    while ((left = deadline_us - esp_timer_get_time()) > 0) {
+        TickType_t ticks = pdMS_TO_TICKS(left / 1000);
+        if (ticks > 1) {
+            vTaskDelay(ticks - 1);
+        } else {
+            taskYIELD();
+        }
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void percentiles(uint32_t *v, uint32_t n, inject_bench_pct_t *out)
+{
+    qsort(v, n, sizeof(*v), cmp_u32);
+    out->p50 = v[(n - 1) * 50 / 100];
+    out->p90 = v[(n - 1) * 90 / 100];
+    out->p99 = v[(n - 1) * 99 / 100];
+    out->max = v[n - 1];
+}
+
+esp_err_t inject_bench_point(const inject_bench_config_t *cfg, uint16_t size,
+                             uint32_t target_fps, inject_bench_result_t *out)
+{
+    if (!cfg || !out || cfg->frames_per_point == 0 || cfg->type > INJECT_FRAME_DATA ||
+        size < min_frame(cfg->type) || size > INJECT_BENCH_MAX_FRAME) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->size = size;
+    out->target_fps = target_fps;
+
+    uint32_t count = cfg->frames_per_point;
+    uint8_t *frame = malloc(size);
+    uint32_t *call_us = malloc(count * sizeof(uint32_t));
+    if (!frame || !call_us) {
+        free(frame);
+        free(call_us);
+        return ESP_ERR_NO_MEM;
+    }
+    if (!build_frame(cfg->type, frame, size)) {
+        free(frame);
+        free(call_us);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (cfg->verify) {
+        s_captured = 0;
+        wifi_raw_register_rx_cb(capture_cb);
+    }
+
+    int64_t period = target_fps ? 1000000LL / target_fps : 0;
+    int64_t start = esp_timer_get_time();
+    int64_t last = start;
+    for (uint32_t i = 0; i < count; i++) {
+        if (period) {
+            wait_until(start + i * period);
+        }
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t ret = wifi_raw_80211_tx(cfg->ifx, frame, size, true);
+        last = esp_timer_get_time();
+        call_us[i] = (uint32_t)(last - t0);
+
+        if (ret == ESP_OK) {
+            out->sent++;
+        } else if (ret == ESP_ERR_TIMEOUT) {
+            out->timeouts++;
+        } else {
+            out->errors++;
+        }
+    }
+
+    if (cfg->verify) {
+        vTaskDelay(pdMS_TO_TICKS(CAPTURE_TAIL_MS));
+        wifi_raw_register_rx_cb(NULL);
+        out->captured = s_captured;
+    }
+
+    float secs = (last - start) / 1000000.0f;
+    out->fps = secs > 0 ? out->sent / secs : 0.0f;
+    out->mbps = secs > 0 ? (float)out->sent * size * 8 / secs / 1000000.0f : 0.0f;
+    percentiles(call_us, count, &out->call_us);
+
+    free(call_us);
+    free(frame);
+    return ESP_OK;
+}
+
+static void log_point(const inject_bench_result_t *r, bool verify)
+{
+    char captured[12] = "-";
+    if (verify) {
+        snprintf(captured, sizeof(captured), "%lu", (unsigned long)r->captured);
+    }
+    ESP_LOGI(TAG, "%5u %6lu | %7.1f %6.2f | %6lu %6lu %6lu %6lu | %5lu %5lu | %s",
+             r->size, (unsigned long)r->target_fps, r->fps, r->mbps,
+             (unsigned long)r->call_us.p50, (unsigned long)r->call_us.p90,
+             (unsigned long)r->call_us.p99, (unsigned long)r->call_us.max,
+             (unsigned long)r->timeouts, (unsigned long)r->errors, captured);
+
+    /* One grep-able line per point for log scrapers */
+    ESP_LOGI(TAG, "INJECT_BENCH {\"size\":%u,\"target_fps\":%lu,\"sent\":%lu,"
+             "\"timeouts\":%lu,\"errors\":%lu,\"captured\":%ld,\"fps\":%.1f,\"mbps\":%.3f,"
+             "\"call_p50_us\":%lu,\"call_p90_us\":%lu,\"call_p99_us\":%lu,\"call_max_us\":%lu}",
+             r->size, (unsigned long)r->target_fps, (unsigned long)r->sent,
+             (unsigned long)r->timeouts, (unsigned long)r->errors,
+             verify ? (long)r->captured : -1L, r->fps, r->mbps,
+             (unsigned long)r->call_us.p50, (unsigned long)r->call_us.p90,
+             (unsigned long)r->call_us.p99, (unsigned long)r->call_us.max);
+}
+
+static esp_err_t promisc_on(void)
+{
+    esp_err_t ret = wifi_raw_set_filter(0x0F);  /* WIFI_PROMIS_FILTER_MASK_ALL */
+    if (ret == ESP_OK) {
+        ret = wifi_raw_set_promiscuous(true);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Enable promiscuous mode failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t inject_bench_run(const inject_bench_config_t *cfg)
+{
+    esp_err_t ret;
+    if (cfg->verify && (ret = promisc_on()) != ESP_OK) {
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "%lu frames per point; call latency in us, rate 0 = unpaced",
+             (unsigned long)cfg->frames_per_point);
+    ESP_LOGI(TAG, " size   rate |   fps    Mbps |    p50    p90    p99    max |  tmo   err | seen");
+
+    uint32_t captured = 0;
+    for (size_t s = 0; s < cfg->n_sizes; s++) {
+        for (size_t r = 0; r < cfg->n_rates; r++) {
+            inject_bench_result_t res;
+            ret = inject_bench_point(cfg, cfg->sizes[s], cfg->rates[r], &res);
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "size %u rate %lu: %s", cfg->sizes[s],
+                         (unsigned long)cfg->rates[r], esp_err_to_name(ret));
+                continue;
+            }
+            captured += res.captured;
+            log_point(&res, cfg->verify);
+        }
+    }
+
+    if (cfg->verify) {
+        wifi_raw_set_promiscuous(false);
+        if (captured == 0) {
+            ESP_LOGW(TAG, "No injected frame captured: the slave may not report its own TX, "
+                     "verify with a second monitor");
+        }
+    }
+    return ESP_OK;
+}
+
+static uint32_t hist_bucket(uint32_t us)
+{
+    uint32_t b = 0;
+    while (b < INJECT_BENCH_HIST_BUCKETS - 1 && us >= (128u << b)) {
+        b++;
+    }
+    return b;
+}
+
+esp_err_t inject_bench_loopback(const inject_bench_config_t *cfg, uint16_t size,
+                                uint32_t target_fps, inject_bench_loop_result_t *out)
+{
+    if (!cfg || !out || cfg->frames_per_point == 0 ||
+        size < LOOP_MIN_FRAME || size > INJECT_BENCH_MAX_FRAME) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->size = size;
+    out->target_fps = target_fps;
+
+    uint32_t count = cfg->frames_per_point;
+    uint8_t *frame = malloc(size);
+    uint32_t *lat_us = calloc(count, sizeof(uint32_t));
+    if (!frame || !lat_us) {
+        free(frame);
+        free(lat_us);
+        return ESP_ERR_NO_MEM;
+    }
+    if (!build_frame(INJECT_FRAME_ACTION, frame, size)) {
+        free(frame);
+        free(lat_us);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loop_tag_t tag = {
+        .nonce = esp_random(),
+    };
+    s_loop.nonce = tag.nonce;
+    s_loop.lat_us = lat_us;
+    s_loop.matched = 0;
+    s_loop.count = count;
+    wifi_raw_register_rx_cb(loop_cb);
+
+    int64_t period = target_fps ? 1000000LL / target_fps : 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        if (period) {
+            wait_until(start + i * period);
+        }
+        tag.seq = i;
+        tag.tx_us = esp_timer_get_time();
+        memcpy(frame + LOOP_TAG_OFFSET, &tag, sizeof(tag));
+        if (wifi_raw_80211_tx(cfg->ifx, frame, size, true) == ESP_OK) {
+            out->sent++;
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(CAPTURE_TAIL_MS));
+
+    /* Returns only once a loop_cb already running has finished, so
+     * lat_us is no longer written from here on */
+    wifi_raw_register_rx_cb(NULL);
+    s_loop.count = 0;
+    s_loop.lat_us = NULL;
+    out->matched = s_loop.matched;
+    free(frame);
+
+    if (out->matched == 0) {
+        free(lat_us);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* Jitter in send order, before sorting destroys it */
+    uint64_t delta_sum = 0;
+    uint32_t prev = 0, n = 0, deltas = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (lat_us[i] == 0) continue;
+        if (n > 0) {
+            delta_sum += lat_us[i] > prev ? lat_us[i] - prev : prev - lat_us[i];
+            deltas++;
+        }
+        prev = lat_us[i];
+        out->hist[hist_bucket(lat_us[i])]++;
+        lat_us[n++] = lat_us[i];
+    }
+    out->jitter_us = deltas ? (uint32_t)(delta_sum / deltas) : 0;
+    percentiles(lat_us, n, &out->lat_us);
+
+    free(lat_us);
+    return ESP_OK;
+}
+
+static void log_loop_point(const inject_bench_loop_result_t *r)
+{
+    ESP_LOGI(TAG, "size %u rate %lu: %lu/%lu back | p50 %lu p90 %lu p99 %lu max %lu us | "
+             "jitter %lu us", r->size, (unsigned long)r->target_fps,
+             (unsigned long)r->matched, (unsigned long)r->sent,
+             (unsigned long)r->lat_us.p50, (unsigned long)r->lat_us.p90,
+             (unsigned long)r->lat_us.p99, (unsigned long)r->lat_us.max,
+             (unsigned long)r->jitter_us);
+
+    uint32_t peak = 0;
+    for (int b = 0; b < INJECT_BENCH_HIST_BUCKETS; b++) {
+        if (r->hist[b] > peak) peak = r->hist[b];
+    }
+    for (int b = 0; b < INJECT_BENCH_HIST_BUCKETS; b++) {
+        if (r->hist[b] == 0) continue;
+        char bar[41];
+        int w = (int)((uint64_t)r->hist[b] * (sizeof(bar) - 1) / peak);
+        memset(bar, '#', w ? w : 1);
+        bar[w ? w : 1] = '\0';
+        if (b == 0) {
+            ESP_LOGI(TAG, "  %8s %7u us | %5lu %s", "<", 128u, (unsigned long)r->hist[b], bar);
+        } else if (b == INJECT_BENCH_HIST_BUCKETS - 1) {
+            ESP_LOGI(TAG, "  %8s %7u us | %5lu %s", ">=", 64u << b, (unsigned long)r->hist[b], bar);
+        } else {
+            ESP_LOGI(TAG, "  %7u-%-7u us | %5lu %s", 64u << b, 128u << b,
+                     (unsigned long)r->hist[b], bar);
+        }
+    }
+
+    /* One grep-able line per point for log scrapers */
+    char hist[INJECT_BENCH_HIST_BUCKETS * 11 + 1];
+    size_t pos = 0;
+    for (int b = 0; b < INJECT_BENCH_HIST_BUCKETS; b++) {
+        pos += snprintf(hist + pos, sizeof(hist) - pos, "%s%lu", b ? "," : "",
+                        (unsigned long)r->hist[b]);
+    }
+    ESP_LOGI(TAG, "INJECT_LOOP {\"size\":%u,\"target_fps\":%lu,\"sent\":%lu,\"matched\":%lu,"
+             "\"p50_us\":%lu,\"p90_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,\"jitter_us\":%lu,"
+             "\"hist\":[%s]}",
+             r->size, (unsigned long)r->target_fps, (unsigned long)r->sent,
+             (unsigned long)r->matched,
+             (unsigned long)r->lat_us.p50, (unsigned long)r->lat_us.p90,
+             (unsigned long)r->lat_us.p99, (unsigned long)r->lat_us.max,
+             (unsigned long)r->jitter_us, hist);
+}
+
+esp_err_t inject_bench_loopback_run(const inject_bench_config_t *cfg)
+{
+    esp_err_t ret = promisc_on();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Loopback: %lu tagged frames per point, host -> slave -> air -> slave -> host",
+             (unsigned long)cfg->frames_per_point);
+
+    bool any = false;
+    for (size_t s = 0; s < cfg->n_sizes; s++) {
+        for (size_t r = 0; r < cfg->n_rates; r++) {
+            inject_bench_loop_result_t res;
+            ret = inject_bench_loopback(cfg, cfg->sizes[s], cfg->rates[r], &res);
+            if (ret == ESP_ERR_NOT_FOUND && !any) {
+                break;      /* Nothing comes back: more points will not help */
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "loopback size %u rate %lu: %s", cfg->sizes[s],
+                         (unsigned long)cfg->rates[r], esp_err_to_name(ret));
+                continue;
+            }
+            any = true;
+            log_loop_point(&res);
+        }
+        if (!any) {
+            break;
+        }
+    }
+
+    wifi_raw_set_promiscuous(false);
+    if (!any) {
+        ESP_LOGW(TAG, "No tagged frame captured: the slave does not report its own TX");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return ESP_OK;
+}
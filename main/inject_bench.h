@@ -0,0 +1,157 @@
+/*
+ * Inject Bench - raw 802.11 injection throughput and latency
+ *
+ * Calls wifi_raw_80211_tx() back to back, or paced to a target frame
+ * rate, and reports frames/s, the host-side latency of each call and
+ * error counts per (frame size, rate) point. With verification on, the
+ * promiscuous path counts how many of the injected frames come back,
+ * recognized by their source address.
+ *
+ * Loopback mode tags each frame with a nonce, sequence number and host
+ * send time and times its return through the promiscuous callback: the
+ * host -> slave -> air -> slave -> host path, as a latency histogram.
+ */
+
+#ifndef INJECT_BENCH_H
+#define INJECT_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest frame esp_wifi_80211_tx() sends on the slave */
+#define INJECT_BENCH_MAX_FRAME  1500
+/** Loopback histogram buckets: <128 us, then doubling up to >= 2 s */
+#define INJECT_BENCH_HIST_BUCKETS 16
+
+/**
+ * @brief Frame types esp_wifi_80211_tx() accepts
+ */
+typedef enum {
+    INJECT_FRAME_BEACON,
+    INJECT_FRAME_PROBE_REQ,
+    INJECT_FRAME_ACTION,        /**< Vendor-specific action */
+    INJECT_FRAME_DATA,          /**< Non-QoS data */
+} inject_frame_type_t;
+
+/**
+ * @brief Sweep description
+ */
+typedef struct {
+    inject_frame_type_t type;
+    uint8_t ifx;                /**< WIFI_IF_STA or WIFI_IF_AP */
+    const uint16_t *sizes;      /**< Frame lengths including MAC header */
+    size_t n_sizes;
+    const uint32_t *rates;      /**< Target frames/s, 0 = as fast as possible */
+    size_t n_rates;
+    uint32_t frames_per_point;
+    bool verify;                /**< Capture own frames via promiscuous mode */
+} inject_bench_config_t;
+
+/**
+ * @brief Latency percentiles in microseconds
+ */
+typedef struct {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} inject_bench_pct_t;
+
+/**
+ * @brief Result of one (size, rate) point
+ */
+typedef struct {
+    uint16_t size;
+    uint32_t target_fps;        /**< 0 = unpaced */
+    uint32_t sent;              /**< Calls that returned ESP_OK */
+    uint32_t timeouts;          /**< Calls that got no response from the slave */
+    uint32_t errors;            /**< Other failures */
+    uint32_t captured;          /**< Own frames seen by promiscuous RX */
+    float fps;                  /**< Successful frames per second */
+    float mbps;                 /**< Frame bytes, Mbit/s */
+    inject_bench_pct_t call_us; /**< Duration of each wifi_raw_80211_tx() call */
+} inject_bench_result_t;
+
+/**
+ * @brief Result of one loopback (size, rate) point
+ *
+ * Latency runs from just before wifi_raw_80211_tx() to the RX callback,
+ * both on the host clock.
+ */
+typedef struct {
+    uint16_t size;
+    uint32_t target_fps;
+    uint32_t sent;              /**< Frames the slave accepted */
+    uint32_t matched;           /**< Tagged frames captured back */
+    inject_bench_pct_t lat_us;  /**< Inject-to-capture latency */
+    uint32_t jitter_us;         /**< Mean latency change between consecutive frames */
+    uint32_t hist[INJECT_BENCH_HIST_BUCKETS]; /**< Bucket i: [64 << i, 128 << i) us */
+} inject_bench_loop_result_t;
+
+/**
+ * @brief Measure one (size, rate) point
+ *
+ * wifi_raw_init() must have been called. When verify is set, promiscuous
+ * mode must already be enabled; the RX callback is taken over for the
+ * duration of the call.
+ *
+ * @param cfg Frame type, interface and frame count (sizes/rates ignored)
+ * @param size Frame length up to INJECT_BENCH_MAX_FRAME; at least the
+ *             type's headers (data 24, action 28, probe request 26,
+ *             beacon 44 with its SSID element)
+ * @param target_fps Frames per second, 0 = unpaced
+ * @param out Filled on success
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM
+ */
+esp_err_t inject_bench_point(const inject_bench_config_t *cfg, uint16_t size,
+                             uint32_t target_fps, inject_bench_result_t *out);
+
+/**
+ * @brief Run a sweep and log a table plus one INJECT_BENCH JSON line per point
+ *
+ * Enables promiscuous mode around the sweep when cfg->verify is set.
+ *
+ * @param cfg Sweep description
+ * @return ESP_OK, or the error of the first failing wifi_raw command
+ */
+esp_err_t inject_bench_run(const inject_bench_config_t *cfg);
+
+/**
+ * @brief Measure inject-to-capture latency at one (size, rate) point
+ *
+ * Sends vendor-specific action frames whatever cfg->type says. Promiscuous
+ * mode must be enabled; the RX callback is taken over for the duration.
+ *
+ * @param cfg Interface and frame count (type, sizes, rates, verify ignored)
+ * @param size Frame length (44..INJECT_BENCH_MAX_FRAME, room for the tag)
+ * @param target_fps Frames per second, 0 = unpaced
+ * @param out Filled on success
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM, ESP_ERR_NOT_FOUND if
+ *         no tagged frame came back
+ */
+esp_err_t inject_bench_loopback(const inject_bench_config_t *cfg, uint16_t size,
+                                uint32_t target_fps, inject_bench_loop_result_t *out);
+
+/**
+ * @brief Run a loopback sweep, logging a histogram and one INJECT_LOOP JSON
+ *        line per point
+ *
+ * Enables promiscuous mode around the sweep.
+ *
+ * @param cfg Sweep description (type and verify ignored)
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if no frame ever came back, or the
+ *         error of the first failing wifi_raw command
+ */
+esp_err_t inject_bench_loopback_run(const inject_bench_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INJECT_BENCH_H */
@@ -0,0 +1,277 @@
+/*
+ * Memory Profiler - implementation
+ *
+ * Allocation counting uses the heap trace hooks (CONFIG_HEAP_USE_HOOKS),
+ * which run on every heap_caps allocation. The hook only bumps a counter
+ * in a fixed per-task table of the core it runs on, with interrupts
+ * masked on that core alone, so allocations on the two cores never
+ * contend. The tables are merged, and names logged, at phase end.
+ */
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mem_prof.h"
+
+static const char *TAG = "mem_prof";
+
+#define MEM_PROF_MAX_TASKS      32
+#define MEM_PROF_MAX_ALLOCATORS 16
+#define MEM_PROF_NAME_LEN       16
+
+static const uint32_t s_caps[MEM_PROF_CAPS_COUNT] = {
+    [MEM_PROF_INTERNAL] = MALLOC_CAP_INTERNAL,
+    [MEM_PROF_DMA]      = MALLOC_CAP_DMA,
+    [MEM_PROF_SPIRAM]   = MALLOC_CAP_SPIRAM,
+};
+
+static const char *s_caps_name[MEM_PROF_CAPS_COUNT] = {
+    [MEM_PROF_INTERNAL] = "INTERNAL",
+    [MEM_PROF_DMA]      = "DMA",
+    [MEM_PROF_SPIRAM]   = "SPIRAM",
+};
+
+/* ─── Phase state ─── */
+typedef struct {
+    char name[MEM_PROF_NAME_LEN];
+    uint32_t hwm_start;         /* 0 = task did not exist at phase start */
+    uint32_t hwm_min;           /* Lowest free stack seen (bytes) */
+} stack_entry_t;
+
+typedef struct {
+    TaskHandle_t task;          /* NULL = allocation from ISR */
+    char name[MEM_PROF_NAME_LEN];
+    uint32_t count;
+    uint32_t bytes;
+} alloc_entry_t;
+
+static const char *s_phase_name = NULL;
+static mem_prof_snapshot_t s_phase_start;
+static stack_entry_t s_stacks[MEM_PROF_MAX_TASKS];
+static int s_stack_count = 0;
+static TaskStatus_t s_task_status[MEM_PROF_MAX_TASKS];
+
+/* Written only by the owning core's hook, read at phase end */
+typedef struct {
+    alloc_entry_t allocs[MEM_PROF_MAX_ALLOCATORS];
+    int count;
+    uint32_t dropped;
+} alloc_table_t;
+
+static volatile bool s_alloc_tracking = false;
+static alloc_table_t s_alloc_tables[portNUM_PROCESSORS];
+
+/* ─── Heap snapshots ─── */
+
+void mem_prof_snapshot(mem_prof_snapshot_t *out)
+{
+    out->time_us = esp_timer_get_time();
+    for (int i = 0; i < MEM_PROF_CAPS_COUNT; i++) {
+        out->caps[i].total = heap_caps_get_total_size(s_caps[i]);
+        out->caps[i].free = heap_caps_get_free_size(s_caps[i]);
+        out->caps[i].largest = heap_caps_get_largest_free_block(s_caps[i]);
+        out->caps[i].min_free = heap_caps_get_minimum_free_size(s_caps[i]);
+    }
+}
+
+static float frag_pct(const mem_prof_caps_t *c)
+{
+    return (c->free > 0) ? 100.0f * (1.0f - (float)c->largest / c->free) : 0.0f;
+}
+
+void mem_prof_log_snapshot(const char *label, const mem_prof_snapshot_t *snap)
+{
+    ESP_LOGI(TAG, "  %s", label);
+    for (int i = 0; i < MEM_PROF_CAPS_COUNT; i++) {
+        const mem_prof_caps_t *c = &snap->caps[i];
+        if (c->total == 0) continue;
+        ESP_LOGI(TAG, "    %-8s free:%8lu / %8lu  largest:%8lu  min:%8lu  frag:%4.1f%%",
+                 s_caps_name[i], (unsigned long)c->free, (unsigned long)c->total,
+                 (unsigned long)c->largest, (unsigned long)c->min_free, frag_pct(c));
+    }
+}
+
+/* ─── Task stacks ─── */
+
+static stack_entry_t *stack_find(const char *name, bool create)
+{
+    for (int i = 0; i < s_stack_count; i++) {
+        if (strncmp(s_stacks[i].name, name, MEM_PROF_NAME_LEN) == 0) {
+            return &s_stacks[i];
+        }
+    }
+    if (!create || s_stack_count >= MEM_PROF_MAX_TASKS) {
+        return NULL;
+    }
+    stack_entry_t *e = &s_stacks[s_stack_count++];
+    strncpy(e->name, name, MEM_PROF_NAME_LEN - 1);
+    e->name[MEM_PROF_NAME_LEN - 1] = '\0';
+    e->hwm_start = 0;
+    e->hwm_min = UINT32_MAX;
+    return e;
+}
+
+static void sample_stacks(bool at_start)
+{
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    UBaseType_t n = uxTaskGetSystemState(s_task_status, MEM_PROF_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < n; i++) {
+        stack_entry_t *e = stack_find(s_task_status[i].pcTaskName, true);
+        if (!e) continue;
+        /* ESP-IDF reports the high-water mark in bytes */
+        uint32_t hwm = s_task_status[i].usStackHighWaterMark;
+        if (at_start) e->hwm_start = hwm;
+        if (hwm < e->hwm_min) e->hwm_min = hwm;
+    }
+#endif
+}
+
+void mem_prof_sample_stacks(void)
+{
+    if (s_phase_name) {
+        sample_stacks(false);
+    }
+}
+
+/* ─── Allocation hooks ─── */
+
+#if CONFIG_HEAP_USE_HOOKS
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (!s_alloc_tracking || !ptr) {
+        return;
+    }
+
+    bool in_isr = xPortInIsrContext();
+    TaskHandle_t task = in_isr ? NULL : xTaskGetCurrentTaskHandle();
+
+    /* Masking interrupts also pins the task to this core meanwhile */
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    alloc_table_t *t = &s_alloc_tables[xPortGetCoreID()];
+    alloc_entry_t *e = NULL;
+    for (int i = 0; i < t->count; i++) {
+        if (t->allocs[i].task == task) {
+            e = &t->allocs[i];
+            break;
+        }
+    }
+    if (!e && t->count < MEM_PROF_MAX_ALLOCATORS) {
+        e = &t->allocs[t->count++];
+        e->task = task;
+        e->count = 0;
+        e->bytes = 0;
+        strncpy(e->name, in_isr ? "(ISR)" : pcTaskGetName(NULL), MEM_PROF_NAME_LEN - 1);
+        e->name[MEM_PROF_NAME_LEN - 1] = '\0';
+    }
+    if (e) {
+        e->count++;
+        e->bytes += size;
+    } else {
+        t->dropped++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+}
+#endif
+
+/* ─── Phases ─── */
+
+void mem_prof_phase_begin(const char *name)
+{
+    s_phase_name = name;
+    s_stack_count = 0;
+    sample_stacks(true);
+
+    /* Hooks do nothing while tracking is off, so the tables are idle */
+    memset(s_alloc_tables, 0, sizeof(s_alloc_tables));
+    s_alloc_tracking = true;
+
+    mem_prof_snapshot(&s_phase_start);
+}
+
+void mem_prof_phase_end(void)
+{
+    if (!s_phase_name) {
+        return;
+    }
+
+    mem_prof_snapshot_t end;
+    mem_prof_snapshot(&end);
+    s_alloc_tracking = false;
+    sample_stacks(false);
+
+    float secs = (end.time_us - s_phase_start.time_us) / 1000000.0f;
+
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "── Memory: phase '%s' (%.1fs) ──", s_phase_name, secs);
+    mem_prof_log_snapshot("start:", &s_phase_start);
+    mem_prof_log_snapshot("end:", &end);
+    for (int i = 0; i < MEM_PROF_CAPS_COUNT; i++) {
+        if (end.caps[i].total == 0) continue;
+        int32_t delta = (int32_t)end.caps[i].free - (int32_t)s_phase_start.caps[i].free;
+        ESP_LOGI(TAG, "    %-8s delta:%+8ld  frag %4.1f%% -> %4.1f%%",
+                 s_caps_name[i], (long)delta,
+                 frag_pct(&s_phase_start.caps[i]), frag_pct(&end.caps[i]));
+    }
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    ESP_LOGI(TAG, "  Task stacks (min free bytes):");
+    for (int i = 0; i < s_stack_count; i++) {
+        const stack_entry_t *e = &s_stacks[i];
+        if (e->hwm_start) {
+            ESP_LOGI(TAG, "    %-16s %6lu (start %lu)",
+                     e->name, (unsigned long)e->hwm_min, (unsigned long)e->hwm_start);
+        } else {
+            ESP_LOGI(TAG, "    %-16s %6lu (new)", e->name, (unsigned long)e->hwm_min);
+        }
+    }
+#endif
+
+#if CONFIG_HEAP_USE_HOOKS
+    /* Tracking is off: merge per-core entries of tasks that migrated */
+    int n = 0;
+    alloc_entry_t allocs[MEM_PROF_MAX_ALLOCATORS];
+    uint32_t dropped = 0;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        const alloc_table_t *t = &s_alloc_tables[c];
+        dropped += t->dropped;
+        for (int i = 0; i < t->count; i++) {
+            int j = 0;
+            while (j < n && allocs[j].task != t->allocs[i].task) j++;
+            if (j == n) {
+                if (n == MEM_PROF_MAX_ALLOCATORS) {
+                    dropped += t->allocs[i].count;
+                    continue;
+                }
+                allocs[n++] = t->allocs[i];
+            } else {
+                allocs[j].count += t->allocs[i].count;
+                allocs[j].bytes += t->allocs[i].bytes;
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "  Allocations by task:");
+    for (int i = 0; i < n; i++) {
+        float per_sec = (secs > 0) ? allocs[i].count / secs : 0;
+        /* More than one allocation per second in steady state is a hot path */
+        ESP_LOGI(TAG, "    %-16s %7lu allocs %9lu bytes (%6.1f/s)%s",
+                 allocs[i].name, (unsigned long)allocs[i].count,
+                 (unsigned long)allocs[i].bytes, per_sec,
+                 per_sec > 1.0f ? "  << HOT PATH" : "");
+    }
+    if (dropped) {
+        ESP_LOGW(TAG, "    (%lu allocs from untracked tasks)", (unsigned long)dropped);
+    }
+#endif
+
+    s_phase_name = NULL;
+}
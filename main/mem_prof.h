@@ -0,0 +1,86 @@
+/*
+ * Memory Profiler - per-phase heap and stack accounting
+ *
+ * Snapshots heap_caps per capability (internal, DMA, PSRAM) with the
+ * largest free block as a fragmentation indicator, tracks per-task
+ * stack high-water marks, and counts allocations per task while a
+ * phase is active so hot-path mallocs stand out.
+ */
+
+#ifndef MEM_PROF_H
+#define MEM_PROF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Heap capability classes that are tracked
+ */
+typedef enum {
+    MEM_PROF_INTERNAL = 0,
+    MEM_PROF_DMA,
+    MEM_PROF_SPIRAM,
+    MEM_PROF_CAPS_COUNT,
+} mem_prof_caps_id_t;
+
+/**
+ * @brief Heap state for one capability class
+ */
+typedef struct {
+    uint32_t total;         /**< Heap size for this capability */
+    uint32_t free;          /**< Current free bytes */
+    uint32_t largest;       /**< Largest allocatable block */
+    uint32_t min_free;      /**< Low-water mark since boot */
+} mem_prof_caps_t;
+
+/**
+ * @brief Heap snapshot across all tracked capabilities
+ */
+typedef struct {
+    int64_t time_us;
+    mem_prof_caps_t caps[MEM_PROF_CAPS_COUNT];
+} mem_prof_snapshot_t;
+
+/**
+ * @brief Fill a heap snapshot for all tracked capabilities
+ */
+void mem_prof_snapshot(mem_prof_snapshot_t *out);
+
+/**
+ * @brief Log a heap snapshot (one line per capability)
+ */
+void mem_prof_log_snapshot(const char *label, const mem_prof_snapshot_t *snap);
+
+/**
+ * @brief Start a profiled phase
+ *
+ * Takes a heap snapshot, records current task stack high-water marks
+ * and starts counting allocations per task (needs CONFIG_HEAP_USE_HOOKS).
+ *
+ * @param name Phase name (string must outlive the phase)
+ */
+void mem_prof_phase_begin(const char *name);
+
+/**
+ * @brief Record stack high-water marks of all live tasks
+ *
+ * Call before short-lived worker tasks exit so their stack usage is
+ * captured in the phase report.
+ */
+void mem_prof_sample_stacks(void);
+
+/**
+ * @brief End the current phase and log heap deltas, fragmentation,
+ *        stack high-water marks and allocating tasks
+ */
+void mem_prof_phase_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_PROF_H */
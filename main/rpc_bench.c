@@ -0,0 +1,249 @@
+/*
+ * RPC Bench - implementation
+ *
+ * A counting semaphore holds one token per allowed request in flight:
+ * the sender takes one per echo and the reply callback gives it back.
+ * Sequence numbers keep increasing across points, so a late reply to an
+ * earlier point is recognized and dropped.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "wifi_raw.h"
+#include "rpc_bench.h"
+
+static const char *TAG = "rpc_bench";
+
+typedef struct {
+    int64_t host_tx;
+    int64_t slave_rx;
+    int64_t slave_tx;
+    int64_t host_rx;            /* 0 until answered */
+} sample_t;
+
+static struct {
+    SemaphoreHandle_t slots;
+    SemaphoreHandle_t done;
+    sample_t *samples;
+    uint32_t seq_base;
+    volatile uint32_t count;
+    uint16_t size;
+    volatile uint32_t received;
+    volatile uint32_t target;   /* Replies that end the point, lowered to sent */
+    volatile uint32_t bad_len;
+} s_run;
+
+static uint32_t s_next_seq;
+
+static void echo_cb(const wifi_raw_echo_t *echo)
+{
+    uint32_t i = echo->seq - s_run.seq_base;
+    if (i >= s_run.count || s_run.samples[i].host_rx != 0) {
+        return;     /* Earlier point, or duplicate */
+    }
+    if (echo->data_len != s_run.size) {
+        s_run.bad_len++;
+    }
+
+    sample_t *smp = &s_run.samples[i];
+    smp->host_tx = echo->host_tx_us;
+    smp->slave_rx = echo->slave_rx_us;
+    smp->slave_tx = echo->slave_tx_us;
+    smp->host_rx = echo->host_rx_us;
+
+    s_run.received++;
+    xSemaphoreGive(s_run.slots);
+    if (s_run.received == s_run.target) {
+        xSemaphoreGive(s_run.done);
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void percentiles(uint32_t *v, uint32_t n, rpc_bench_pct_t *out)
+{
+    qsort(v, n, sizeof(*v), cmp_u32);
+    out->p50 = v[(n - 1) * 50 / 100];
+    out->p90 = v[(n - 1) * 90 / 100];
+    out->p99 = v[(n - 1) * 99 / 100];
+    out->max = v[n - 1];
+}
+
+static uint32_t clamp_us(int64_t us)
+{
+    return (us < 0) ? 0 : (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+static esp_err_t summarize(const sample_t *smp, uint32_t count, rpc_bench_result_t *out)
+{
+    uint32_t n = 0;
+    int64_t first_tx = INT64_MAX, last_rx = 0;
+    int64_t best_net = INT64_MAX, offset = 0;
+
+    /* Clock offset from the fastest exchange, taken as symmetric */
+    for (uint32_t i = 0; i < count; i++) {
+        if (smp[i].host_rx == 0) continue;
+        n++;
+        if (smp[i].host_tx < first_tx) first_tx = smp[i].host_tx;
+        if (smp[i].host_rx > last_rx) last_rx = smp[i].host_rx;
+        int64_t net = (smp[i].host_rx - smp[i].host_tx) - (smp[i].slave_tx - smp[i].slave_rx);
+        if (net < best_net) {
+            best_net = net;
+            offset = ((smp[i].slave_rx - smp[i].host_tx) + (smp[i].slave_tx - smp[i].host_rx)) / 2;
+        }
+    }
+    out->received = n;
+    if (n == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint32_t *v = malloc(3 * n * sizeof(uint32_t));
+    if (!v) {
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t *rtt = v, *up = v + n, *down = v + 2 * n;
+    for (uint32_t i = 0, k = 0; i < count; i++) {
+        if (smp[i].host_rx == 0) continue;
+        rtt[k] = clamp_us(smp[i].host_rx - smp[i].host_tx);
+        up[k] = clamp_us(smp[i].slave_rx - offset - smp[i].host_tx);
+        down[k] = clamp_us(smp[i].host_rx - (smp[i].slave_tx - offset));
+        k++;
+    }
+    percentiles(rtt, n, &out->rtt_us);
+    percentiles(up, n, &out->up_us);
+    percentiles(down, n, &out->down_us);
+    free(v);
+
+    float secs = (last_rx - first_tx) / 1000000.0f;
+    out->msgs_per_sec = secs > 0 ? n / secs : 0.0f;
+    out->mbytes_per_sec = secs > 0 ? (float)n * out->size / secs / 1000000.0f : 0.0f;
+    return ESP_OK;
+}
+
+esp_err_t rpc_bench_point(uint16_t size, uint8_t depth, uint32_t count,
+                          uint32_t timeout_ms, rpc_bench_result_t *out)
+{
+    if (size > RPC_BENCH_MAX_PAYLOAD || depth == 0 || depth > RPC_BENCH_MAX_DEPTH ||
+        count == 0 || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->size = size;
+    out->depth = depth;
+
+    uint8_t *payload = malloc(size ? size : 1);
+    sample_t *samples = calloc(count, sizeof(sample_t));
+    s_run.slots = xSemaphoreCreateCounting(depth, depth);
+    s_run.done = xSemaphoreCreateBinary();
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (!payload || !samples || !s_run.slots || !s_run.done) {
+        goto cleanup;
+    }
+    for (uint16_t i = 0; i < size; i++) {
+        payload[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    s_run.samples = samples;
+    s_run.seq_base = s_next_seq;
+    s_run.size = size;
+    s_run.received = 0;
+    s_run.bad_len = 0;
+    s_run.count = count;
+    s_run.target = count;
+    s_next_seq += count;
+    wifi_raw_register_echo_cb(echo_cb);
+
+    TickType_t wait = pdMS_TO_TICKS(timeout_ms);
+    for (uint32_t i = 0; i < count; i++) {
+        /* On timeout a reply went missing and its token with it: go on */
+        xSemaphoreTake(s_run.slots, wait);
+        if (wifi_raw_echo_send(s_run.seq_base + i, payload, size) == ESP_OK) {
+            out->sent++;
+        }
+    }
+    /* A failed send has no reply coming: wait only for the ones sent */
+    s_run.target = out->sent;
+    if (s_run.received < out->sent) {
+        xSemaphoreTake(s_run.done, wait);
+    }
+
+    /* Waits for a late reply still inside echo_cb before the buffers go */
+    wifi_raw_register_echo_cb(NULL);
+    s_run.count = 0;
+
+    if (s_run.bad_len) {
+        ESP_LOGW(TAG, "%lu replies with wrong payload length", (unsigned long)s_run.bad_len);
+    }
+    ret = summarize(samples, count, out);
+
+cleanup:
+    if (s_run.slots) vSemaphoreDelete(s_run.slots);
+    if (s_run.done) vSemaphoreDelete(s_run.done);
+    s_run.slots = NULL;
+    s_run.done = NULL;
+    free(samples);
+    free(payload);
+    return ret;
+}
+
+static void log_point(const rpc_bench_result_t *r)
+{
+    ESP_LOGI(TAG, "%5u %5u | %6lu %6lu %6lu %6lu | %6lu %6lu | %6lu %6lu | %7.0f %6.3f | %lu",
+             r->size, r->depth,
+             (unsigned long)r->rtt_us.p50, (unsigned long)r->rtt_us.p90,
+             (unsigned long)r->rtt_us.p99, (unsigned long)r->rtt_us.max,
+             (unsigned long)r->up_us.p50, (unsigned long)r->up_us.p99,
+             (unsigned long)r->down_us.p50, (unsigned long)r->down_us.p99,
+             r->msgs_per_sec, r->mbytes_per_sec,
+             (unsigned long)(r->sent - r->received));
+
+    /* One grep-able line per point for log scrapers */
+    ESP_LOGI(TAG, "RPC_BENCH {\"size\":%u,\"depth\":%u,\"sent\":%lu,\"recv\":%lu,"
+             "\"rtt_p50_us\":%lu,\"rtt_p90_us\":%lu,\"rtt_p99_us\":%lu,\"rtt_max_us\":%lu,"
+             "\"up_p50_us\":%lu,\"up_p99_us\":%lu,\"down_p50_us\":%lu,\"down_p99_us\":%lu,"
+             "\"msgs_s\":%.1f,\"mb_s\":%.4f}",
+             r->size, r->depth, (unsigned long)r->sent, (unsigned long)r->received,
+             (unsigned long)r->rtt_us.p50, (unsigned long)r->rtt_us.p90,
+             (unsigned long)r->rtt_us.p99, (unsigned long)r->rtt_us.max,
+             (unsigned long)r->up_us.p50, (unsigned long)r->up_us.p99,
+             (unsigned long)r->down_us.p50, (unsigned long)r->down_us.p99,
+             r->msgs_per_sec, r->mbytes_per_sec);
+}
+
+esp_err_t rpc_bench_run(const rpc_bench_config_t *cfg)
+{
+    rpc_bench_result_t r;
+
+    /* Stock slaves drop unknown CustomRpc messages */
+    if (rpc_bench_point(cfg->n_sizes ? cfg->sizes[0] : 0, 1, 1, cfg->timeout_ms, &r) != ESP_OK) {
+        ESP_LOGW(TAG, "Slave does not answer ECHO (no wifi_raw extension?), skipping");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    ESP_LOGI(TAG, "%lu echoes per point; latencies in us, MB/s of payload each way",
+             (unsigned long)cfg->msgs_per_point);
+    ESP_LOGI(TAG, " size depth |    RTT p50    p90    p99    max |  up p50    p99 | "
+             "dn p50    p99 |   msg/s   MB/s | lost");
+    for (size_t s = 0; s < cfg->n_sizes; s++) {
+        for (size_t d = 0; d < cfg->n_depths; d++) {
+            esp_err_t ret = rpc_bench_point(cfg->sizes[s], cfg->depths[d], cfg->msgs_per_point,
+                                            cfg->timeout_ms, &r);
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "size %u depth %u: %s", cfg->sizes[s], cfg->depths[d],
+                         esp_err_to_name(ret));
+                continue;
+            }
+            log_point(&r);
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,95 @@
+/*
+ * RPC Bench - CustomRpc echo latency and throughput sweep
+ *
+ * Sends WIFI_RAW_MSG_ECHO to the slave with a fixed number of requests
+ * in flight and times the replies. For every (payload size, depth)
+ * point it reports round-trip and estimated one-way latency percentiles
+ * and sustained messages/s and MB/s: the baseline to compare transport
+ * changes against.
+ */
+
+#ifndef RPC_BENCH_H
+#define RPC_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest echo payload accepted by rpc_bench_point() */
+#define RPC_BENCH_MAX_PAYLOAD   4000
+/** Largest number of echoes in flight */
+#define RPC_BENCH_MAX_DEPTH     32
+
+/**
+ * @brief Sweep description
+ */
+typedef struct {
+    const uint16_t *sizes;      /**< Payload sizes to test */
+    size_t n_sizes;
+    const uint8_t *depths;      /**< Requests in flight to test */
+    size_t n_depths;
+    uint32_t msgs_per_point;    /**< Echoes per (size, depth) point */
+    uint32_t timeout_ms;        /**< Reply timeout before an echo counts as lost */
+} rpc_bench_config_t;
+
+/**
+ * @brief Latency percentiles in microseconds
+ */
+typedef struct {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} rpc_bench_pct_t;
+
+/**
+ * @brief Result of one (size, depth) point
+ *
+ * One-way latencies assume the fastest round trip was symmetric, which
+ * fixes the offset between the host and slave clocks (as in NTP).
+ */
+typedef struct {
+    uint16_t size;
+    uint8_t depth;
+    uint32_t sent;
+    uint32_t received;
+    rpc_bench_pct_t rtt_us;     /**< Host send to host receive */
+    rpc_bench_pct_t up_us;      /**< Host send to slave receive (estimated) */
+    rpc_bench_pct_t down_us;    /**< Slave send to host receive (estimated) */
+    float msgs_per_sec;         /**< Replies per second, first send to last reply */
+    float mbytes_per_sec;       /**< Payload MB/s in each direction */
+} rpc_bench_result_t;
+
+/**
+ * @brief Measure one (size, depth) point
+ *
+ * wifi_raw_init() must have been called.
+ *
+ * @param size Payload bytes (0..RPC_BENCH_MAX_PAYLOAD)
+ * @param depth Requests in flight (1..RPC_BENCH_MAX_DEPTH)
+ * @param count Echoes to send
+ * @param timeout_ms Reply timeout
+ * @param out Filled on success
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM, ESP_ERR_TIMEOUT if
+ *         no reply arrived at all
+ */
+esp_err_t rpc_bench_point(uint16_t size, uint8_t depth, uint32_t count,
+                          uint32_t timeout_ms, rpc_bench_result_t *out);
+
+/**
+ * @brief Run a sweep and log a table plus one RPC_BENCH JSON line per point
+ *
+ * @param cfg Sweep description
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if the slave does not answer echoes
+ */
+esp_err_t rpc_bench_run(const rpc_bench_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RPC_BENCH_H */
@@ -0,0 +1,97 @@
+/*
+ * TCP Probe - implementation
+ *
+ * Walks tcp_active_pcbs under the TCPIP core lock. Only fields are
+ * copied while the lock is held; logging happens afterwards.
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "lwip/opt.h"
+#include "lwip/tcp.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcpip.h"
+#include "lwip/stats.h"
+#include "tcp_probe.h"
+
+static const char *TAG = "tcp_probe";
+
+static tcp_probe_snapshot_t s_ring[TCP_PROBE_RING_SIZE];
+static uint32_t s_ring_count = 0;   /* Total pushes since reset */
+
+static uint16_t seg_count(const struct tcp_seg *seg)
+{
+    uint16_t n = 0;
+    for (; seg; seg = seg->next) n++;
+    return n;
+}
+
+esp_err_t tcp_probe_sample(uint32_t remote_ip, uint16_t remote_port,
+                           tcp_probe_snapshot_t *out)
+{
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    LOCK_TCPIP_CORE();
+    for (struct tcp_pcb *pcb = tcp_active_pcbs; pcb; pcb = pcb->next) {
+        if (pcb->remote_port != remote_port ||
+            ip_addr_get_ip4_u32(&pcb->remote_ip) != remote_ip) {
+            continue;
+        }
+        out->state = (uint8_t)pcb->state;
+        out->nrtx = pcb->nrtx;
+        out->dupacks = pcb->dupacks;
+        out->cwnd = pcb->cwnd;
+        out->ssthresh = pcb->ssthresh;
+        out->snd_wnd = pcb->snd_wnd;
+        out->rto_ms = (uint32_t)pcb->rto * TCP_SLOW_INTERVAL;
+        out->in_flight = pcb->snd_nxt - pcb->lastack;
+        out->snd_buf = pcb->snd_buf;
+        out->snd_queuelen = pcb->snd_queuelen;
+        out->unsent = seg_count(pcb->unsent);
+        out->unacked = seg_count(pcb->unacked);
+        ret = ESP_OK;
+        break;
+    }
+#if TCP_STATS
+    out->rexmit_total = lwip_stats.tcp.rexmit;
+#else
+    out->rexmit_total = 0;
+#endif
+    UNLOCK_TCPIP_CORE();
+
+    return ret;
+}
+
+void tcp_probe_ring_reset(void)
+{
+    s_ring_count = 0;
+}
+
+void tcp_probe_ring_push(const tcp_probe_snapshot_t *snap)
+{
+    s_ring[s_ring_count % TCP_PROBE_RING_SIZE] = *snap;
+    s_ring_count++;
+}
+
+void tcp_probe_log(const tcp_probe_snapshot_t *s)
+{
+    ESP_LOGI(TAG, "  t=%6lus bytes=%llu st=%u cwnd=%lu ssth=%lu wnd=%lu rto=%lums "
+             "infl=%lu sndbuf=%u q=%u unsent=%u unacked=%u nrtx=%u dup=%u rexmit=%lu",
+             (unsigned long)(s->t_ms / 1000), (unsigned long long)s->app_bytes,
+             s->state, (unsigned long)s->cwnd, (unsigned long)s->ssthresh,
+             (unsigned long)s->snd_wnd, (unsigned long)s->rto_ms,
+             (unsigned long)s->in_flight, s->snd_buf, s->snd_queuelen,
+             s->unsent, s->unacked, s->nrtx, s->dupacks,
+             (unsigned long)s->rexmit_total);
+}
+
+void tcp_probe_ring_dump(const char *reason)
+{
+    uint32_t n = (s_ring_count < TCP_PROBE_RING_SIZE) ? s_ring_count : TCP_PROBE_RING_SIZE;
+    uint32_t first = s_ring_count - n;
+
+    ESP_LOGW(TAG, "── %s: last %lu snapshots ──", reason, (unsigned long)n);
+    for (uint32_t i = 0; i < n; i++) {
+        tcp_probe_log(&s_ring[(first + i) % TCP_PROBE_RING_SIZE]);
+    }
+}
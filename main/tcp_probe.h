@@ -0,0 +1,81 @@
+/*
+ * TCP Probe - lwIP tcp_pcb state sampling for long-running tests
+ *
+ * Reads congestion/window/queue state of an active TCP connection
+ * straight from lwIP's pcb list and keeps a ring of recent snapshots
+ * so a stall can be diagnosed from the state leading up to it.
+ */
+
+#ifndef TCP_PROBE_H
+#define TCP_PROBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of snapshots retained in the history ring */
+#define TCP_PROBE_RING_SIZE     32
+
+/**
+ * @brief One sample of a connection's tcp_pcb state
+ */
+typedef struct {
+    uint32_t t_ms;          /**< Time since soak start */
+    uint64_t app_bytes;     /**< Bytes accepted by send() so far */
+    uint8_t state;          /**< enum tcp_state */
+    uint8_t nrtx;           /**< Retransmissions of the current segment */
+    uint8_t dupacks;        /**< Duplicate ACKs received */
+    uint32_t cwnd;          /**< Congestion window (bytes) */
+    uint32_t ssthresh;      /**< Slow-start threshold (bytes) */
+    uint32_t snd_wnd;       /**< Peer's advertised window (bytes) */
+    uint32_t rto_ms;        /**< Retransmission timeout */
+    uint32_t in_flight;     /**< snd_nxt - lastack (bytes) */
+    uint16_t snd_buf;       /**< Free space in send buffer */
+    uint16_t snd_queuelen;  /**< pbufs queued for sending */
+    uint16_t unsent;        /**< Segments on the unsent queue */
+    uint16_t unacked;       /**< Segments on the unacked queue */
+    uint32_t rexmit_total;  /**< Stack-wide TCP retransmits (0 without LWIP_STATS) */
+} tcp_probe_snapshot_t;
+
+/**
+ * @brief Sample the pcb connected to the given remote endpoint
+ *
+ * @param remote_ip Remote IPv4 address (network byte order)
+ * @param remote_port Remote port (host byte order)
+ * @param out Snapshot to fill (t_ms and app_bytes are left to the caller)
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if no active pcb matches
+ */
+esp_err_t tcp_probe_sample(uint32_t remote_ip, uint16_t remote_port,
+                           tcp_probe_snapshot_t *out);
+
+/**
+ * @brief Clear the snapshot history ring
+ */
+void tcp_probe_ring_reset(void);
+
+/**
+ * @brief Append a snapshot to the history ring (oldest entry is overwritten)
+ */
+void tcp_probe_ring_push(const tcp_probe_snapshot_t *snap);
+
+/**
+ * @brief Log every snapshot in the ring, oldest first
+ *
+ * @param reason Header line describing why the ring is dumped
+ */
+void tcp_probe_ring_dump(const char *reason);
+
+/**
+ * @brief Log a single snapshot on one line
+ */
+void tcp_probe_log(const tcp_probe_snapshot_t *snap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TCP_PROBE_H */
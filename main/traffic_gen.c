@@ -0,0 +1,136 @@
+/*
+ * Traffic Generator - implementation
+ *
+ * All distributions are reduced to a cumulative weight table at init so
+ * the per-packet cost is one xorshift32 step plus a short linear scan.
+ */
+
+#include <string.h>
+#include <stdbool.h>
+#include "traffic_gen.h"
+
+/* Simple IMIX (IP packet sizes 40/576/1500, weights 7:4:1) as UDP payloads */
+static const traffic_size_weight_t s_imix[] = {
+    { 40 - TRAFFIC_IP_UDP_OVERHEAD,   7 },
+    { 576 - TRAFFIC_IP_UDP_OVERHEAD,  4 },
+    { 1500 - TRAFFIC_IP_UDP_OVERHEAD, 1 },
+};
+
+static const char *s_class_names[TRAFFIC_CLASS_COUNT] = {
+    [TRAFFIC_CLASS_TINY]   = "<128",
+    [TRAFFIC_CLASS_SMALL]  = "128-511",
+    [TRAFFIC_CLASS_MEDIUM] = "512-1023",
+    [TRAFFIC_CLASS_LARGE]  = ">=1024",
+};
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static bool size_valid(uint16_t size)
+{
+    return size > 0 && size <= TRAFFIC_MAX_UDP_PAYLOAD;
+}
+
+static esp_err_t load_table(traffic_gen_t *gen, const traffic_size_weight_t *table, size_t n)
+{
+    if (!table || n == 0 || n > TRAFFIC_MAX_TABLE_ENTRIES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t total = 0;
+    gen->min_size = UINT16_MAX;
+    gen->max_size = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!size_valid(table[i].size) || table[i].weight == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        total += table[i].weight;
+        gen->sizes[i] = table[i].size;
+        gen->cumulative[i] = total;
+        if (table[i].size < gen->min_size) gen->min_size = table[i].size;
+        if (table[i].size > gen->max_size) gen->max_size = table[i].size;
+    }
+    gen->n_entries = n;
+    gen->total_weight = total;
+    return ESP_OK;
+}
+
+esp_err_t traffic_gen_init(traffic_gen_t *gen, const traffic_dist_t *dist, uint32_t seed)
+{
+    if (!gen || !dist) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(gen, 0, sizeof(*gen));
+    gen->type = dist->type;
+    gen->rng = seed ? seed : 0x9E3779B9u;
+
+    switch (dist->type) {
+    case TRAFFIC_DIST_FIXED:
+        if (!size_valid(dist->min_size)) return ESP_ERR_INVALID_ARG;
+        gen->min_size = gen->max_size = dist->min_size;
+        return ESP_OK;
+    case TRAFFIC_DIST_UNIFORM:
+        if (!size_valid(dist->min_size) || !size_valid(dist->max_size) ||
+            dist->min_size > dist->max_size) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        gen->min_size = dist->min_size;
+        gen->max_size = dist->max_size;
+        return ESP_OK;
+    case TRAFFIC_DIST_IMIX:
+        return load_table(gen, s_imix, sizeof(s_imix) / sizeof(s_imix[0]));
+    case TRAFFIC_DIST_TABLE:
+        return load_table(gen, dist->table, dist->table_len);
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+uint16_t traffic_gen_next(traffic_gen_t *gen)
+{
+    switch (gen->type) {
+    case TRAFFIC_DIST_FIXED:
+        return gen->min_size;
+    case TRAFFIC_DIST_UNIFORM: {
+        uint32_t span = (uint32_t)(gen->max_size - gen->min_size) + 1;
+        return gen->min_size + (uint16_t)(xorshift32(&gen->rng) % span);
+    }
+    default: {
+        uint32_t r = xorshift32(&gen->rng) % gen->total_weight;
+        for (size_t i = 0; i < gen->n_entries; i++) {
+            if (r < gen->cumulative[i]) {
+                return gen->sizes[i];
+            }
+        }
+        return gen->sizes[gen->n_entries - 1];
+    }
+    }
+}
+
+uint16_t traffic_gen_max_size(const traffic_gen_t *gen)
+{
+    return gen->max_size;
+}
+
+const char *traffic_gen_name(const traffic_gen_t *gen)
+{
+    switch (gen->type) {
+    case TRAFFIC_DIST_FIXED:   return "fixed";
+    case TRAFFIC_DIST_UNIFORM: return "uniform";
+    case TRAFFIC_DIST_IMIX:    return "IMIX";
+    case TRAFFIC_DIST_TABLE:   return "table";
+    }
+    return "?";
+}
+
+const char *traffic_size_class_name(traffic_size_class_t cls)
+{
+    return (cls < TRAFFIC_CLASS_COUNT) ? s_class_names[cls] : "?";
+}
@@ -0,0 +1,134 @@
+/*
+ * Traffic Generator - packet size distributions for throughput tests
+ *
+ * Draws UDP payload sizes from a fixed size, a uniform range, the
+ * simple IMIX (7:4:1 of 40/576/1500-byte IP packets) or a custom
+ * weighted table, and classifies sizes for per-class statistics.
+ */
+
+#ifndef TRAFFIC_GEN_H
+#define TRAFFIC_GEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest UDP payload that fits a 1500-byte MTU without fragmentation */
+#define TRAFFIC_MAX_UDP_PAYLOAD     1472
+/** IPv4 + UDP header bytes, subtracted from IMIX IP packet sizes */
+#define TRAFFIC_IP_UDP_OVERHEAD     28
+/** Maximum entries in a weighted size table */
+#define TRAFFIC_MAX_TABLE_ENTRIES   16
+
+/**
+ * @brief Size distribution type
+ */
+typedef enum {
+    TRAFFIC_DIST_FIXED = 0,     /**< Always min_size */
+    TRAFFIC_DIST_UNIFORM,       /**< Uniform in [min_size, max_size] */
+    TRAFFIC_DIST_IMIX,          /**< Simple IMIX 7:4:1 */
+    TRAFFIC_DIST_TABLE,         /**< Custom weighted table */
+} traffic_dist_type_t;
+
+/**
+ * @brief One entry of a weighted size table
+ */
+typedef struct {
+    uint16_t size;              /**< UDP payload bytes */
+    uint16_t weight;            /**< Relative frequency */
+} traffic_size_weight_t;
+
+/**
+ * @brief Size distribution description
+ */
+typedef struct {
+    traffic_dist_type_t type;
+    uint16_t min_size;                      /**< FIXED size / UNIFORM lower bound */
+    uint16_t max_size;                      /**< UNIFORM upper bound */
+    const traffic_size_weight_t *table;     /**< TABLE entries */
+    size_t table_len;                       /**< TABLE entry count */
+} traffic_dist_t;
+
+#define TRAFFIC_DIST_FIXED_INIT(sz) \
+    { .type = TRAFFIC_DIST_FIXED, .min_size = (sz), .max_size = (sz) }
+#define TRAFFIC_DIST_UNIFORM_INIT(lo, hi) \
+    { .type = TRAFFIC_DIST_UNIFORM, .min_size = (lo), .max_size = (hi) }
+#define TRAFFIC_DIST_IMIX_INIT() \
+    { .type = TRAFFIC_DIST_IMIX }
+#define TRAFFIC_DIST_TABLE_INIT(tbl, n) \
+    { .type = TRAFFIC_DIST_TABLE, .table = (tbl), .table_len = (n) }
+
+/**
+ * @brief Generator state (one per sending task)
+ */
+typedef struct {
+    traffic_dist_type_t type;
+    uint16_t min_size;
+    uint16_t max_size;
+    uint32_t rng;
+    uint32_t total_weight;
+    size_t n_entries;
+    uint16_t sizes[TRAFFIC_MAX_TABLE_ENTRIES];
+    uint32_t cumulative[TRAFFIC_MAX_TABLE_ENTRIES];
+} traffic_gen_t;
+
+/** Size classes used for per-class statistics */
+typedef enum {
+    TRAFFIC_CLASS_TINY = 0,     /**< < 128 bytes (telemetry, ACK-sized) */
+    TRAFFIC_CLASS_SMALL,        /**< 128 - 511 */
+    TRAFFIC_CLASS_MEDIUM,       /**< 512 - 1023 */
+    TRAFFIC_CLASS_LARGE,        /**< >= 1024 (bulk) */
+    TRAFFIC_CLASS_COUNT,
+} traffic_size_class_t;
+
+/**
+ * @brief Prepare a generator for a distribution
+ *
+ * @param gen Generator to initialize
+ * @param dist Distribution (table is copied; caller's table may go away)
+ * @param seed PRNG seed (0 is replaced by a fixed non-zero seed)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG for empty/oversized tables,
+ *         zero weights or sizes outside 1..TRAFFIC_MAX_UDP_PAYLOAD
+ */
+esp_err_t traffic_gen_init(traffic_gen_t *gen, const traffic_dist_t *dist, uint32_t seed);
+
+/**
+ * @brief Draw the next payload size
+ */
+uint16_t traffic_gen_next(traffic_gen_t *gen);
+
+/**
+ * @brief Largest size the generator can return (for buffer allocation)
+ */
+uint16_t traffic_gen_max_size(const traffic_gen_t *gen);
+
+/**
+ * @brief Human-readable distribution name
+ */
+const char *traffic_gen_name(const traffic_gen_t *gen);
+
+/**
+ * @brief Map a payload size to its statistics class
+ */
+static inline traffic_size_class_t traffic_size_class(uint16_t size)
+{
+    if (size < 128) return TRAFFIC_CLASS_TINY;
+    if (size < 512) return TRAFFIC_CLASS_SMALL;
+    if (size < 1024) return TRAFFIC_CLASS_MEDIUM;
+    return TRAFFIC_CLASS_LARGE;
+}
+
+/**
+ * @brief Label for a size class (e.g. "<128")
+ */
+const char *traffic_size_class_name(traffic_size_class_t cls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRAFFIC_GEN_H */
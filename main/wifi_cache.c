@@ -0,0 +1,73 @@
+/*
+ * WiFi Cache - NVS persistence
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "nvs.h"
+#include "wifi_cache.h"
+
+static const char *TAG = "wifi_cache";
+
+#define WIFI_CACHE_NAMESPACE    "wifi_cache"
+#define WIFI_CACHE_KEY          "last_ap"
+#define WIFI_CACHE_VERSION      2
+
+esp_err_t wifi_cache_load(wifi_cache_t *out)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t len = sizeof(*out);
+    ret = nvs_get_blob(nvs, WIFI_CACHE_KEY, out, &len);
+    nvs_close(nvs);
+
+    if (ret != ESP_OK || len != sizeof(*out) || out->version != WIFI_CACHE_VERSION ||
+        out->channel == 0 || out->ssid[0] == '\0') {
+        return ESP_ERR_NOT_FOUND;
+    }
+    out->ssid[sizeof(out->ssid) - 1] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t wifi_cache_save(const wifi_cache_t *cache)
+{
+    wifi_cache_t rec = *cache;
+    rec.version = WIFI_CACHE_VERSION;
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "nvs_open failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = nvs_set_blob(nvs, WIFI_CACHE_KEY, &rec, sizeof(rec));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Saving cache failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t wifi_cache_erase(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_erase_key(nvs, WIFI_CACHE_KEY);
+    if (ret == ESP_OK || ret == ESP_ERR_NVS_NOT_FOUND) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
@@ -0,0 +1,56 @@
+/*
+ * WiFi Cache - last good AP and DHCP lease persisted in NVS
+ *
+ * Lets the next boot do a directed connect (known BSSID + channel, no
+ * full scan) and reuse the previous IP configuration instead of DHCP.
+ */
+
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Cached connection parameters (stored as one NVS blob)
+ */
+typedef struct {
+    uint32_t version;           /**< Layout version, mismatches are ignored */
+    char ssid[33];              /**< SSID the BSSID belongs to */
+    uint8_t bssid[6];           /**< AP BSSID */
+    uint8_t channel;            /**< Primary channel */
+    uint32_t ip;                /**< IPv4 address (network byte order) */
+    uint32_t netmask;           /**< Netmask (network byte order) */
+    uint32_t gw;                /**< Gateway (network byte order) */
+    uint32_t dns;               /**< Main DNS server (network byte order) */
+    uint32_t lease_s;           /**< DHCP lease time, 0 = unknown (never reused) */
+    int64_t acquired_s;         /**< RTC time() when the lease was obtained */
+    uint32_t full_connect_ms;   /**< Time-to-IP of the last scan + DHCP connect */
+} wifi_cache_t;
+
+/**
+ * @brief Load the cached connection
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if nothing valid is stored
+ */
+esp_err_t wifi_cache_load(wifi_cache_t *out);
+
+/**
+ * @brief Store the connection for the next boot
+ */
+esp_err_t wifi_cache_save(const wifi_cache_t *cache);
+
+/**
+ * @brief Forget the cached connection (after a failed directed connect)
+ */
+esp_err_t wifi_cache_erase(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_CACHE_H */
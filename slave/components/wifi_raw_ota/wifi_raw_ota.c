@@ -0,0 +1,715 @@
+/*
+ * WiFi Raw OTA - implementation
+ *
+ * The first stream bytes are held back until the header magic says
+ * which decoder to start. Decoder output is written with
+ * esp_partition_write() at the image offset, erasing ERASE_STEP bytes
+ * ahead of the writer, so nothing depends on esp_ota_write()'s
+ * sequential handle. END lets esp_ota_set_boot_partition() verify the
+ * image (segments and appended SHA-256) before it is selected; ACTIVATE
+ * then restarts the chip from a timer, after its response has gone out.
+ *
+ * A delta patch reads the old image from the running partition, which
+ * fwdelta checks against the patch's old CRC32 before writing anything.
+ *
+ * A failed DATA ends the session: the decoder cannot continue after an
+ * error, so the host has to start over with BEGIN.
+ *
+ * Resumable sessions (stream_crc32 != 0) also take plain ESP images and
+ * DATA_CRC. A chunk that crosses a multiple of checkpoint_len is fed in
+ * two parts, so the checkpoint lands exactly on the boundary the host
+ * records; there the stream position, the decoder scalars and the held
+ * header go to NVS. RESUME restores them, rebinds the decoder's pointers,
+ * reloads the LZFW history from the image already in flash, and erases
+ * whatever was written past the checkpoint before the reset.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include "nvs.h"
+#include "wifi_raw_msgs.h"
+#include "lzfw.h"
+#include "fwdelta.h"
+#include "wifi_raw_ota.h"
+
+static const char *TAG = "wifi_raw_ota";
+
+#define ERASE_STEP          (64 * 1024)     /* Erased ahead of the writer at once */
+#define HEAD_LEN            LZFW_HEADER_LEN /* Stream bytes needed to pick a decoder */
+#define SECTOR_LEN          4096            /* Flash erase unit */
+#define PLAIN_MAGIC         0xE9            /* esp_image_header_t.magic */
+#define RESTART_DELAY_US    (500 * 1000)    /* ACTIVATE: lets the response reach the host */
+
+#define NVS_NAMESPACE       "wifi_raw_ota"
+#define NVS_CKPT_KEY        "ckpt"
+#define CKPT_VERSION        1
+
+typedef enum {
+    FMT_NONE = 0,           /* Header still incomplete */
+    FMT_LZFW,
+    FMT_DELTA,
+    FMT_PLAIN,              /* Resumable sessions only */
+} stream_fmt_t;
+
+typedef struct {
+    bool active;
+    const esp_partition_t *part;
+    uint32_t total_len;     /* Stream length from BEGIN */
+    uint32_t stream_crc32;  /* From BEGIN, 0 = not resumable */
+    uint32_t checkpoint_len; /* 0 unless resumable */
+    uint32_t offset;        /* Stream bytes taken */
+    uint32_t crc;           /* CRC32 of those bytes */
+    uint32_t out_len;       /* Image bytes written */
+    uint32_t erased;        /* Partition bytes erased this session */
+    stream_fmt_t fmt;
+    uint8_t head[HEAD_LEN];
+    size_t head_fill;
+    const esp_partition_t *running;     /* Delta: the old image */
+    uint8_t *window;        /* LZFW history */
+    lzfw_decoder_t lz;
+    fwdelta_decoder_t delta;
+} session_t;
+
+/* Session state at a checkpoint, as stored in NVS */
+typedef struct {
+    uint32_t version;
+    uint32_t total_len;
+    uint32_t stream_crc32;
+    uint32_t checkpoint_len;
+    uint32_t offset;
+    uint32_t crc;
+    uint32_t out_len;
+    uint32_t part_addr;     /* Target partition, must still be the next one */
+    uint32_t fmt;
+    uint32_t head_fill;
+    uint8_t head[HEAD_LEN];
+    union {
+        lzfw_decoder_t lz;
+        fwdelta_decoder_t delta;
+    } dec;                  /* Pointers inside are stale until rebound */
+} ckpt_t;
+
+static session_t s_sess;
+static ckpt_t s_ckpt;
+static wifi_raw_ota_send_fn s_send;
+static bool s_installed;        /* An END selected a new image since boot */
+static esp_timer_handle_t s_restart;
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void session_end(session_t *s)
+{
+    free(s->window);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Decoder output: erase ahead as needed, then write at the image offset */
+static bool part_write(void *ctx, const uint8_t *data, size_t len)
+{
+    session_t *s = ctx;
+    if (len > s->part->size - s->out_len) {
+        ESP_LOGE(TAG, "Image does not fit partition %s (%lu bytes)",
+                 s->part->label, (unsigned long)s->part->size);
+        return false;
+    }
+    while (s->erased < s->out_len + len) {
+        size_t n = s->part->size - s->erased;
+        if (n > ERASE_STEP) n = ERASE_STEP;
+        esp_err_t ret = esp_partition_erase_range(s->part, s->erased, n);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Erase at 0x%lx failed: %s", (unsigned long)s->erased, esp_err_to_name(ret));
+            return false;
+        }
+        s->erased += n;
+    }
+    esp_err_t ret = esp_partition_write(s->part, s->out_len, data, len);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write at 0x%lx failed: %s", (unsigned long)s->out_len, esp_err_to_name(ret));
+        return false;
+    }
+    s->out_len += len;
+    return true;
+}
+
+static bool old_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    session_t *s = ctx;
+    return esp_partition_read(s->running, offset, dst, len) == ESP_OK;
+}
+
+static esp_err_t lzfw_to_esp(lzfw_err_t err)
+{
+    switch (err) {
+    case LZFW_OK:           return ESP_OK;
+    case LZFW_ERR_LENGTH:   return ESP_ERR_INVALID_SIZE;
+    case LZFW_ERR_CRC:      return ESP_ERR_INVALID_CRC;
+    case LZFW_ERR_OUTPUT:   return ESP_FAIL;
+    default:                return ESP_ERR_INVALID_ARG;
+    }
+}
+
+static esp_err_t delta_to_esp(fwdelta_err_t err)
+{
+    switch (err) {
+    case FWDELTA_OK:            return ESP_OK;
+    case FWDELTA_ERR_OLD:       return ESP_ERR_INVALID_VERSION;
+    case FWDELTA_ERR_LENGTH:    return ESP_ERR_INVALID_SIZE;
+    case FWDELTA_ERR_CRC:       return ESP_ERR_INVALID_CRC;
+    case FWDELTA_ERR_IO:        return ESP_FAIL;
+    default:                    return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/* Pick the decoder from the held-back header; ESP_ERR_NOT_FINISHED = need more */
+static esp_err_t start_decoder(session_t *s)
+{
+    if (s->head_fill > 0 && s->head[0] == PLAIN_MAGIC && s->stream_crc32) {
+        s->fmt = FMT_PLAIN;
+        ESP_LOGI(TAG, "Plain image, %lu bytes", (unsigned long)s->total_len);
+        return ESP_OK;
+    }
+    if (s->head_fill < sizeof(uint32_t)) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    uint32_t magic = get_le32(s->head);
+
+    if (magic == LZFW_MAGIC) {
+        if (s->head_fill < LZFW_HEADER_LEN) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+        lzfw_header_t hdr;
+        if (lzfw_parse_header(s->head, &hdr) != LZFW_OK) {
+            ESP_LOGE(TAG, "Bad LZFW header");
+            return ESP_ERR_INVALID_VERSION;
+        }
+        size_t window_size = (size_t)1 << hdr.window_bits;
+        s->window = malloc(window_size);
+        if (!s->window) {
+            return ESP_ERR_NO_MEM;
+        }
+        lzfw_decoder_init(&s->lz, s->window, window_size, part_write, s);
+        s->fmt = FMT_LZFW;
+        ESP_LOGI(TAG, "LZFW image: %lu -> %lu bytes, %u-byte window",
+                 (unsigned long)hdr.comp_len, (unsigned long)hdr.raw_len, (unsigned)window_size);
+        return ESP_OK;
+    }
+
+    if (magic == FWDELTA_MAGIC) {
+        s->running = esp_ota_get_running_partition();
+        if (!s->running) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        fwdelta_decoder_init(&s->delta, old_read, s, part_write, s);
+        s->fmt = FMT_DELTA;
+        ESP_LOGI(TAG, "Delta patch against %s", s->running->label);
+        return ESP_OK;
+    }
+
+    ESP_LOGE(TAG, "Unknown stream format (magic 0x%08lx)", (unsigned long)magic);
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t decode(session_t *s, const uint8_t *data, size_t len)
+{
+    if (s->fmt == FMT_PLAIN) {
+        return part_write(s, data, len) ? ESP_OK : ESP_FAIL;
+    }
+    if (s->fmt == FMT_DELTA) {
+        fwdelta_err_t err = fwdelta_decoder_feed(&s->delta, data, len);
+        if (err != FWDELTA_OK) {
+            ESP_LOGE(TAG, "Delta apply failed at stream offset %lu: %s",
+                     (unsigned long)s->offset, fwdelta_err_name(err));
+        }
+        return delta_to_esp(err);
+    }
+
+    lzfw_err_t err = lzfw_decoder_feed(&s->lz, data, len);
+    if (err != LZFW_OK) {
+        ESP_LOGE(TAG, "LZFW decode failed at stream offset %lu: %s",
+                 (unsigned long)s->offset, lzfw_err_name(err));
+    }
+    return lzfw_to_esp(err);
+}
+
+/* Next stream bytes; the first ones are held until the format is known */
+static esp_err_t stream_feed(session_t *s, const uint8_t *data, size_t len)
+{
+    if (s->fmt == FMT_NONE) {
+        size_t n = sizeof(s->head) - s->head_fill;
+        if (n > len) n = len;
+        memcpy(s->head + s->head_fill, data, n);
+        s->head_fill += n;
+        data += n;
+        len -= n;
+
+        esp_err_t ret = start_decoder(s);
+        if (ret == ESP_ERR_NOT_FINISHED) {
+            return ESP_OK;
+        }
+        if (ret == ESP_OK) {
+            ret = decode(s, s->head, s->head_fill);
+        }
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return len ? decode(s, data, len) : ESP_OK;
+}
+
+static esp_err_t stream_finish(session_t *s)
+{
+    if (s->offset != s->total_len) {
+        ESP_LOGE(TAG, "Stream ended at %lu of %lu bytes",
+                 (unsigned long)s->offset, (unsigned long)s->total_len);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (s->stream_crc32 && s->crc != s->stream_crc32) {
+        ESP_LOGE(TAG, "Stream CRC32 0x%08lx, expected 0x%08lx",
+                 (unsigned long)s->crc, (unsigned long)s->stream_crc32);
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (s->fmt == FMT_NONE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (s->fmt == FMT_PLAIN) {
+        return ESP_OK;
+    }
+    if (s->fmt == FMT_DELTA) {
+        fwdelta_err_t err = fwdelta_decoder_finish(&s->delta);
+        if (err != FWDELTA_OK) {
+            ESP_LOGE(TAG, "Patched image check failed: %s", fwdelta_err_name(err));
+        }
+        return delta_to_esp(err);
+    }
+    lzfw_err_t err = lzfw_decoder_finish(&s->lz);
+    if (err != LZFW_OK) {
+        ESP_LOGE(TAG, "LZFW image check failed: %s", lzfw_err_name(err));
+    }
+    return lzfw_to_esp(err);
+}
+
+/* ─── Checkpoints ─── */
+
+static void ckpt_clear(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        if (nvs_erase_key(nvs, NVS_CKPT_KEY) == ESP_OK) {
+            nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+}
+
+/* Failure only costs the ability to resume here, so it is not fatal */
+static void ckpt_save(const session_t *s)
+{
+    ckpt_t *c = &s_ckpt;
+    memset(c, 0, sizeof(*c));
+    c->version = CKPT_VERSION;
+    c->total_len = s->total_len;
+    c->stream_crc32 = s->stream_crc32;
+    c->checkpoint_len = s->checkpoint_len;
+    c->offset = s->offset;
+    c->crc = s->crc;
+    c->out_len = s->out_len;
+    c->part_addr = s->part->address;
+    c->fmt = s->fmt;
+    c->head_fill = s->head_fill;
+    memcpy(c->head, s->head, sizeof(c->head));
+    if (s->fmt == FMT_LZFW) {
+        c->dec.lz = s->lz;
+    } else if (s->fmt == FMT_DELTA) {
+        c->dec.delta = s->delta;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(nvs, NVS_CKPT_KEY, c, sizeof(*c));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Checkpoint at %lu not saved: %s", (unsigned long)s->offset, esp_err_to_name(ret));
+    }
+}
+
+/* Erase what may have been written past out_len before a reset, keeping
+ * the start of the sector that holds out_len */
+static esp_err_t trim_output(session_t *s)
+{
+    uint32_t sector = s->out_len & ~(uint32_t)(SECTOR_LEN - 1);
+    uint32_t keep = s->out_len - sector;
+    if (sector >= s->part->size) {
+        s->erased = s->part->size;
+        return ESP_OK;
+    }
+
+    uint8_t *buf = keep ? malloc(keep) : NULL;
+    if (keep && !buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = keep ? esp_partition_read(s->part, sector, buf, keep) : ESP_OK;
+    if (ret == ESP_OK) {
+        ret = esp_partition_erase_range(s->part, sector, SECTOR_LEN);
+    }
+    if (ret == ESP_OK && keep) {
+        ret = esp_partition_write(s->part, sector, buf, keep);
+    }
+    free(buf);
+    s->erased = sector + SECTOR_LEN;
+    return ret;
+}
+
+/* Reload the LZFW history (the last window of output) from flash */
+static esp_err_t refill_window(session_t *s)
+{
+    uint32_t size = s->lz.mask + 1;
+    uint32_t pos = s->lz.pos;
+    for (uint32_t off = (pos > size) ? pos - size : 0; off < pos; ) {
+        uint32_t idx = off & s->lz.mask;
+        uint32_t n = size - idx;
+        if (n > pos - off) n = pos - off;
+        esp_err_t ret = esp_partition_read(s->part, off, s->window + idx, n);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        off += n;
+    }
+    return ESP_OK;
+}
+
+/* Rebuild the session from a checkpoint loaded into s_ckpt */
+static esp_err_t ckpt_restore(session_t *s, const esp_partition_t *part)
+{
+    const ckpt_t *c = &s_ckpt;
+    s->active = true;
+    s->part = part;
+    s->total_len = c->total_len;
+    s->stream_crc32 = c->stream_crc32;
+    s->checkpoint_len = c->checkpoint_len;
+    s->offset = c->offset;
+    s->crc = c->crc;
+    s->out_len = c->out_len;
+    s->fmt = (stream_fmt_t)c->fmt;
+    s->head_fill = c->head_fill;
+    memcpy(s->head, c->head, sizeof(s->head));
+
+    if (s->fmt == FMT_LZFW) {
+        s->lz = c->dec.lz;
+        s->window = malloc((size_t)s->lz.mask + 1);
+        if (!s->window) {
+            return ESP_ERR_NO_MEM;
+        }
+        s->lz.window = s->window;
+        s->lz.write = part_write;
+        s->lz.ctx = s;
+    } else if (s->fmt == FMT_DELTA) {
+        s->running = esp_ota_get_running_partition();
+        if (!s->running) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        s->delta = c->dec.delta;
+        s->delta.read_old = old_read;
+        s->delta.old_ctx = s;
+        s->delta.write = part_write;
+        s->delta.ctx = s;
+    }
+
+    esp_err_t ret = trim_output(s);
+    if (ret == ESP_OK && s->fmt == FMT_LZFW) {
+        ret = refill_window(s);
+    }
+    return ret;
+}
+
+/* Feed stream bytes, splitting at checkpoint boundaries to save state there */
+static esp_err_t take(session_t *s, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t n = len;
+        if (s->checkpoint_len) {
+            uint32_t next = (s->offset / s->checkpoint_len + 1) * s->checkpoint_len;
+            if (n > next - s->offset) n = next - s->offset;
+        }
+
+        esp_err_t ret = stream_feed(s, data, n);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        s->crc = lzfw_crc32(s->crc, data, n);
+        s->offset += n;
+        data += n;
+        len -= n;
+
+        if (s->checkpoint_len && s->offset % s->checkpoint_len == 0 && s->offset < s->total_len) {
+            ckpt_save(s);
+        }
+    }
+    return ESP_OK;
+}
+
+/* ─── Command Handlers ─── */
+
+static esp_err_t on_begin(const uint8_t *data, size_t len)
+{
+    wifi_raw_cmd_ota_z_begin_t cmd;
+    if (len < sizeof(cmd)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&cmd, data, sizeof(cmd));
+
+    /* A new BEGIN abandons whatever was in progress */
+    session_end(&s_sess);
+    ckpt_clear();
+    s_installed = false;
+    if (cmd.total_len == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+    if (!part) {
+        ESP_LOGE(TAG, "No OTA partition to update");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    s_sess.active = true;
+    s_sess.part = part;
+    s_sess.total_len = cmd.total_len;
+    s_sess.stream_crc32 = cmd.stream_crc32;
+    s_sess.checkpoint_len = cmd.stream_crc32 ? cmd.checkpoint_len : 0;
+    ESP_LOGI(TAG, "OTA_Z begin: %lu-byte stream into %s%s",
+             (unsigned long)cmd.total_len, part->label, cmd.stream_crc32 ? ", resumable" : "");
+    return ESP_OK;
+}
+
+static esp_err_t on_data(const uint8_t *data, size_t len)
+{
+    const wifi_raw_cmd_ota_z_data_t *cmd = (const wifi_raw_cmd_ota_z_data_t *)data;
+    if (!s_sess.active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (len < sizeof(*cmd) || len < sizeof(*cmd) + cmd->data_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (cmd->offset != s_sess.offset) {
+        ESP_LOGW(TAG, "DATA at %lu, expected %lu",
+                 (unsigned long)cmd->offset, (unsigned long)s_sess.offset);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cmd->data_len > s_sess.total_len - s_sess.offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t ret = take(&s_sess, cmd->data, cmd->data_len);
+    if (ret != ESP_OK) {
+        session_end(&s_sess);
+    }
+    return ret;
+}
+
+static esp_err_t on_data_crc(const uint8_t *data, size_t len, wifi_raw_ota_z_ack_t *ack)
+{
+    const wifi_raw_cmd_ota_z_data_crc_t *cmd = (const wifi_raw_cmd_ota_z_data_crc_t *)data;
+    ack->offset = s_sess.offset;
+    if (!s_sess.active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (len < sizeof(*cmd) || len < sizeof(*cmd) + cmd->data_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    ack->crc32 = lzfw_crc32(0, cmd->data, cmd->data_len);
+    if (ack->crc32 != cmd->crc32) {
+        ESP_LOGW(TAG, "DATA_CRC at %lu: CRC mismatch", (unsigned long)cmd->offset);
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (cmd->offset + cmd->data_len <= s_sess.offset) {
+        /* Taken already, the host lost our ACK: acknowledge it again */
+        ack->offset = cmd->offset + cmd->data_len;
+        return ESP_OK;
+    }
+    if (cmd->offset != s_sess.offset) {
+        ESP_LOGW(TAG, "DATA_CRC at %lu, expected %lu",
+                 (unsigned long)cmd->offset, (unsigned long)s_sess.offset);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cmd->data_len > s_sess.total_len - s_sess.offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t ret = take(&s_sess, cmd->data, cmd->data_len);
+    if (ret != ESP_OK) {
+        session_end(&s_sess);
+        return ret;
+    }
+    ack->offset = s_sess.offset;
+    return ESP_OK;
+}
+
+static esp_err_t on_resume(const uint8_t *data, size_t len, wifi_raw_ota_z_ack_t *ack)
+{
+    wifi_raw_cmd_ota_z_resume_t cmd;
+    if (len < sizeof(cmd)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&cmd, data, sizeof(cmd));
+    session_end(&s_sess);
+    s_installed = false;
+
+    /* The checkpoint must be for this stream, into the partition we would
+     * pick now, and not past where the host wants to continue */
+    nvs_handle_t nvs;
+    size_t size = sizeof(s_ckpt);
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret == ESP_OK) {
+        ret = nvs_get_blob(nvs, NVS_CKPT_KEY, &s_ckpt, &size);
+        nvs_close(nvs);
+    }
+    const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+    if (ret != ESP_OK || size != sizeof(s_ckpt) || s_ckpt.version != CKPT_VERSION ||
+        s_ckpt.total_len != cmd.total_len || s_ckpt.stream_crc32 != cmd.stream_crc32 ||
+        s_ckpt.offset > cmd.offset || !part || part->address != s_ckpt.part_addr) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ret = ckpt_restore(&s_sess, part);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Resume at %lu failed: %s", (unsigned long)s_ckpt.offset, esp_err_to_name(ret));
+        session_end(&s_sess);
+        return ret;
+    }
+    ack->offset = s_sess.offset;
+    ack->crc32 = s_sess.crc;
+    ESP_LOGI(TAG, "OTA_Z resumed at %lu of %lu bytes (%lu written)",
+             (unsigned long)s_sess.offset, (unsigned long)s_sess.total_len,
+             (unsigned long)s_sess.out_len);
+    return ESP_OK;
+}
+
+static esp_err_t on_end(void)
+{
+    if (!s_sess.active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = stream_finish(&s_sess);
+    if (ret == ESP_OK) {
+        /* Verifies the image before selecting it */
+        ret = esp_ota_set_boot_partition(s_sess.part);
+    }
+    if (ret == ESP_OK) {
+        s_installed = true;
+        ESP_LOGI(TAG, "OTA_Z done: %lu-byte image in %s selected for boot",
+                 (unsigned long)s_sess.out_len, s_sess.part->label);
+    } else {
+        ESP_LOGE(TAG, "OTA_Z failed: %s", esp_err_to_name(ret));
+    }
+    session_end(&s_sess);
+    ckpt_clear();
+    return ret;
+}
+
+static void restart_cb(void *arg)
+{
+    esp_restart();
+}
+
+static esp_err_t on_activate(void)
+{
+    if (!s_installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!s_restart) {
+        const esp_timer_create_args_t args = {
+            .callback = restart_cb,
+            .name = "ota_z_restart",
+        };
+        esp_err_t ret = esp_timer_create(&args, &s_restart);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    ESP_LOGI(TAG, "OTA_Z activate: restarting into the new image");
+    return esp_timer_start_once(s_restart, RESTART_DELAY_US);
+}
+
+static void respond(uint16_t cmd_msg_id, esp_err_t status)
+{
+    wifi_raw_cmd_response_t resp = {
+        .cmd_msg_id = cmd_msg_id,
+        .status = status,
+    };
+    esp_err_t ret = s_send(WIFI_RAW_MSG_CMD_RESPONSE, (const uint8_t *)&resp, sizeof(resp));
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Response to 0x%04x not sent: %s", cmd_msg_id, esp_err_to_name(ret));
+    }
+}
+
+static void send_ack(const wifi_raw_ota_z_ack_t *ack)
+{
+    esp_err_t ret = s_send(WIFI_RAW_MSG_OTA_Z_ACK, (const uint8_t *)ack, sizeof(*ack));
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "ACK for 0x%04x not sent: %s", ack->cmd_msg_id, esp_err_to_name(ret));
+    }
+}
+
+/* ─── Public API ─── */
+
+esp_err_t wifi_raw_ota_init(wifi_raw_ota_send_fn send)
+{
+    if (!send) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_send = send;
+    return ESP_OK;
+}
+
+bool wifi_raw_ota_handle(uint32_t msg_id, const uint8_t *data, size_t len)
+{
+    esp_err_t ret;
+
+    if (msg_id == WIFI_RAW_MSG_OTA_Z_RESUME || msg_id == WIFI_RAW_MSG_OTA_Z_DATA_CRC) {
+        wifi_raw_ota_z_ack_t ack = { .cmd_msg_id = (uint16_t)msg_id };
+        ret = (msg_id == WIFI_RAW_MSG_OTA_Z_RESUME) ? on_resume(data, len, &ack)
+                                                   : on_data_crc(data, len, &ack);
+        ack.status = ret;
+        if (s_send) {
+            send_ack(&ack);
+        }
+        return true;
+    }
+
+    switch (msg_id) {
+    case WIFI_RAW_MSG_OTA_Z_BEGIN:
+        ret = on_begin(data, len);
+        break;
+    case WIFI_RAW_MSG_OTA_Z_DATA:
+        ret = on_data(data, len);
+        break;
+    case WIFI_RAW_MSG_OTA_Z_END:
+        ret = on_end();
+        break;
+    case WIFI_RAW_MSG_OTA_Z_ACTIVATE:
+        ret = on_activate();
+        break;
+    default:
+        return false;
+    }
+
+    if (s_send) {
+        respond((uint16_t)msg_id, ret);
+    }
+    return true;
+}
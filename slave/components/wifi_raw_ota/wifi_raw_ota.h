@@ -0,0 +1,70 @@
+/*
+ * WiFi Raw OTA - slave side of the streamed OTA_Z_* messages
+ *
+ * Runs on the ESP32-C6 next to wifi_raw_slave.c. The host streams an
+ * LZFW image (lzfw.h) or a delta patch against the running image
+ * (fwdelta.h) in order; each DATA payload is fed to the streaming
+ * decoder, whose output goes straight into the next OTA partition.
+ * END checks length and CRC32 and selects the partition for boot;
+ * ACTIVATE restarts into it.
+ * Message layouts and the protocol are in wifi_raw_msgs.h.
+ *
+ * Sessions begun with a stream CRC32 are resumable: they also take plain
+ * ESP images and CRC-checked DATA_CRC chunks, and a checkpoint in NVS
+ * every checkpoint_len stream bytes lets OTA_Z_RESUME continue after a
+ * reset of either chip.
+ *
+ * The component does not talk to esp-hosted itself: the slave's
+ * CustomRpc dispatcher hands every message to wifi_raw_ota_handle(),
+ * and answers go out through the send function given to
+ * wifi_raw_ota_init(). Handlers run in the dispatcher's context and
+ * block for flash erase and write, which is fine because the host waits
+ * for each answer before sending the next message.
+ */
+
+#ifndef WIFI_RAW_OTA_H
+#define WIFI_RAW_OTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Send a message to the host
+ *
+ * @param msg_id WIFI_RAW_MSG_* response ID
+ * @param data Payload
+ * @param len Payload length
+ * @return ESP_OK on success
+ */
+typedef esp_err_t (*wifi_raw_ota_send_fn)(uint32_t msg_id, const uint8_t *data, size_t len);
+
+/**
+ * @brief Initialize the OTA_Z handlers
+ *
+ * @param send Used for every CMD_RESPONSE and OTA_Z_ACK
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if send is NULL
+ */
+esp_err_t wifi_raw_ota_init(wifi_raw_ota_send_fn send);
+
+/**
+ * @brief Handle a message if it belongs to the streamed OTA
+ *
+ * @param msg_id CustomRpc message ID
+ * @param data Payload
+ * @param len Payload length
+ * @return true if the message was an OTA_Z_* command (answered here),
+ *         false if the caller should handle it
+ */
+bool wifi_raw_ota_handle(uint32_t msg_id, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_RAW_OTA_H */
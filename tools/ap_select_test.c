@@ -0,0 +1,136 @@
+/*
+ * ap_select_test - host test of the AP ranking against fixed scan results
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Imain -o ap_select_test tools/ap_select_test.c main/ap_select.c
+ *   ./ap_select_test
+ *
+ * Exits non-zero on the first failed check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ap_select.h"
+
+#define CHECK(cond) do {                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n",                \
+                    __FILE__, __LINE__, __func__, #cond);                   \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+#define BSS(name, ch, dbm, sec) { .ssid = name, .channel = ch, .rssi = dbm, .security = sec }
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+/* A stronger AP under a busy channel loses to a weaker one on a clear channel */
+static void test_congestion(void)
+{
+    static const ap_select_scan_entry_t scan[] = {
+        BSS("home", 1, -50, AP_SEC_WPA2),           /* 0 */
+        BSS("home", 11, -55, AP_SEC_WPA2),          /* 1 */
+        BSS("n1", 1, -60, AP_SEC_WPA2),             /* Co-channel with 0: 3 x 4 */
+        BSS("n2", 1, -62, AP_SEC_WPA2),
+        BSS("n3", 1, -70, AP_SEC_OPEN),
+        BSS("n4", 3, -70, AP_SEC_WPA2),             /* Overlaps 0: 2 */
+        BSS("n5", 6, -90, AP_SEC_WPA2),             /* Below the floor: ignored */
+    };
+    static const ap_select_candidate_t cand[] = { { "home", AP_SEC_WPA2 } };
+    ap_select_ranked_t out[AP_SELECT_MAX_RANKED];
+
+    size_t n = ap_select_rank(scan, COUNT(scan), cand, COUNT(cand), out, COUNT(out));
+    CHECK(n == 2);
+    CHECK(out[0].scan_index == 1 && out[0].congestion == 0);
+    CHECK(out[0].score == -55 + 4);
+    CHECK(out[1].scan_index == 0 && out[1].congestion == 14);
+    CHECK(out[1].score == -50 - 14 + 4);
+}
+
+/* Penalty is capped so one crowded channel cannot bury an AP completely */
+static void test_congestion_cap(void)
+{
+    ap_select_scan_entry_t scan[12] = { BSS("home", 6, -40, AP_SEC_WPA2) };
+    for (size_t i = 1; i < COUNT(scan); i++) {
+        scan[i] = (ap_select_scan_entry_t)BSS("busy", 6, -60, AP_SEC_WPA2);
+    }
+    static const ap_select_candidate_t cand[] = { { "home", AP_SEC_WPA2 } };
+    ap_select_ranked_t out[AP_SELECT_MAX_RANKED];
+
+    CHECK(ap_select_rank(scan, COUNT(scan), cand, COUNT(cand), out, COUNT(out)) == 1);
+    CHECK(out[0].congestion == 24);
+}
+
+/* Equal signal: the stronger security wins; below the minimum is dropped */
+static void test_security(void)
+{
+    static const ap_select_scan_entry_t scan[] = {
+        BSS("net", 1, -60, AP_SEC_WPA2),
+        BSS("net", 11, -60, AP_SEC_WPA3),
+        BSS("net", 6, -40, AP_SEC_WEP),             /* Strongest, but too weak a cipher */
+    };
+    static const ap_select_candidate_t cand[] = { { "net", AP_SEC_WPA } };
+    ap_select_ranked_t out[AP_SELECT_MAX_RANKED];
+
+    size_t n = ap_select_rank(scan, COUNT(scan), cand, COUNT(cand), out, COUNT(out));
+    CHECK(n == 2);
+    CHECK(out[0].scan_index == 1);
+    CHECK(out[1].scan_index == 0);
+    CHECK(out[0].score - out[1].score == 2);
+}
+
+/* List order breaks near-ties but does not override a clear RSSI lead */
+static void test_list_order(void)
+{
+    static const ap_select_candidate_t cand[] = {
+        { "first", AP_SEC_WPA2 },
+        { "second", AP_SEC_WPA2 },
+    };
+    ap_select_ranked_t out[AP_SELECT_MAX_RANKED];
+
+    static const ap_select_scan_entry_t tie[] = {
+        BSS("second", 11, -58, AP_SEC_WPA2),        /* 2 dB stronger: still loses */
+        BSS("first", 1, -60, AP_SEC_WPA2),
+    };
+    CHECK(ap_select_rank(tie, COUNT(tie), cand, COUNT(cand), out, COUNT(out)) == 2);
+    CHECK(out[0].candidate == 0 && out[1].candidate == 1);
+
+    static const ap_select_scan_entry_t lead[] = {
+        BSS("second", 11, -56, AP_SEC_WPA2),        /* 4 dB stronger: wins */
+        BSS("first", 1, -60, AP_SEC_WPA2),
+    };
+    CHECK(ap_select_rank(lead, COUNT(lead), cand, COUNT(cand), out, COUNT(out)) == 2);
+    CHECK(out[0].candidate == 1 && out[1].candidate == 0);
+}
+
+/* Unknown SSIDs are not ranked; a full output keeps the best entries */
+static void test_filter_and_capacity(void)
+{
+    static const ap_select_scan_entry_t scan[] = {
+        BSS("other", 1, -30, AP_SEC_WPA3),
+        BSS("home", 1, -80, AP_SEC_WPA2),
+        BSS("home", 6, -50, AP_SEC_WPA2),
+        BSS("home", 11, -65, AP_SEC_WPA2),
+        BSS("", 6, -40, AP_SEC_WPA2),               /* Hidden SSID */
+    };
+    static const ap_select_candidate_t cand[] = { { "home", AP_SEC_WPA2 } };
+    ap_select_ranked_t out[2];
+
+    size_t n = ap_select_rank(scan, COUNT(scan), cand, COUNT(cand), out, COUNT(out));
+    CHECK(n == 2);
+    CHECK(out[0].scan_index == 2);
+    CHECK(out[1].scan_index == 3);
+    CHECK(ap_select_rank(scan, COUNT(scan), cand, COUNT(cand), out, 0) == 0);
+    CHECK(ap_select_rank(scan, 0, cand, COUNT(cand), out, COUNT(out)) == 0);
+}
+
+int main(void)
+{
+    test_congestion();
+    test_congestion_cap();
+    test_security();
+    test_list_order();
+    test_filter_and_capacity();
+    printf("ap_select_test: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * bin_log_decode - format BLOG records from a device log on the host
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Imain -o bin_log_decode tools/bin_log_decode.c main/bin_log_fmt.c
+ *   ./bin_log_decode build/esp32p4_wifi_test.elf < monitor.log
+ *
+ * Lines of the form "BLOG <ts_us> <core> <fmt> <args...>" (bin_log_start()
+ * with raw output) are replaced by the formatted record; everything else
+ * passes through unchanged. Format and %s addresses are looked up in the
+ * ELF's allocated sections, so the ELF must be the exact build that ran.
+ */
+
+#include <elf.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bin_log_fmt.h"
+
+#define MAX_ARGS 6
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    const Elf32_Shdr *shdr;
+    unsigned shnum;
+} elf_t;
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (n > 0) ? malloc((size_t)n) : NULL;
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = buf ? (size_t)n : 0;
+    return buf;
+}
+
+static int elf_open(elf_t *elf, const uint8_t *data, size_t len)
+{
+    const Elf32_Ehdr *eh = (const Elf32_Ehdr *)data;
+    if (len < sizeof(*eh) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS32 || eh->e_ident[EI_DATA] != ELFDATA2LSB) {
+        return -1;
+    }
+    if (eh->e_shoff == 0 || eh->e_shentsize != sizeof(Elf32_Shdr) ||
+        eh->e_shoff + (size_t)eh->e_shnum * sizeof(Elf32_Shdr) > len) {
+        return -1;
+    }
+    elf->data = data;
+    elf->len = len;
+    elf->shdr = (const Elf32_Shdr *)(data + eh->e_shoff);
+    elf->shnum = eh->e_shnum;
+    return 0;
+}
+
+/* NUL-terminated string at a target address, from the section holding it */
+static const char *elf_str(uint32_t addr, void *ctx)
+{
+    const elf_t *elf = ctx;
+    for (unsigned i = 0; i < elf->shnum; i++) {
+        const Elf32_Shdr *sh = &elf->shdr[i];
+        if (sh->sh_type != SHT_PROGBITS || !(sh->sh_flags & SHF_ALLOC) ||
+            addr < sh->sh_addr || addr - sh->sh_addr >= sh->sh_size ||
+            (size_t)sh->sh_offset + sh->sh_size > elf->len) {
+            continue;
+        }
+        const char *s = (const char *)elf->data + sh->sh_offset + (addr - sh->sh_addr);
+        size_t room = sh->sh_size - (addr - sh->sh_addr);
+        return memchr(s, '\0', room) ? s : NULL;
+    }
+    return NULL;
+}
+
+static void decode(const elf_t *elf, const char *rec)
+{
+    int64_t ts_us;
+    int core, used;
+    uint32_t fmt_addr;
+    if (sscanf(rec, "BLOG %" SCNd64 " %d %" SCNx32 "%n", &ts_us, &core, &fmt_addr, &used) != 3) {
+        fputs(rec, stdout);
+        return;
+    }
+
+    uint32_t args[MAX_ARGS];
+    unsigned nargs = 0;
+    const char *p = rec + used;
+    int n;
+    while (nargs < MAX_ARGS && sscanf(p, " %" SCNx32 "%n", &args[nargs], &n) == 1) {
+        nargs++;
+        p += n;
+    }
+
+    const char *fmt = elf_str(fmt_addr, (void *)elf);
+    char line[1024];
+    if (!fmt) {
+        snprintf(line, sizeof(line), "<unknown format 0x%08" PRIx32 ", wrong ELF?>", fmt_addr);
+    } else {
+        bin_log_format(line, sizeof(line), fmt, args, nargs, elf_str, (void *)elf);
+    }
+    printf("I (%" PRId64 ") bin_log: %s\n", ts_us / 1000, line);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s firmware.elf < log\n", argv[0]);
+        return 2;
+    }
+
+    size_t len;
+    uint8_t *data = read_file(argv[1], &len);
+    elf_t elf;
+    if (!data || elf_open(&elf, data, len) != 0) {
+        fprintf(stderr, "%s: not a readable 32-bit little-endian ELF\n", argv[1]);
+        free(data);
+        return 1;
+    }
+
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), stdin)) {
+        const char *rec = strstr(buf, "BLOG ");
+        if (rec) {
+            decode(&elf, rec);
+        } else {
+            fputs(buf, stdout);
+        }
+    }
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * fwdelta_make - build a delta patch between two slave firmware images
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Icomponents/slave_ota -o fwdelta_make tools/fwdelta_make.c components/slave_ota/fwdelta.c components/slave_ota/lzfw.c components/slave_ota/slave_image.c
+ *   ./fwdelta_make running.bin new.bin update.fwd
+ *
+ * running.bin must be the exact image on the C6 (the slave refuses the
+ * patch otherwise). Both images' appended SHA-256 digests go into the
+ * header, and the patch is applied again before it is written.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fwdelta.h"
+#include "slave_image.h"
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} mem_src_t;
+
+typedef struct {
+    const uint8_t *expect;
+    size_t off;
+    bool mismatch;
+} verify_t;
+
+static bool mem_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    const mem_src_t *m = ctx;
+    if (offset > m->len || len > m->len - offset) return false;
+    memcpy(dst, m->data + offset, len);
+    return true;
+}
+
+static bool verify_write(void *ctx, const uint8_t *data, size_t len)
+{
+    verify_t *v = ctx;
+    if (memcmp(v->expect + v->off, data, len) != 0) v->mismatch = true;
+    v->off += len;
+    return !v->mismatch;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Load a file and trim it to the ESP image inside; digest = appended SHA-256 or NULL */
+static uint8_t *load_image(const char *path, mem_src_t *img, const uint8_t **digest)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); return NULL; }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc(n > 0 ? n : 1);
+    if (!buf || fread(buf, 1, n, f) != (size_t)n) {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(f);
+        free(buf);
+        return NULL;
+    }
+    fclose(f);
+
+    img->data = buf;
+    img->len = (size_t)n;
+    slave_image_info_t info;
+    slave_image_err_t err = slave_image_parse(mem_read, img, img->len, &info);
+    if (err != SLAVE_IMAGE_OK) {
+        fprintf(stderr, "%s: not an ESP image (%s)\n", path, slave_image_err_name(err));
+        free(buf);
+        return NULL;
+    }
+    img->len = info.image_len;
+    *digest = info.hash_offset ? buf + info.hash_offset : NULL;
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s running.bin new.bin out.fwd\n", argv[0]);
+        return 2;
+    }
+
+    mem_src_t old_img, new_img;
+    const uint8_t *old_sha, *new_sha;
+    uint8_t *old_buf = load_image(argv[1], &old_img, &old_sha);
+    uint8_t *new_buf = load_image(argv[2], &new_img, &new_sha);
+    if (!old_buf || !new_buf) return 1;
+
+    double t0 = now_s();
+    size_t plen = 0;
+    uint8_t *patch = fwdelta_encode(old_img.data, old_img.len, new_img.data, new_img.len,
+                                    old_sha, new_sha, &plen);
+    double t1 = now_s();
+    if (!patch) { fprintf(stderr, "encoding failed\n"); return 1; }
+
+    verify_t v = { new_img.data, 0, false };
+    fwdelta_decoder_t dec;
+    fwdelta_decoder_init(&dec, mem_read, &old_img, verify_write, &v);
+    double t2 = now_s();
+    fwdelta_err_t err = FWDELTA_OK;
+    for (size_t off = 0; off < plen && err == FWDELTA_OK; off += 1400) {
+        err = fwdelta_decoder_feed(&dec, patch + off, (plen - off < 1400) ? plen - off : 1400);
+    }
+    if (err == FWDELTA_OK) err = fwdelta_decoder_finish(&dec);
+    double t3 = now_s();
+    if (err != FWDELTA_OK) { fprintf(stderr, "verify failed: %s\n", fwdelta_err_name(err)); return 1; }
+
+    FILE *f = fopen(argv[3], "wb");
+    if (!f || fwrite(patch, 1, plen, f) != plen || fclose(f) != 0) { perror(argv[3]); return 1; }
+
+    printf("%zu -> %zu bytes: patch %zu bytes (%.2f%% of new image), encode %.2f s, apply %.1f MB/s\n",
+           old_img.len, new_img.len, plen, 100.0 * plen / new_img.len, t1 - t0,
+           new_img.len / 1e6 / (t3 - t2));
+    return 0;
+}
@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for the ESP-IDF header, for the tools/ host tests: only
+ * what the wifi_raw headers use. The test provides the functions.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
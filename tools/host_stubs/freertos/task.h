@@ -0,0 +1,21 @@
+/*
+ * Host stand-in for the ESP-IDF header, for the tools/ host tests: only
+ * what the wifi_raw headers use. The test provides the functions.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
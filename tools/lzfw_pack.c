@@ -0,0 +1,119 @@
+/*
+ * lzfw_pack - compress a slave firmware image for the LZFW OTA path
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Icomponents/slave_ota -o lzfw_pack tools/lzfw_pack.c components/slave_ota/lzfw.c components/slave_ota/slave_image.c
+ *   ./lzfw_pack [-w window_bits] network_adapter.bin network_adapter.lzfw
+ *
+ * The image is parsed first so its appended SHA-256 can be stored in the
+ * header (used by the host's skip-if-identical check), and the result is
+ * decompressed again before it is written.
+ *
+ * The same output is what c6-ota-flasher embeds as
+ * main/network_adapter.lzfw.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lzfw.h"
+#include "slave_image.h"
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} mem_src_t;
+
+typedef struct {
+    const uint8_t *expect;
+    size_t off;
+    bool mismatch;
+} verify_t;
+
+static bool mem_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    const mem_src_t *m = ctx;
+    if (offset > m->len || len > m->len - offset) return false;
+    memcpy(dst, m->data + offset, len);
+    return true;
+}
+
+static bool verify_write(void *ctx, const uint8_t *data, size_t len)
+{
+    verify_t *v = ctx;
+    if (memcmp(v->expect + v->off, data, len) != 0) v->mismatch = true;
+    v->off += len;
+    return !v->mismatch;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    int wbits = LZFW_DEFAULT_WINDOW_BITS;
+    int argi = 1;
+    if (argc > 2 && strcmp(argv[1], "-w") == 0) {
+        wbits = atoi(argv[2]);
+        argi = 3;
+    }
+    if (argc - argi != 2) {
+        fprintf(stderr, "usage: %s [-w window_bits] in.bin out.lzfw\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(argv[argi], "rb");
+    if (!f) { perror(argv[argi]); return 1; }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *raw = malloc(n > 0 ? n : 1);
+    if (!raw || fread(raw, 1, n, f) != (size_t)n) { fprintf(stderr, "read failed\n"); return 1; }
+    fclose(f);
+
+    mem_src_t src = { raw, (size_t)n };
+    slave_image_info_t info;
+    slave_image_err_t ierr = slave_image_parse(mem_read, &src, src.len, &info);
+    if (ierr != SLAVE_IMAGE_OK) {
+        fprintf(stderr, "%s: not an ESP image (%s)\n", argv[argi], slave_image_err_name(ierr));
+        return 1;
+    }
+    if (info.image_len != src.len) {
+        fprintf(stderr, "note: image is %zu bytes, file %zu; packing the image only\n",
+                info.image_len, src.len);
+        src.len = info.image_len;
+    }
+    const uint8_t *digest = info.hash_offset ? raw + info.hash_offset : NULL;
+
+    uint8_t *comp = malloc(lzfw_compress_bound(src.len));
+    double t0 = now_s();
+    size_t clen = comp ? lzfw_compress(raw, src.len, (uint8_t)wbits, digest, comp) : 0;
+    double t1 = now_s();
+    if (clen == 0) { fprintf(stderr, "compression failed (window_bits %d)\n", wbits); return 1; }
+
+    uint8_t *window = malloc((size_t)1 << wbits);
+    verify_t v = { raw, 0, false };
+    lzfw_decoder_t dec;
+    lzfw_decoder_init(&dec, window, (size_t)1 << wbits, verify_write, &v);
+    double t2 = now_s();
+    lzfw_err_t err = LZFW_OK;
+    for (size_t off = 0; off < clen && err == LZFW_OK; off += 1400) {
+        err = lzfw_decoder_feed(&dec, comp + off, (clen - off < 1400) ? clen - off : 1400);
+    }
+    if (err == LZFW_OK) err = lzfw_decoder_finish(&dec);
+    double t3 = now_s();
+    if (err != LZFW_OK) { fprintf(stderr, "verify failed: %s\n", lzfw_err_name(err)); return 1; }
+
+    f = fopen(argv[argi + 1], "wb");
+    if (!f || fwrite(comp, 1, clen, f) != clen || fclose(f) != 0) { perror(argv[argi + 1]); return 1; }
+
+    printf("%zu -> %zu bytes (%.1f%%), window %d KB, compress %.2f s, decompress %.1f MB/s\n",
+           src.len, clen, 100.0 * clen / src.len, (1 << wbits) / 1024, t1 - t0,
+           src.len / 1e6 / (t3 - t2));
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * lzfw_test - host round-trip test of the LZFW codec on the real slave image
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Icomponents/slave_ota -o lzfw_test tools/lzfw_test.c components/slave_ota/lzfw.c
+ *   ./lzfw_test [c6-ota-flasher/main/network_adapter.lzfw]
+ *
+ * The flasher's embedded stream is decoded to get network_adapter.bin,
+ * which is then compressed at several window sizes and decoded again
+ * with the input split the ways the transport splits it (single bytes,
+ * odd sizes, random sizes). Prints ratio and throughput per window;
+ * exits non-zero on the first failed check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lzfw.h"
+
+#define CHECK(cond) do {                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n",                \
+                    __FILE__, __LINE__, __func__, #cond);                   \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+#define DEFAULT_IMAGE   "c6-ota-flasher/main/network_adapter.lzfw"
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    const uint8_t *expect;
+    size_t len;
+    size_t off;
+    bool mismatch;
+} verify_t;
+
+static bool verify_write(void *ctx, const uint8_t *data, size_t len)
+{
+    verify_t *v = ctx;
+    if (len > v->len - v->off || memcmp(v->expect + v->off, data, len) != 0) {
+        v->mismatch = true;
+        return false;
+    }
+    v->off += len;
+    return true;
+}
+
+static bool copy_write(void *ctx, const uint8_t *data, size_t len)
+{
+    verify_t *v = ctx;
+    if (len > v->len - v->off) return false;
+    memcpy((uint8_t *)v->expect + v->off, data, len);
+    v->off += len;
+    return true;
+}
+
+static bool fail_write(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx; (void)data; (void)len;
+    return false;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (n > 0) ? malloc((size_t)n) : NULL;
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = buf ? (size_t)n : 0;
+    return buf;
+}
+
+/* Next feed size: 0 = random 1..4096, otherwise a fixed size */
+static size_t chunk_len(size_t split, size_t left)
+{
+    size_t n = split ? split : 1 + (size_t)(rand() % 4096);
+    return (n < left) ? n : left;
+}
+
+/* Decode comp feeding split-sized pieces; returns the first error */
+static lzfw_err_t decode(const uint8_t *comp, size_t clen, size_t window_size, size_t split,
+                         const uint8_t *expect, size_t raw_len, verify_t *v)
+{
+    uint8_t *window = malloc(window_size);
+    CHECK(window != NULL);
+    *v = (verify_t){ expect, raw_len, 0, false };
+
+    lzfw_decoder_t dec;
+    lzfw_decoder_init(&dec, window, window_size, verify_write, v);
+    lzfw_err_t err = LZFW_OK;
+    for (size_t off = 0; off < clen && err == LZFW_OK; ) {
+        size_t n = chunk_len(split, clen - off);
+        err = lzfw_decoder_feed(&dec, comp + off, n);
+        off += n;
+    }
+    if (err == LZFW_OK) {
+        err = lzfw_decoder_finish(&dec);
+    }
+    free(window);
+    return err;
+}
+
+/* Compress at each window size; every split decodes to the original */
+static void test_round_trip(const uint8_t *raw, size_t raw_len, const uint8_t sha[32])
+{
+    static const uint8_t wbits[] = { 8, 10, 13, 15 };
+    static const size_t splits[] = { 1, 3, 127, 1400, 4093, 0 };
+
+    for (size_t w = 0; w < COUNT(wbits); w++) {
+        uint8_t *comp = malloc(lzfw_compress_bound(raw_len));
+        CHECK(comp != NULL);
+        double t0 = now_s();
+        size_t clen = lzfw_compress(raw, raw_len, wbits[w], sha, comp);
+        double t1 = now_s();
+        CHECK(clen > LZFW_HEADER_LEN && clen <= lzfw_compress_bound(raw_len));
+
+        lzfw_header_t hdr;
+        CHECK(lzfw_parse_header(comp, &hdr) == LZFW_OK);
+        CHECK(hdr.window_bits == wbits[w]);
+        CHECK(hdr.raw_len == raw_len);
+        CHECK(hdr.comp_len == clen - LZFW_HEADER_LEN);
+        CHECK(hdr.raw_crc32 == lzfw_crc32(0, raw, raw_len));
+        CHECK(memcmp(hdr.image_sha256, sha, 32) == 0);
+
+        double mbps = 0;
+        for (size_t s = 0; s < COUNT(splits); s++) {
+            verify_t v;
+            double t2 = now_s();
+            CHECK(decode(comp, clen, (size_t)1 << wbits[w], splits[s], raw, raw_len, &v) == LZFW_OK);
+            double t3 = now_s();
+            CHECK(v.off == raw_len && !v.mismatch);
+            if (splits[s] == 1400) {
+                mbps = raw_len / 1e6 / (t3 - t2);
+            }
+        }
+
+        /* A larger window than the stream needs is fine, a smaller one is not */
+        verify_t v;
+        CHECK(decode(comp, clen, (size_t)2 << wbits[w], 1400, raw, raw_len, &v) == LZFW_OK);
+        if (wbits[w] > LZFW_MIN_WINDOW_BITS) {
+            CHECK(decode(comp, clen, (size_t)1 << (wbits[w] - 1), 1400, raw, raw_len, &v) ==
+                  LZFW_ERR_WINDOW);
+        }
+
+        printf("window %5u B: %zu -> %zu bytes (%.1f%%), compress %.2f s, decompress %.1f MB/s\n",
+               1u << wbits[w], raw_len, clen, 100.0 * clen / raw_len, t1 - t0, mbps);
+        free(comp);
+    }
+}
+
+/* Damaged streams fail with the matching error instead of bad output */
+static void test_errors(const uint8_t *raw, size_t raw_len)
+{
+    uint8_t *comp = malloc(lzfw_compress_bound(raw_len));
+    CHECK(comp != NULL);
+    size_t clen = lzfw_compress(raw, raw_len, LZFW_DEFAULT_WINDOW_BITS, NULL, comp);
+    CHECK(clen > LZFW_HEADER_LEN);
+    size_t wsize = (size_t)1 << LZFW_DEFAULT_WINDOW_BITS;
+    verify_t v;
+
+    /* Bad magic, bad window bits */
+    comp[0] ^= 0xFF;
+    CHECK(decode(comp, clen, wsize, 1400, raw, raw_len, &v) == LZFW_ERR_HEADER);
+    comp[0] ^= 0xFF;
+    CHECK(lzfw_compress(raw, raw_len, LZFW_MAX_WINDOW_BITS + 1, NULL, comp + clen) == 0);
+
+    /* Stream cut short: finish reports the missing output */
+    CHECK(decode(comp, clen - 1, wsize, 1400, raw, raw_len, &v) == LZFW_ERR_LENGTH);
+
+    /* Header CRC does not match the data (raw_crc32 is at offset 16) */
+    comp[16] ^= 0x01;
+    CHECK(decode(comp, clen, wsize, 1400, raw, raw_len, &v) == LZFW_ERR_CRC);
+    comp[16] ^= 0x01;
+
+    /* Write callback failure is passed through */
+    uint8_t *window = malloc(wsize);
+    CHECK(window != NULL);
+    lzfw_decoder_t dec;
+    lzfw_decoder_init(&dec, window, wsize, fail_write, NULL);
+    CHECK(lzfw_decoder_feed(&dec, comp, clen) == LZFW_ERR_OUTPUT);
+    free(window);
+
+    /* Extra stream data past comp_len */
+    uint8_t *longer = malloc(clen + 16);
+    CHECK(longer != NULL);
+    memcpy(longer, comp, clen);
+    memset(longer + clen, 0, 16);
+    CHECK(decode(longer, clen + 16, wsize, 1400, raw, raw_len, &v) == LZFW_ERR_LENGTH);
+    free(longer);
+
+    free(comp);
+}
+
+/* Empty and tiny inputs survive the round trip */
+static void test_small(void)
+{
+    static const uint8_t inputs[][8] = { "", "a", "aaaaaaa", "abcabca" };
+    static const size_t lens[] = { 0, 1, 7, 7 };
+
+    for (size_t i = 0; i < COUNT(lens); i++) {
+        uint8_t comp[128];
+        CHECK(lzfw_compress_bound(lens[i]) <= sizeof(comp));
+        size_t clen = lzfw_compress(inputs[i], lens[i], LZFW_MIN_WINDOW_BITS, NULL, comp);
+        CHECK(clen >= LZFW_HEADER_LEN);
+        verify_t v;
+        CHECK(decode(comp, clen, (size_t)1 << LZFW_MIN_WINDOW_BITS, 1, inputs[i], lens[i], &v) ==
+              LZFW_OK);
+        CHECK(v.off == lens[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : DEFAULT_IMAGE;
+    size_t clen;
+    uint8_t *comp = read_file(path, &clen);
+    CHECK(comp != NULL && clen >= LZFW_HEADER_LEN);
+
+    lzfw_header_t hdr;
+    CHECK(lzfw_parse_header(comp, &hdr) == LZFW_OK);
+    uint8_t *raw = malloc(hdr.raw_len);
+    CHECK(raw != NULL);
+
+    /* Recover network_adapter.bin from the embedded stream */
+    uint8_t *window = malloc((size_t)1 << hdr.window_bits);
+    CHECK(window != NULL);
+    verify_t sink = { raw, hdr.raw_len, 0, false };
+    lzfw_decoder_t dec;
+    lzfw_decoder_init(&dec, window, (size_t)1 << hdr.window_bits, copy_write, &sink);
+    CHECK(lzfw_decoder_feed(&dec, comp, clen) == LZFW_OK);
+    CHECK(lzfw_decoder_finish(&dec) == LZFW_OK);
+    CHECK(sink.off == hdr.raw_len);
+    free(window);
+
+    srand(1);
+    test_round_trip(raw, hdr.raw_len, hdr.image_sha256);
+    test_errors(raw, hdr.raw_len);
+    test_small();
+
+    free(raw);
+    free(comp);
+    printf("lzfw_test: all checks passed\n");
+    return 0;
+}
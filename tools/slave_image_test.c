@@ -0,0 +1,187 @@
+/*
+ * slave_image_test - host test of the image parser against the real slave image
+ *
+ * Build and run on the development machine:
+ *   cc -O2 -Icomponents/slave_ota -o slave_image_test tools/slave_image_test.c components/slave_ota/slave_image.c components/slave_ota/lzfw.c
+ *   ./slave_image_test [c6-ota-flasher/main/network_adapter.lzfw]
+ *
+ * The flasher's embedded image is decompressed first; its LZFW header
+ * carries the raw length and the appended SHA-256, which the parse result
+ * is checked against. Exits non-zero on the first failed check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lzfw.h"
+#include "slave_image.h"
+
+#define CHECK(cond) do {                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n",                \
+                    __FILE__, __LINE__, __func__, #cond);                   \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+#define DEFAULT_IMAGE       "c6-ota-flasher/main/network_adapter.lzfw"
+#define EXPECT_LEN          1182176     /* network_adapter.bin as embedded */
+#define EXPECT_SEGMENTS     5
+#define ESP_CHIP_ID_ESP32C6 0x000D
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    unsigned reads_past;        /* Reads reaching beyond len */
+} mem_src_t;
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+} mem_sink_t;
+
+static bool mem_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    mem_src_t *m = ctx;
+    if (offset > m->len || len > m->len - offset) {
+        m->reads_past++;
+        return false;
+    }
+    memcpy(dst, m->data + offset, len);
+    return true;
+}
+
+static bool mem_write(void *ctx, const uint8_t *data, size_t len)
+{
+    mem_sink_t *s = ctx;
+    if (len > s->cap - s->len) return false;
+    memcpy(s->buf + s->len, data, len);
+    s->len += len;
+    return true;
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = (n > 0) ? malloc((size_t)n) : NULL;
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = buf ? (size_t)n : 0;
+    return buf;
+}
+
+/* Decompress the embedded image; hdr receives its LZFW header */
+static uint8_t *unpack(const char *path, lzfw_header_t *hdr, size_t *len)
+{
+    size_t clen;
+    uint8_t *comp = read_file(path, &clen);
+    CHECK(comp != NULL);
+    CHECK(clen >= LZFW_HEADER_LEN);
+    CHECK(lzfw_parse_header(comp, hdr) == LZFW_OK);
+
+    mem_sink_t sink = { malloc(hdr->raw_len), 0, hdr->raw_len };
+    uint8_t *window = malloc((size_t)1 << hdr->window_bits);
+    CHECK(sink.buf != NULL && window != NULL);
+
+    lzfw_decoder_t dec;
+    lzfw_decoder_init(&dec, window, (size_t)1 << hdr->window_bits, mem_write, &sink);
+    CHECK(lzfw_decoder_feed(&dec, comp, clen) == LZFW_OK);
+    CHECK(lzfw_decoder_finish(&dec) == LZFW_OK);
+    CHECK(sink.len == hdr->raw_len);
+
+    free(window);
+    free(comp);
+    *len = sink.len;
+    return sink.buf;
+}
+
+/* The real image: exact length, digest at the end, C6 chip, segment count */
+static void test_real_image(const uint8_t *img, size_t len, const lzfw_header_t *hdr)
+{
+    mem_src_t src = { img, len, 0 };
+    slave_image_info_t info;
+
+    CHECK(slave_image_parse(mem_read, &src, len, &info) == SLAVE_IMAGE_OK);
+    CHECK(src.reads_past == 0);
+    CHECK(info.image_len == EXPECT_LEN);
+    CHECK(info.image_len == hdr->raw_len);
+    CHECK(info.segment_count == EXPECT_SEGMENTS);
+    CHECK(info.chip_id == ESP_CHIP_ID_ESP32C6);
+    CHECK(info.hash_offset == info.image_len - 32);
+    CHECK(info.sig_offset == 0);
+    CHECK(hdr->flags & LZFW_FLAG_HAS_DIGEST);
+    CHECK(memcmp(img + info.hash_offset, hdr->image_sha256, 32) == 0);
+}
+
+/* Erased flash after the image does not change the result */
+static void test_trailing_erased(const uint8_t *img, size_t len)
+{
+    size_t big = len + 64 * 1024;
+    uint8_t *part = malloc(big);
+    CHECK(part != NULL);
+    memcpy(part, img, len);
+    memset(part + len, 0xFF, big - len);
+
+    mem_src_t src = { part, big, 0 };
+    slave_image_info_t info;
+    CHECK(slave_image_parse(mem_read, &src, big, &info) == SLAVE_IMAGE_OK);
+    CHECK(info.image_len == len);
+    free(part);
+}
+
+/* A container one byte short is reported, and nothing past it is read */
+static void test_truncated(const uint8_t *img, size_t len)
+{
+    mem_src_t src = { img, len - 1, 0 };
+    slave_image_info_t info;
+    CHECK(slave_image_parse(mem_read, &src, len - 1, &info) == SLAVE_IMAGE_ERR_TRUNCATED);
+    CHECK(src.reads_past == 0);
+
+    src.len = 16;
+    CHECK(slave_image_parse(mem_read, &src, 16, &info) == SLAVE_IMAGE_ERR_TRUNCATED);
+}
+
+/* Erased or foreign data and bad segment counts are rejected */
+static void test_bad_header(const uint8_t *img)
+{
+    uint8_t hdr[64];
+    memcpy(hdr, img, sizeof(hdr));
+    mem_src_t src = { hdr, sizeof(hdr), 0 };
+    slave_image_info_t info;
+
+    hdr[0] = 0xFF;
+    CHECK(slave_image_parse(mem_read, &src, sizeof(hdr), &info) == SLAVE_IMAGE_ERR_MAGIC);
+    hdr[0] = SLAVE_IMAGE_MAGIC;
+
+    hdr[1] = 0;
+    CHECK(slave_image_parse(mem_read, &src, sizeof(hdr), &info) == SLAVE_IMAGE_ERR_SEGMENTS);
+    hdr[1] = SLAVE_IMAGE_MAX_SEGMENTS + 1;
+    CHECK(slave_image_parse(mem_read, &src, sizeof(hdr), &info) == SLAVE_IMAGE_ERR_SEGMENTS);
+
+    src.len = 0;
+    CHECK(slave_image_parse(mem_read, &src, sizeof(hdr), &info) == SLAVE_IMAGE_ERR_READ);
+}
+
+int main(int argc, char **argv)
+{
+    lzfw_header_t hdr;
+    size_t len;
+    uint8_t *img = unpack(argc > 1 ? argv[1] : DEFAULT_IMAGE, &hdr, &len);
+
+    test_real_image(img, len, &hdr);
+    test_trailing_erased(img, len);
+    test_truncated(img, len);
+    test_bad_header(img);
+
+    free(img);
+    printf("slave_image_test: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,414 @@
+/*
+ * wifi_raw_cpp_test - host test of the C++ layer (wifi_raw.hpp, wifi_raw_co.hpp)
+ *
+ * Build and run on the development machine:
+ *   c++ -std=c++20 -O2 -Itools/host_stubs -Icomponents/wifi_raw -o wifi_raw_cpp_test tools/wifi_raw_cpp_test.cpp
+ *   ./wifi_raw_cpp_test
+ *
+ * tools/host_stubs holds the few FreeRTOS and esp_timer declarations the
+ * headers need; this file fakes them together with the wifi_raw C calls.
+ * The fake queue runs the RX task in xQueueReceive(): when nothing is
+ * queued it completes the oldest pending async command, and when nothing
+ * is pending either it advances the clock by the wait, as a blocked
+ * receive would. Exits non-zero on the first failed check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wifi_raw.hpp"
+#include "wifi_raw_co.hpp"
+
+#define CHECK(cond) do {                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n",                \
+                    __FILE__, __LINE__, __func__, #cond);                   \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+/* ─── Fake FreeRTOS and esp_timer ─── */
+
+static char s_task_ids[2];
+static TaskHandle_t const s_exec_task = reinterpret_cast<TaskHandle_t>(&s_task_ids[0]);
+static TaskHandle_t const s_rx_task = reinterpret_cast<TaskHandle_t>(&s_task_ids[1]);
+static TaskHandle_t s_current = s_exec_task;
+static int64_t s_now_us;
+static int s_delays;
+
+struct QueueDefinition {
+    void *items[64];
+    unsigned len, head, count;
+};
+
+struct pending_t {
+    wifi_raw_done_cb_t cb;
+    void *ctx;
+    esp_err_t result;
+};
+
+static pending_t s_pending[8];
+static unsigned s_pending_count;
+
+static void complete_oldest(void)
+{
+    pending_t p = s_pending[0];
+    memmove(s_pending, s_pending + 1, --s_pending_count * sizeof(s_pending[0]));
+    s_current = s_rx_task;
+    p.cb(p.result, p.ctx);
+    s_current = s_exec_task;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    CHECK(item_size == sizeof(void *) && length <= 64);
+    QueueHandle_t q = new QueueDefinition{};
+    q->len = length;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait)
+{
+    CHECK(s_current != s_exec_task || wait == 0);  /* The executor never blocks on itself */
+    if (q->count == q->len) {
+        return pdFALSE;
+    }
+    memcpy(&q->items[(q->head + q->count++) % q->len], item, sizeof(void *));
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait)
+{
+    if (q->count == 0 && s_pending_count) {
+        complete_oldest();
+    }
+    if (q->count == 0) {
+        CHECK(wait != portMAX_DELAY);   /* Nothing could ever wake it */
+        s_now_us += (int64_t)wait * portTICK_PERIOD_MS * 1000;
+        return pdFALSE;
+    }
+    memcpy(item, &q->items[q->head], sizeof(void *));
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    return pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+    s_delays++;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+/* ─── Fake wifi_raw C API ─── */
+
+static wifi_raw_rx_cb_t s_rx_cb;
+static wifi_raw_echo_cb_t s_echo_cb;
+static int s_rx_clears;     /* wifi_raw_register_rx_cb(NULL) calls */
+
+void wifi_raw_register_rx_cb(wifi_raw_rx_cb_t cb)
+{
+    s_rx_cb = cb;
+    s_rx_clears += cb == NULL;
+}
+
+void wifi_raw_register_echo_cb(wifi_raw_echo_cb_t cb)
+{
+    s_echo_cb = cb;
+}
+
+/* Channel 0 fails to send; channel 14 is sent but times out */
+esp_err_t wifi_raw_set_channel_async(uint8_t primary, uint8_t second,
+                                     wifi_raw_done_cb_t cb, void *ctx)
+{
+    (void)second;
+    if (primary == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    CHECK(s_pending_count < 8);
+    s_pending[s_pending_count++] = { cb, ctx, primary == 14 ? ESP_ERR_TIMEOUT : ESP_OK };
+    return ESP_OK;
+}
+
+/* ─── Frames ─── */
+
+static void test_frame_pool(void)
+{
+    wifi_raw::FramePool<2, 64> pool;
+    CHECK(pool.available() == 2);
+
+    wifi_raw::Frame a = pool.acquire();
+    wifi_raw::Frame b = pool.acquire();
+    wifi_raw::Frame c = pool.acquire();
+    CHECK(a && b && !c);
+    CHECK(a.capacity() == 64 && c.capacity() == 0);
+    CHECK(pool.available() == 0);
+
+    memset(a.buffer().data(), 0xA5, 10);
+    a.resize(10);
+    CHECK(a.size() == 10);
+    const uint8_t *a_buf = a.data().data();
+
+    /* Move construction carries buffer and length; the source is empty */
+    wifi_raw::Frame m(std::move(a));
+    CHECK(!a && a.size() == 0 && a.capacity() == 0);
+    CHECK(m && m.size() == 10 && m.data().data() == a_buf && m.data()[9] == 0xA5);
+    CHECK(pool.available() == 0);
+
+    /* Move assignment returns the target's own buffer first */
+    b = std::move(m);
+    CHECK(!m);
+    CHECK(b.data().data() == a_buf && b.size() == 10);
+    CHECK(pool.available() == 1);
+
+    b.resize(100);
+    CHECK(b.size() == 64);
+
+    wifi_raw::Frame d = pool.acquire();
+    CHECK(d && d.data().data() != a_buf);
+    d = wifi_raw::Frame();
+    CHECK(pool.available() == 1);
+
+    {
+        wifi_raw::Frame scoped = std::move(b);
+    }
+    CHECK(pool.available() == 2);
+}
+
+/* ─── Subscriptions ─── */
+
+struct CountRx {
+    int *calls;
+    int8_t *rssi;
+    void operator()(wifi_raw::Packet p) const
+    {
+        (*calls)++;
+        *rssi = p.rssi();
+    }
+};
+
+static void deliver_rx(int8_t rssi)
+{
+    static const uint8_t payload[4] = { 0x80 };
+    wifi_raw_rx_pkt_t pkt = {};
+    pkt.rssi = rssi;
+    pkt.payload = payload;
+    pkt.payload_len = sizeof(payload);
+    CHECK(s_rx_cb);
+    s_rx_cb(&pkt);
+}
+
+static void test_subscription_move(void)
+{
+    int calls1 = 0, calls2 = 0;
+    int8_t rssi = 0;
+    s_rx_clears = 0;
+
+    auto s1 = wifi_raw::on_rx(CountRx{&calls1, &rssi});
+    CHECK(s1.active());
+    deliver_rx(-40);
+    CHECK(calls1 == 1 && rssi == -40);
+
+    {
+        /* The function moves with the subscription; no unregistered gap */
+        auto s2 = std::move(s1);
+        CHECK(!s1.active() && s2.active());
+        CHECK(s_rx_clears == 0);
+        deliver_rx(-41);
+        CHECK(calls1 == 2 && rssi == -41);
+
+        /* A newer subscription takes the slot; assigning it back into
+         * the replaced one hands the registration over, again without
+         * a gap */
+        auto s3 = wifi_raw::on_rx(CountRx{&calls2, &rssi});
+        CHECK(!s2.active() && s3.active());
+        deliver_rx(-42);
+        CHECK(calls1 == 2 && calls2 == 1);
+        s2 = std::move(s3);
+        CHECK(s2.active() && !s3.active());
+        CHECK(s_rx_clears == 0);
+        deliver_rx(-43);
+        CHECK(calls1 == 2 && calls2 == 2 && rssi == -43);
+    }
+    /* Leaving scope destroyed the registered subscription */
+    CHECK(s_rx_cb == NULL && s_rx_clears == 1);
+
+    /* The moved-from one was inactive: destroying it changed nothing */
+    int clears = s_rx_clears;
+    s1.reset();
+    CHECK(s_rx_clears == clears);
+    CHECK(s_delays == 0);
+}
+
+static void test_subscription_reset(void)
+{
+    int calls_old = 0, calls_new = 0;
+    int64_t rtt = 0;
+
+    auto old_rx = wifi_raw::on_rx([&](wifi_raw::Packet) { calls_old++; });
+    auto echo = wifi_raw::on_echo([&](wifi_raw::Echo e) { rtt = e.rtt_us(); });
+
+    /* A newer subscription replaces the older one... */
+    auto new_rx = wifi_raw::on_rx([&](wifi_raw::Packet) { calls_new++; });
+    CHECK(!old_rx.active() && new_rx.active());
+    deliver_rx(-50);
+    CHECK(calls_old == 0 && calls_new == 1);
+
+    /* ...and resetting the older one leaves the newer registered */
+    old_rx.reset();
+    CHECK(new_rx.active());
+    deliver_rx(-50);
+    CHECK(calls_new == 2);
+
+    new_rx.reset();
+    CHECK(!new_rx.active() && s_rx_cb == NULL);
+    new_rx.reset();     /* Twice is harmless */
+
+    /* RX and echo slots are independent */
+    CHECK(echo.active() && s_echo_cb);
+    wifi_raw_echo_t e = {};
+    e.host_tx_us = 1000;
+    e.host_rx_us = 1250;
+    s_echo_cb(&e);
+    CHECK(rtt == 250);
+
+    echo.reset();
+    CHECK(s_echo_cb == NULL);
+    CHECK(s_delays == 0);
+}
+
+/* ─── Executor ─── */
+
+static char s_log[32];
+static size_t s_log_len;
+
+static void log_event(char c)
+{
+    CHECK(s_log_len < sizeof(s_log) - 1);
+    s_log[s_log_len++] = c;
+}
+
+static void log_reset(void)
+{
+    memset(s_log, 0, sizeof(s_log));
+    s_log_len = 0;
+}
+
+using wifi_raw::co::Executor;
+using wifi_raw::co::Task;
+
+static Task sleeper(char tag, uint32_t ms)
+{
+    int64_t start = esp_timer_get_time();
+    co_await wifi_raw::co::sleep_ms(ms);
+    CHECK(esp_timer_get_time() - start >= (int64_t)ms * 1000);
+    log_event(tag);
+}
+
+static Task commander(char tag, uint8_t channel, esp_err_t expect)
+{
+    esp_err_t ret = co_await wifi_raw::co::set_channel(channel);
+    CHECK(ret == expect);
+    CHECK(s_current == s_exec_task);    /* Resumed on the executor, not the RX task */
+    log_event(tag);
+}
+
+static void test_executor_order(void)
+{
+    Executor exec(4);
+    CHECK(exec);
+    log_reset();
+    s_now_us = 0;
+
+    exec.spawn(sleeper('a', 30));
+    exec.spawn(sleeper('b', 10));
+    exec.spawn(commander('c', 6, ESP_OK));
+    exec.spawn(sleeper('d', 0));                            /* Never suspends */
+    exec.spawn(commander('e', 0, ESP_ERR_INVALID_ARG));     /* Fails to send */
+    exec.spawn(commander('f', 14, ESP_ERR_TIMEOUT));
+    exec.spawn(sleeper('g', 10));                           /* Same deadline as b */
+    exec.run();
+
+    /* Spawn order to the first suspension, replies in order, then the
+     * sleepers by deadline with ties in arrival order */
+    CHECK(strcmp(s_log, "decfbga") == 0);
+    CHECK(s_now_us == 30000);
+    CHECK(s_pending_count == 0);
+}
+
+static Task child(char tag)
+{
+    log_event(tag);
+    co_return;
+}
+
+static Task parent(Executor &exec)
+{
+    log_event('p');
+    exec.spawn(child('x'));
+    exec.spawn(child('y'));
+    esp_err_t ret = co_await wifi_raw::co::set_channel(1);
+    CHECK(ret == ESP_OK);
+    log_event('P');
+}
+
+static void test_executor_spawn_inside(void)
+{
+    Executor exec(4);
+    log_reset();
+
+    exec.spawn(parent(exec));
+    exec.run();
+    CHECK(strcmp(s_log, "pxyP") == 0);
+}
+
+struct Tracked {
+    static inline int live = 0;
+    Tracked() { live++; }
+    Tracked(const Tracked &) { live++; }
+    ~Tracked() { live--; }
+};
+
+static Task holder(Tracked t)
+{
+    (void)t;
+    log_event('h');
+    co_return;
+}
+
+static void test_task_not_spawned(void)
+{
+    log_reset();
+    {
+        Task t = holder(Tracked());
+        CHECK(Tracked::live == 1);      /* The argument copy in the frame */
+    }
+    CHECK(Tracked::live == 0);          /* Frame freed without running */
+    CHECK(s_log_len == 0);
+}
+
+int main(void)
+{
+    test_frame_pool();
+    test_subscription_move();
+    test_subscription_reset();
+    test_executor_order();
+    test_executor_spawn_inside();
+    test_task_not_spawned();
+    printf("wifi_raw_cpp_test: all checks passed\n");
+    return 0;
+}
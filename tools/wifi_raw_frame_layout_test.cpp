@@ -0,0 +1,116 @@
+/*
+ * wifi_raw_frame_test - layout cases
+ *
+ * The wifi_raw_layout.hpp layouts for the reference frames: sizes and
+ * element offsets checked at compile time, built byte-exact against the
+ * references, then parsed back with the C parser. Run from the main() in
+ * wifi_raw_frame_test.c; see there for the build.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include "wifi_raw_layout.hpp"
+#include "wifi_raw_frame_test.h"
+
+using wifi_raw::layout::ActionVendor;
+using wifi_raw::layout::Beacon;
+using wifi_raw::layout::DsParams;
+using wifi_raw::layout::ProbeReq;
+using wifi_raw::layout::Ssid;
+using wifi_raw::layout::SuppRates;
+using wifi_raw::layout::VendorIe;
+
+using RefBeacon = Beacon<Ssid<4>, SuppRates<sizeof(s_rates)>, DsParams,
+                         VendorIe<0x021122, sizeof(s_vendor_body)>>;
+using RefProbeReq = ProbeReq<Ssid<0>, SuppRates<sizeof(s_rates)>>;
+
+struct __attribute__((packed)) Ping {
+    char tag[4];
+    uint8_t seq;
+};
+using RefAction = ActionVendor<Ping>;
+
+static_assert(RefBeacon::size() == sizeof(s_ref_beacon));
+static_assert(sizeof(RefBeacon) == RefBeacon::size());
+static_assert(offsetof(RefBeacon, ies) == RefBeacon::ie_offset<0>());
+static_assert(RefBeacon::ie_offset<0>() == 36);
+static_assert(RefBeacon::ie_offset<1>() == 36 + 6);
+static_assert(RefBeacon::ie_offset<2>() == 36 + 6 + 6);
+static_assert(RefBeacon::ie_offset<3>() == 36 + 6 + 6 + 3);
+static_assert(RefProbeReq::size() == sizeof(s_ref_probe_req));
+static_assert(RefProbeReq::ie_offset<1>() == 24 + 2);
+static_assert(RefAction::size() == sizeof(s_ref_action));
+
+static void test_layout_beacon(void)
+{
+    uint8_t buf[RefBeacon::size()];
+    memset(buf, 0xA5, sizeof(buf));
+
+    RefBeacon *b = RefBeacon::build(buf, s_ap, 100, 0x0421);
+    CHECK(b != nullptr);
+    memcpy(b->ie<0>().body, "test", 4);
+    memcpy(b->ie<1>().body, s_rates, sizeof(s_rates));
+    b->ie<2>().body[0] = 6;
+    memcpy(b->ie<3>().body, s_vendor_body, sizeof(s_vendor_body));
+    CHECK(memcmp(buf, s_ref_beacon, sizeof(s_ref_beacon)) == 0);
+
+    /* Round trip through the C parser */
+    wifi_raw_frame_info_t info;
+    CHECK(wifi_raw_frame_parse(buf, sizeof(buf), &info));
+    CHECK(info.subtype == WIFI_RAW_FC_SUBTYPE(WIFI_RAW_FC_BEACON));
+    CHECK(info.ies == buf + RefBeacon::ie_offset<0>());
+    CHECK(info.ies_len == RefBeacon::size() - RefBeacon::ie_offset<0>());
+    size_t len;
+    const uint8_t *ds = wifi_raw_ie_find(info.ies, info.ies_len, WIFI_RAW_IE_DS_PARAMS, &len);
+    CHECK(ds == buf + RefBeacon::ie_offset<2>() + 2 && len == 1 && *ds == 6);
+    const uint8_t *v = wifi_raw_vendor_ie_find(info.ies, info.ies_len, s_oui, &len);
+    CHECK(v && len == sizeof(s_vendor_body));
+    CHECK(memcmp(v, s_vendor_body, len) == 0);
+
+    /* A larger buffer is fine; a short one is refused before any write */
+    uint8_t big[RefBeacon::size() + 16];
+    CHECK(RefBeacon::build(big, s_ap, 100, 0x0421) == reinterpret_cast<RefBeacon *>(big));
+    memset(buf, 0xA5, sizeof(buf));
+    CHECK(RefBeacon::build(std::span<uint8_t>(buf, sizeof(buf) - 1), s_ap, 100, 0x0421) == nullptr);
+    CHECK(buf[0] == 0xA5);
+}
+
+static void test_layout_probe_req(void)
+{
+    uint8_t buf[RefProbeReq::size()];
+
+    RefProbeReq *p = RefProbeReq::build(buf, s_sta);
+    CHECK(p != nullptr);
+    memcpy(p->ie<1>().body, s_rates, sizeof(s_rates));
+    CHECK(memcmp(buf, s_ref_probe_req, sizeof(s_ref_probe_req)) == 0);
+
+    wifi_raw_frame_info_t info;
+    CHECK(wifi_raw_frame_parse(buf, sizeof(buf), &info));
+    size_t len = 1;
+    CHECK(wifi_raw_ie_find(info.ies, info.ies_len, WIFI_RAW_IE_SSID, &len) && len == 0);
+    CHECK(wifi_raw_ie_find(info.ies, info.ies_len, WIFI_RAW_IE_SUPP_RATES, &len) ==
+          buf + RefProbeReq::ie_offset<1>() + 2);
+}
+
+static void test_layout_action(void)
+{
+    uint8_t buf[RefAction::size()];
+
+    RefAction *a = RefAction::build(buf, s_sta, s_ap, s_oui);
+    CHECK(a != nullptr);
+    memcpy(a->body.tag, "ping", 4);
+    a->body.seq = 0x2A;
+    CHECK(memcmp(buf, s_ref_action, sizeof(s_ref_action)) == 0);
+
+    wifi_raw_frame_info_t info;
+    CHECK(wifi_raw_frame_parse(buf, sizeof(buf), &info));
+    CHECK(info.body == buf + offsetof(RefAction, action));
+    CHECK(info.body_len == sizeof(wifi_raw_action_vendor_t) + sizeof(Ping));
+}
+
+extern "C" void test_layouts(void)
+{
+    test_layout_beacon();
+    test_layout_probe_req();
+    test_layout_action();
+}
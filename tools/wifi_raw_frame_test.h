@@ -0,0 +1,77 @@
+/*
+ * wifi_raw_frame_test - checks and reference frames shared by the C cases
+ * (wifi_raw_frame_test.c) and the C++ layout cases
+ * (wifi_raw_frame_layout_test.cpp)
+ */
+
+#ifndef WIFI_RAW_FRAME_TEST_H
+#define WIFI_RAW_FRAME_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHECK(cond) do {                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n",                \
+                    __FILE__, __LINE__, __func__, #cond);                   \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+static const uint8_t s_ap[6] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55 };
+static const uint8_t s_sta[6] = { 0x02, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE };
+static const uint8_t s_oui[3] = { 0x02, 0x11, 0x22 };
+static const uint8_t s_rates[4] = { 0x82, 0x84, 0x8B, 0x96 };    /* 1, 2, 5.5, 11 Mbps basic */
+static const uint8_t s_vendor_body[8] = { 'w', 'r', 'a', 'w', 0x01, 0x00, 0x10, 0x27 };
+
+/* Beacon: SSID "test", rates, DS channel 6, vendor element */
+static const uint8_t s_ref_beacon[] = {
+    0x80, 0x00, 0x00, 0x00,                             /* FC, duration */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,                 /* DA broadcast */
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55,                 /* SA */
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55,                 /* BSSID */
+    0x00, 0x00,                                         /* Seq */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     /* Timestamp */
+    0x64, 0x00,                                         /* Interval 100 TU */
+    0x21, 0x04,                                         /* ESS, short preamble, short slot */
+    0x00, 0x04, 't', 'e', 's', 't',
+    0x01, 0x04, 0x82, 0x84, 0x8B, 0x96,
+    0x03, 0x01, 0x06,
+    0xDD, 0x0B, 0x02, 0x11, 0x22, 'w', 'r', 'a', 'w', 0x01, 0x00, 0x10, 0x27,
+};
+
+/* Probe request: wildcard SSID, rates */
+static const uint8_t s_ref_probe_req[] = {
+    0x40, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x02, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,                 /* BSSID wildcard */
+    0x00, 0x00,
+    0x00, 0x00,
+    0x01, 0x04, 0x82, 0x84, 0x8B, 0x96,
+};
+
+/* Vendor-specific action to one station */
+static const uint8_t s_ref_action[] = {
+    0xD0, 0x00, 0x00, 0x00,
+    0x02, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE,                 /* DA */
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55,                 /* SA */
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55,                 /* BSSID = SA */
+    0x00, 0x00,
+    0x7F, 0x02, 0x11, 0x22,                             /* Vendor category, OUI */
+    'p', 'i', 'n', 'g', 0x2A,
+};
+
+/* wifi_raw_layout.hpp cases, in wifi_raw_frame_layout_test.cpp */
+void test_layouts(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIFI_RAW_FRAME_TEST_H */